@@ -1,57 +1,95 @@
 #ifndef _ANIMATION_HPP_
 #define _ANIMATION_HPP_
 
+#include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <omp.h>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#define MAX_JOINTS 64 // size of the JointPalette uniform block
+#define JOINT_PALETTE_BINDING 0
 
-struct JointPose
+// keys of one joint inside an animation
+struct Track
 {
-	std::string name;
-	glm::mat4 poseMatrix;
-	
-	JointPose(std::string p_name, glm::mat4 pMatrix)
-	{
-		name = p_name;
-		poseMatrix = pMatrix;
-	}
+	int joint; // joint index (joint id - 1)
+	int first_key; // offset into the animation key arrays
+	int nb_keys;
 };
 
-class Keyframe
+class Animation
 {
 	public:
 
-		Keyframe(int p_frame);
-		~Keyframe();
-		int get_frame();
-		void add_joint_pose(JointPose* jPose);
-		JointPose* get_joint_pose_by_name(const char* joint_name);
-		std::vector<JointPose*>& get_joint_pose_list();
+		Animation(std::string p_name, double p_duration, double p_ticks_per_second = 25.0);
+		std::string get_name() const;
+		double get_duration() const;
+		double get_ticks_per_second() const;
+		int get_nb_tracks() const;
+		void add_track(int joint, const std::vector<float> & key_times, const std::vector<glm::vec3> & key_translations, const std::vector<glm::quat> & key_rotations, const std::vector<glm::vec3> & key_scales);
+		void sample(double time, std::vector<int> & cursors, std::vector<glm::mat4> & local_poses) const;
 
 	private:
 
-		int frame;
-		std::vector<JointPose*> joint_pose_list;
+		int find_key(const Track & track, float time, int & cursor) const;
+
+		std::string name;
+		double duration; // in ticks
+		double ticks_per_second;
+		std::vector<Track> tracks;
+
+		// keys of every track stored back to back
+		std::vector<float> times;
+		std::vector<glm::vec3> translations;
+		std::vector<glm::quat> rotations;
+		std::vector<glm::vec3> scales;
 };
 
-class Animation
+struct PoseJob;
+
+// flattened skeleton of an object and the joint palette sent to the vertex shader
+class Pose
 {
 	public:
 
-		Animation(std::string p_name, double p_duration);
-		std::string get_name() const;
-		void add_keyframe(Keyframe* key);
-		std::vector<Keyframe*>& get_keyframes();
+		Pose();
+		~Pose();
+		void set_skeleton(const std::vector<int> & p_parents, const std::vector<glm::mat4> & p_offsets);
+		void evaluate(const Animation* anim, double time);
+		static void evaluate_batch(std::vector<PoseJob> & jobs);
+		void upload();
+		int get_nb_joints() const;
+		std::vector<glm::mat4> const& get_palette() const;
 
 	private:
 
-		std::string name;
-		double duration;
-		std::vector<Keyframe*> keys;
+		std::vector<int> parents; // parent index of each joint, -1 for the root, parents come first
+		std::vector<glm::mat4> offsets; // from mesh to bone space
+		std::vector<glm::mat4> bind_locals; // rest pose of each joint relative to its parent
+		std::vector<glm::mat4> locals;
+		std::vector<glm::mat4> globals;
+		std::vector<glm::mat4> palette;
+		std::vector<int> cursors; // last key used by each track
+		const Animation* current;
+		GLuint UBO;
+};
+
+// one animated object to bring up to date this frame
+struct PoseJob
+{
+	Pose* pose;
+	const Animation* anim;
+	double time;
 };
 
 #endif
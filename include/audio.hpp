@@ -4,6 +4,14 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <glm/glm.hpp>
 #include <al.h>
 #include <alc.h>
 #include <sndfile.h>
@@ -16,6 +24,7 @@ class Audio
 		void load_sound(std::string file_path);
 		~Audio();
 		std::vector<ALuint> sounds;
+		std::vector<float> durations; // seconds
 
 	private:
 
@@ -30,9 +39,13 @@ class Source
 		Source();
 		~Source();
 		void set_volume(int volume);
+		void set_gain(float gain);
+		void set_pitch(float pitch);
 		void set_looping(bool loop);
+		void set_spatial(bool spatial);
+		void set_position(glm::vec3 position, glm::vec3 velocity);
 		void stop_sound();
-		void play_sound(ALuint sound_buffer);
+		void play_sound(ALuint sound_buffer, float offset = 0.0f);
 		bool is_playing() const;
 		float get_elapsed_time() const;
 
@@ -41,4 +54,209 @@ class Source
 		ALuint source_id;
 };
 
+#define STREAM_NB_BUFFERS 4
+#define STREAM_BUFFER_FRAMES 8192 // frames decoded into each queued buffer
+
+// source decoding its file on a background thread into a small queue of buffers,
+// for music and long loops (any format libsndfile reads : wav, ogg, flac)
+class StreamingSource
+{
+	public:
+
+		StreamingSource(std::string file_path);
+		~StreamingSource();
+		void set_volume(int volume);
+		void set_gain(float gain);
+		void set_pitch(float pitch);
+		void set_looping(bool loop);
+		void set_spatial(bool spatial);
+		void set_position(glm::vec3 position, glm::vec3 velocity);
+		void stop_sound();
+		void play_sound();
+		bool is_playing() const;
+		float get_elapsed_time() const;
+
+	private:
+
+		void stream();
+		void restart();
+		bool fill_buffer(ALuint buffer);
+
+		SNDFILE* file;
+		SF_INFO file_infos;
+		ALenum format;
+		std::vector<ALshort> samples; // decoding scratch, one buffer worth
+		ALuint source_id;
+		ALuint buffers[STREAM_NB_BUFFERS];
+		sf_count_t queued_frames; // frames of the buffers already played and unqueued
+
+		std::thread worker;
+		mutable std::mutex lock;
+		std::atomic<bool> running;
+		std::atomic<bool> playing;
+		std::atomic<bool> looping;
+		std::atomic<bool> start_request;
+};
+
+#define AUDIO_QUEUE_SIZE 256 // power of two
+#define AUDIO_TICK 5 // milliseconds between two mixer updates
+
+// single producer / single consumer ring buffer, no locks
+template<typename T, unsigned int N>
+class CommandQueue
+{
+	public:
+
+		CommandQueue() : head(0), tail(0) {}
+
+		bool push(const T & item)
+		{
+			unsigned int h = head.load(std::memory_order_relaxed);
+			if(h - tail.load(std::memory_order_acquire) == N)
+				return false;
+			items[h & (N - 1)] = item;
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(T & item)
+		{
+			unsigned int t = tail.load(std::memory_order_relaxed);
+			if(t == head.load(std::memory_order_acquire))
+				return false;
+			item = items[t & (N - 1)];
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+
+		static_assert((N & (N - 1)) == 0, "queue size must be a power of two");
+		T items[N];
+		std::atomic<unsigned int> head; // written by the producer only
+		std::atomic<unsigned int> tail; // written by the consumer only
+};
+
+#define AUDIO_BENCHMARK 0
+#define AUDIO_BENCH_EMITTERS 24
+#define AUDIO_MAX_SOURCES 32 // hardware voices we allow ourselves, streams included
+#define AUDIO_MIN_AUDIBILITY 0.001f // quieter voices stay virtual
+#define AUDIO_REFERENCE_DISTANCE 15.0f
+#define AUDIO_MAX_DISTANCE 1500.0f
+#define AUDIO_ROLLOFF 1.0f
+#define AUDIO_SPEED_OF_SOUND 343.3f // world units per second
+
+enum AUDIO_COMMAND_TYPE
+{
+	AUDIO_PLAY,
+	AUDIO_STOP,
+	AUDIO_VOLUME,
+	AUDIO_CROSSFADE,
+	AUDIO_GAIN_RAMP,
+	AUDIO_PITCH_RAMP,
+	AUDIO_MOVE,
+	AUDIO_LISTENER
+};
+
+struct AudioCommand
+{
+	AUDIO_COMMAND_TYPE type;
+	int voice;
+	int target; // sound to play, or voice faded in by a crossfade
+	float value;
+	float duration; // seconds
+	glm::vec3 position;
+	glm::vec3 velocity;
+	glm::vec3 forward; // listener only
+	glm::vec3 up; // listener only
+};
+
+// a logical sound owned by the mixer thread, mirrored for the render thread.
+// buffered voices only hold a hardware source while they are among the most audible ones,
+// streams always keep theirs
+struct Voice
+{
+	Source* source; // nullptr while virtual
+	StreamingSource* stream;
+	std::string stream_path;
+	int sound; // last sound played by a buffered source
+	int volume;
+	bool looping;
+	bool spatial; // emitter in the world, otherwise relative to the listener
+	float priority;
+	glm::vec3 position;
+	glm::vec3 velocity;
+
+	// mixer side playback state
+	bool started;
+	float virtual_time; // playback position kept while virtual
+	float audibility;
+	bool audible; // in the set given a hardware source this tick
+
+	// fades and ramps, applied on top of the volume
+	float gain;
+	float gain_target;
+	float gain_rate;
+	bool stop_after_fade;
+	float pitch;
+	float pitch_target;
+	float pitch_rate;
+
+	std::atomic<int> status; // play/stop commands not executed yet * 2 + playing bit
+	std::atomic<float> elapsed_time;
+};
+
+// owns the audio device and every source, the render thread only pushes commands
+class AudioSystem
+{
+	public:
+
+		AudioSystem();
+		~AudioSystem();
+		int add_sound(const std::string & file_path);
+		int add_voice(int volume, bool looping = false, const std::string & stream_path = "");
+		int add_emitter(int volume, bool looping = false, float priority = 1.0f, const std::string & stream_path = "");
+		void start();
+
+		void play(int voice, int sound = -1);
+		void stop(int voice);
+		void set_volume(int voice, int volume);
+		void crossfade(int from, int to, float duration);
+		void ramp_gain(int voice, float gain, float duration);
+		void ramp_pitch(int voice, float pitch, float duration);
+		void move(int voice, glm::vec3 position, glm::vec3 velocity);
+		void set_listener(glm::vec3 position, glm::vec3 velocity, glm::vec3 forward, glm::vec3 up);
+		bool is_playing(int voice) const;
+		float get_elapsed_time(int voice) const;
+		int get_nb_real_voices() const;
+
+	private:
+
+		void push(const AudioCommand & cmd);
+		void run();
+		void execute(const AudioCommand & cmd);
+		void start_voice(Voice* v);
+		void stop_voice(Voice* v);
+		void update_voices(float delta);
+		void select_real_voices();
+		float attenuation(const Voice* v) const;
+
+		std::vector<std::string> sound_files;
+		std::vector<Voice*> voices;
+		std::vector<Source*> free_sources;
+		int nb_streams;
+		std::vector<Voice*> candidates; // scratch for the audible set selection
+		glm::vec3 listener_position;
+		Audio* device;
+		CommandQueue<AudioCommand, AUDIO_QUEUE_SIZE> commands;
+		std::thread mixer;
+		std::atomic<bool> running;
+		std::atomic<int> nb_real_voices;
+
+		// mixer cost vs active emitters (AUDIO_BENCHMARK)
+		double bench_time[AUDIO_MAX_SOURCES * 4 + 1];
+		int bench_ticks[AUDIO_MAX_SOURCES * 4 + 1];
+		int bench_total;
+};
+
 #endif
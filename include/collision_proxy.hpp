@@ -0,0 +1,57 @@
+#ifndef _COLLISION_PROXY_HPP_
+#define _COLLISION_PROXY_HPP_
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include "mesh.hpp"
+#include "simplifier.hpp"
+
+#define PROXY_CACHE_MAGIC 0x58525050 // "PPRX"
+#define PROXY_MAX_ERROR 0.25f // world units
+#define PROXY_HULL_CELL_SIZE 20.0f // world units
+#define PROXY_MAX_PASSES 16
+
+enum PROXY_TYPE
+{
+	PROXY_TRIANGLES,
+	PROXY_HULLS
+};
+
+struct ProxyHull
+{
+	std::vector<glm::vec3> points;
+};
+
+// decimated collision geometry for one render mesh
+struct CollisionProxy
+{
+	PROXY_TYPE type;
+	std::vector<glm::vec3> positions;
+	std::vector<int> indices;
+	std::vector<ProxyHull> hulls;
+};
+
+class CollisionProxyBuilder
+{
+	public:
+
+		CollisionProxyBuilder(float p_max_error = PROXY_MAX_ERROR, float p_hull_cell_size = PROXY_HULL_CELL_SIZE);
+		void simplify(const std::vector<Vertex> & vertices, const std::vector<int> & indices, CollisionProxy & proxy);
+		void decompose(const std::vector<Vertex> & vertices, const std::vector<int> & indices, CollisionProxy & proxy);
+		bool load(const std::string & path, unsigned int checksum, PROXY_TYPE type, CollisionProxy & proxy);
+		void save(const std::string & path, unsigned int checksum, const CollisionProxy & proxy);
+
+	private:
+
+		void weld(const std::vector<Vertex> & vertices, const std::vector<int> & indices, std::vector<glm::vec3> & positions, std::vector<int> & welded);
+
+		float max_error;
+		float hull_cell_size;
+};
+
+#endif
@@ -5,6 +5,9 @@
 #include <GL/glew.h>
 #include <iostream>
 #include <string>
+#include <map>
+#include <fstream>
+#include <filesystem>
 #include <omp.h>
 #include <math.h>
 #include <cstdlib>
@@ -21,18 +24,27 @@
 #include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
 #include <BulletSoftBody/btSoftBodyHelpers.h>
 #include <BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include "shader.hpp"
 #include "color.hpp"
 #include "object.hpp"
+#include "instancing.hpp"
 #include "skybox.hpp"
 #include "smoke.hpp"
 #include "power.hpp"
 #include "audio.hpp"
+#include "collision_proxy.hpp"
+#include "heightfield.hpp"
+#include "hud.hpp"
+#include "shader_reload.hpp"
 
 #define WIDTH 1560
 #define HEIGHT 780
 #define MATRIX_SCALAR_COUNT 16
 #define MINIMAP_DIMENSIONS 512
+#define COLLISION_CACHE_DIR "../assets/cache/"
+#define BVH_CACHE_MAGIC 0x48564250 // "PBVH"
 
 class Camera;
 class Podracer;
@@ -50,7 +62,8 @@ enum PAGE
 	POD_SPECS,
 	TUNING,
     END_GAME_STATS,
-	RACE
+	RACE,
+	EXIT // leaves the page loop
 };
 
 struct UserActions
@@ -97,38 +110,65 @@ struct BoundingBox
 
 struct HUD_chrono
 {
-	GLuint min_d0;
-	GLuint min_d1;
-	GLuint dots2;
-	GLuint sec_d0;
-	GLuint sec_d1;
-	GLuint dot;
-	GLuint ms_d0;
-	GLuint ms_d1;
+	HudQuad min_d0;
+	HudQuad min_d1;
+	HudQuad dots2;
+	HudQuad sec_d0;
+	HudQuad sec_d1;
+	HudQuad dot;
+	HudQuad ms_d0;
+	HudQuad ms_d1;
 };
 
 struct HUD_pos
 {
-	GLuint pos;
-	GLuint slash;
-	GLuint max;
+	HudQuad pos;
+	HudQuad slash;
+	HudQuad max;
+};
+
+// race sound transitions, reset when leaving the race
+struct SoundState
+{
+	bool fire_power_coupling_done = false;
+	bool power_coupling_running = false;
+	bool start_electric_engine_done = false;
+	bool electric_engine_running = false;
+	bool turbojet_fired = false;
+	bool turbojet_running = false;
+	bool last_action_break_engine = false;
+	bool last_action_afterburn = false;
+	int bip = 0;
+	bool go_sound = false;
+	bool new_lap_record = false;
+	bool pod_crash_done = false;
+	bool menu_music_fading = false;
+	int engine_volume = 30;
+	float engine_load = -1.0f; // last pod speed ratio sent to the engine voice
 };
 
 struct HUD_lap
 {
-	GLuint current;
-	GLuint slash;
-	GLuint max;
+	HudQuad current;
+	HudQuad slash;
+	HudQuad max;
 };
 
 struct HUD_speed
 {
-	GLuint speed_bar;
-	GLuint speed_bar_VBO;
-	GLuint layout;
-	GLuint d0;
-	GLuint d1;
-	GLuint d2;
+	HudQuad speed_bar;
+	HudQuad layout;
+	HudQuad d0;
+	HudQuad d1;
+	HudQuad d2;
+};
+
+// menu/UI quad, created the first time a page asks for it
+struct UiQuad
+{
+	GLuint VAO;
+	GLuint VBO;
+	GLuint EBO;
 };
 
 class Game
@@ -137,16 +177,26 @@ class Game
 
 		Game(const std::string& title);
 		~Game();
-		void start(); // shows main menu
+		void start(); // runs the pages until the player quits
         static void loading_screen();
 		void quit();
+		void print_memory_report();
+		void set_occlusion(OCCLUSION_MODE mode, bool print_stats = false);
+		void enable_shader_reload();
 
 	private:
 
 		SDL_Window* createWindow(int w, int h, const std::string& title);
 		void set_menu_textures();
+		const UiQuad & get_ui_quad(const std::string & name, const float * vertices, int size);
+		HudQuad hud_quad(const float * vertices) const;
 		void set_framebuffers();
+		void end_frame(); // swap, then pick up edited shaders
+		void update_poses(); // evaluates every animated object of the frame in one batch
         void update_framebuffers();
+		static void release_geometry(const std::vector<Object*> & objects);
+		static void memory_usage(const std::vector<Object*> & objects, size_t & cpu, size_t & gpu);
+		void main_menu(); // shows main menu
 		void tuning();
 		void gameInfo(); // go to the rules/game presentation page
 		void map();
@@ -156,7 +206,7 @@ class Game
 		
 		void play(); // starts the actual racing game
 		void prepare_print_quit_game(GLuint VAO, GLuint VAO1, Shader* grey_shader);
-		void quit_game(HUD_speed& hud_speed, GLuint topBarVAO, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono);
+		void quit_game(HUD_speed& hud_speed, HudQuad& top_bar, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono);
 		void set_view_matrix(bool & first_loop);
 		void render_env_texture();
 		void render_smoke_texture();
@@ -166,12 +216,13 @@ class Game
 		void render_podracer();
 		void render_gaussian_blur_bright_colors(GLuint VAO, Shader& gaussianBlurShader);
 		void render_color(GLuint VAO, Shader& color_shader);
-		void render_HUD(Shader& final_shader, GLuint VAO, HUD_speed& hud_speed, GLuint topBarVAO, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono, bool disable_HUD = false);
+		void render_HUD(Shader& final_shader, GLuint VAO, HUD_speed& hud_speed, HudQuad& top_bar, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono, bool disable_HUD = false);
 		void view_render_pass(GLuint VAO, Shader& color_shader);
 		void process_countdown(GLuint countdownVAO, float delta, Shader& countdown_shader);
 		
 		void draw_speed_HUD(HUD_speed& hud_speed);
-		void draw_topBar_HUD(GLuint topBarVAO, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono);
+		void draw_topBar_HUD(HudQuad& top_bar, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono);
+		void add_chrono_quads(HUD_chrono& quads, int min_d0, int min_d1, int sec_d0, int sec_d1, int ms_d0, int ms_d1);
 		void draw_map_HUD(bool quit_game = false);
         void draw_lap_time(HUD_chrono& lap_time);
 		
@@ -247,6 +298,7 @@ class Game
 		int countdown_timer;
 
 		// game top bar HUD
+		HudQuad hud_top_bar;
 		HUD_chrono chrono;
 		HUD_lap hud_lap;
 		HUD_pos hud_pos;
@@ -311,11 +363,21 @@ class Game
 
 		// navigation
 		PAGE current_page;
+		PAGE next_page; // set by a page before it returns to start()
+		std::map<std::string, UiQuad> ui_quads;
 		std::vector<float> tuning_button;
 		GLuint tuningVAO, tuningVBO, tuningEBO;
 		std::vector<float> back_button;
 		GLuint backVAO, backVBO, backEBO;
 		Shader* ui_shader;
+		Shader* grey_shader;
+		Shader* motionBlur_shader;
+		Shader* gaussian_blur_shader;
+		Shader* color_shader;
+		Shader* final_shader;
+		Shader* countdown_shader;
+		HudBatcher* hud; // race HUD atlas, drawn in two batches
+		ShaderReloader* shader_reloader; // only with --hot-reload
 
 		// render loop attributes
 		double lastFrame;
@@ -325,22 +387,25 @@ class Game
 		double animRate;
 		double fps;
 
-		//sounds
-		Audio* sounds;
-		Source* main_menu_source;
-		Source* pod_fire_power_coupling;
-		Source* pod_power_coupling;
-		Source* pod_start_electric_engine;
-		Source* pod_electric_engine;
-		Source* pod_fire_engine;
-		Source* pod_base_engine;
-		Source* pod_break;
-		Source* pod_afterburn;
-		Source* fodesinbeed;
-		Source* tatooine_wind;
-		Source* countdown_sounds;
-		Source* pod_crash;
-		Source* pod_collide;
+		//sounds, voices of the audio thread
+		AudioSystem* audio;
+		SoundState sound_state;
+		glm::vec3 last_listener_position;
+		std::vector<int> bench_emitters; // fake AI pod engines (AUDIO_BENCHMARK)
+		int main_menu_source;
+		int pod_fire_power_coupling;
+		int pod_power_coupling;
+		int pod_start_electric_engine;
+		int pod_electric_engine;
+		int pod_fire_engine;
+		int pod_base_engine;
+		int pod_break;
+		int pod_afterburn;
+		int fodesinbeed;
+		int tatooine_wind;
+		int countdown_sounds;
+		int pod_crash;
+		int pod_collide;
 
 		// shadows framebuffer
 		GLuint shadowMapFBO;
@@ -356,6 +421,8 @@ class Game
 		// depth framebuffer
 		GLuint depthFBO;
 		GLuint depthTexture;
+		glm::mat4 depth_view_proj; // camera depthTexture was rendered with, the occlusion culler reads it next frame
+		bool depth_history; // false until depthTexture holds a frame of the current race
 		
 		// depth bis framebuffer
 		GLuint depthBisFBO;
@@ -505,9 +572,11 @@ class Podracer
 
 		Podracer(std::string p_name, Game* p_g);
 		~Podracer();
+		void update_effects(double delta);
 		void draw(bool shadowPass = false, bool depthPass = false, bool smokePass = false);
 		inline void draw_aux(bool depthPass = false, bool smokePass = false);
 		void reset();
+		std::vector<Object*> get_parts() const;
 
 		/***** ATTRIBUTES *****/
 
@@ -554,11 +623,13 @@ class Podracer
         Object* air_scoops_right_hinge1;
         Object* air_scoops_right_hinge2;
         Object* air_scoops_right_hinge3;
+        InstanceBatch* air_scoops; // the twelve parts above, left1..3, left hinges, right1..3, right hinges
         Shader* pod_shader;
 
 		Smoke* smoke_left;
 		Smoke* smoke_right;
         Shader* smoke_shader;
+        Shader* smoke_compute_shader;
 
 		Power* power;
         Shader* power_shader;
@@ -582,7 +653,8 @@ class Environment
 		glm::mat4 get_sun_spaceMatrix(bool pod) const;
 		void draw(bool shadowPass, bool depthPass = false);
 		void reset();
-        std::vector<Mesh*> get_mesh_collection(bool mos_espa = false, int index = 0);
+        std::vector<Mesh*> const & get_mesh_collection(bool mos_espa = false, int index = 0) const;
+        std::vector<Object*> const & get_objects() const;
         void reset_drawable();
         glm::mat4 get_model_env();
 
@@ -622,6 +694,7 @@ class Minimap
 		~Minimap();
         void update_framebuffer(int w, int h);
 		void draw(bool quit_game = false);
+		std::vector<Object*> get_objects() const;
 
 	private:
 
@@ -662,12 +735,75 @@ class Minimap
 // ####################################################################################################
 // ####################################################################################################
 
+// broadphase group bits, also stored as collision object user index to classify contacts
 enum COLLISION_GROUP
 {
-    NONE,
-    POD,
-    ENV,
-    LAP_COUNT
+    NONE = 0,
+    POD = 1,
+    ENV = 2,
+    LAP_COUNT = 4,
+    TERRAIN = 8
+};
+
+struct BvhCacheHeader
+{
+    unsigned int magic;
+    unsigned int checksum;
+    unsigned int size;
+};
+
+#define VEHICLE_NB_WHEELS 4
+
+struct RigidBodySnapshot
+{
+    btTransform transform;
+    btVector3 linear_velocity;
+    btVector3 angular_velocity;
+};
+
+struct WheelSnapshot
+{
+    btWheelInfo::RaycastInfo raycast_info;
+    btTransform world_transform;
+    btScalar steering;
+    btScalar rotation;
+    btScalar delta_rotation;
+    btScalar engine_force;
+    btScalar brake;
+    btScalar suspension_relative_velocity;
+    btScalar suspension_force;
+    btScalar skid_info;
+};
+
+struct SoftBodySnapshot
+{
+    btAlignedObjectArray<btVector3> positions;
+    btAlignedObjectArray<btVector3> previous_positions;
+    btAlignedObjectArray<btVector3> velocities;
+    std::vector<Vertex> render_vertices;
+};
+
+// whole simulation state, buffers are sized by the first save then reused
+struct PhysicsSnapshot
+{
+    RigidBodySnapshot reactors;
+    RigidBodySnapshot chariot;
+    WheelSnapshot wheels[VEHICLE_NB_WHEELS];
+    btVector3 connection_linear_impulse;
+    btScalar connection_angular_impulse[3];
+    SoftBodySnapshot cable_left;
+    SoftBodySnapshot cable_right;
+
+    float engineForce;
+    float breakingForce;
+    float vehicleSteering;
+    float steeringClamp;
+
+    float turn_angle;
+    float rotor_angle;
+    float dir_left_angle;
+    float dir_right_angle;
+    float air_scoops_angle;
 };
 
 int cmp_vertex(const void * a, const void * b);
@@ -680,8 +816,12 @@ class WorldPhysics
         ~WorldPhysics();
         void update_dynamics();
         void reset();
+        void save_state(PhysicsSnapshot & snapshot);
+        void restore_state(const PhysicsSnapshot & snapshot);
         btRaycastVehicle* get_vehicle();
         glm::vec3 get_pod_direction();
+        float get_ground_height(float x, float z);
+        size_t get_cpu_bytes() const;
         
         //***** podracer model matrices *****
         glm::mat4 chariot_model;
@@ -715,6 +855,24 @@ class WorldPhysics
         btSoftRigidDynamicsWorld* dynamicsWorld;
         btSoftBodyWorldInfo * softBody_worldInfo;
 
+        // static env collision data (mesh interfaces point into the meshes compact geometry)
+        btAlignedObjectArray<btStridingMeshInterface*> meshInterfaces;
+        btAlignedObjectArray<void*> bvhBuffers;
+        CollisionProxyBuilder proxy_builder;
+        std::vector<CollisionProxy*> collisionProxies;
+        btAlignedObjectArray<btCollisionShape*> proxyShapes;
+        std::vector<Heightfield*> heightfields;
+
+        // proxies vs full render geometry benchmark (COLLISION_BENCHMARK)
+        btCollisionDispatcher * benchDispatcher;
+        btBroadphaseInterface * benchBroadphase;
+        btCollisionWorld * benchWorld;
+        unsigned long long int bench_frames;
+        double bench_proxy_time;
+        double bench_full_time;
+        int bench_contact_mismatch;
+        int bench_ray_mismatch;
+
         // vehicle data
         float engineForce;
         float engineForceIncrement;
@@ -731,29 +889,58 @@ class WorldPhysics
         btVehicleRaycaster* raycaster;
         btRaycastVehicle* vehicle;
 
+        // podracer parts animation
+        float turn_angle;
+        float rotor_angle;
+        float dir_left_angle;
+        float dir_right_angle;
+        float air_scoops_angle;
+
         // control individual parts
         btRigidBody * chariot_body;
         btRigidBody * reactors_body;
         btTransform reactors_initialTransform;
         btTransform chariot_initialTransform;
+        btGeneric6DofConstraint * connection;
         btCollisionObject * reactors_colObj;
+        btGhostObject * lap_trigger;
+
+        // pod contacts gathered from the persistent manifolds after each internal tick
+        bool lap_contact;
+        bool terrain_contact;
+        bool ground_contact;
         btSoftBody * cable_left;
         btSoftBody * cable_right;
-        std::vector<Vertex> initial_c_left_vertices;
-        std::vector<int> initial_c_left_indices;
-        std::vector<Vertex> initial_c_right_vertices;
-        std::vector<int> initial_c_right_indices;
+        PhysicsSnapshot initial_state;
         std::vector<Vertex> prev_c_left_vertices;
         std::vector<Vertex> prev_c_right_vertices;
         std::vector<Vertex> updated_c_left_vertices;
         std::vector<Vertex> updated_c_right_vertices;
 
         /***** internal methods *****/
+        btCollisionObject * add_static_mesh(Mesh * m, const std::string & cache_name, int group, int mask, btCollisionWorld * world = nullptr);
+        btCollisionObject * add_static_proxy(Mesh * m, const std::string & cache_name, bool hulls, int group, int mask);
+        btCollisionShape * create_triangle_shape(const unsigned char * vertex_base, int vertex_stride, int nb_vertices, const std::vector<int> & indices, unsigned int checksum, const std::string & cache_name);
+        btCollisionObject * add_static_heightfield(Mesh * m, const std::string & cache_name, int group, int mask);
+        btCollisionObject * add_static_body(btCollisionShape * shape, int group, int mask, btCollisionWorld * world, const btVector3 & origin = btVector3(0, 0, 0));
+        bool is_grandstand(const std::string & mesh_name);
+        static void tick_callback(btDynamicsWorld * world, btScalar time_step);
+        void process_contacts();
+        void benchmark_collisions();
+        unsigned int mesh_checksum(const std::vector<Vertex> & vertices, const std::vector<int> & indices);
+        unsigned int position_checksum(const std::vector<glm::vec3> & positions, const std::vector<int> & indices);
+        btOptimizedBvh * load_bvh(const std::string & cache_path, unsigned int checksum);
+        void save_bvh(const std::string & cache_path, unsigned int checksum, btOptimizedBvh * bvh);
         btScalar * vertex_list_2_btScalarArray(std::vector<Vertex> const & vertices);
         int get_vertex_defined_index(glm::vec3 ref_pos, int ref_index, const std::vector<std::pair<glm::vec3, int>> & couples);
         int retrieve_correct_index(glm::vec3 ref_pos, const std::vector<std::pair<glm::vec3, int>> & couple);
         std::vector<Vertex> init_previous_vertices(std::vector<Vertex> ref_vertices, std::vector<Vertex> v);
         Vertex get_vertex(glm::vec3 pos, glm::vec3 normal, glm::vec3 prev_pos, const std::vector<Vertex> & prev_vertices);
+        std::vector<Vertex> expand_cable_vertices(const std::vector<Vertex> & unique_vertices, const std::vector<int> & indices, std::vector<int> & expanded_indices);
+        void save_rigid_body(btRigidBody * body, RigidBodySnapshot & snapshot);
+        void restore_rigid_body(btRigidBody * body, const RigidBodySnapshot & snapshot);
+        void save_soft_body(btSoftBody * body, const std::vector<Vertex> & render_vertices, SoftBodySnapshot & snapshot);
+        void restore_soft_body(btSoftBody * body, std::vector<Vertex> & render_vertices, Mesh * render_mesh, const SoftBodySnapshot & snapshot);
 };
 
 #endif
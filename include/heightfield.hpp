@@ -0,0 +1,61 @@
+#ifndef _HEIGHTFIELD_HPP_
+#define _HEIGHTFIELD_HPP_
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cfloat>
+#include <glm/glm.hpp>
+#include "mesh.hpp"
+
+#define HEIGHTFIELD_CACHE_MAGIC 0x44464850 // "PHFD"
+#define HEIGHTFIELD_CELL_SIZE 2.0f // world units between two height samples
+
+struct HeightfieldHit
+{
+	float fraction;
+	glm::vec3 position;
+	glm::vec3 normal;
+};
+
+// regular grid of heights over the xz plane, resampled from a terrain mesh
+// triangulated like btHeightfieldTerrainShape (diagonal from (x, z+1) to (x+1, z))
+class Heightfield
+{
+	public:
+
+		Heightfield(float p_cell_size = HEIGHTFIELD_CELL_SIZE);
+		void resample(const std::vector<Vertex> & vertices, const std::vector<int> & indices);
+		bool load(const std::string & path, unsigned int checksum, const std::vector<Vertex> & vertices);
+		void save(const std::string & path, unsigned int checksum) const;
+		float get_height(float x, float z) const;
+		bool raycast(glm::vec3 from, glm::vec3 to, HeightfieldHit & hit) const;
+
+		int get_width() const;
+		int get_length() const;
+		float get_cell_size() const;
+		float get_min_height() const;
+		float get_max_height() const;
+		glm::vec3 get_center() const;
+		float* get_data();
+
+	private:
+
+		void fit_grid(const std::vector<Vertex> & vertices);
+		float sample(int x, int z) const;
+		bool ray_cell(glm::vec3 from, glm::vec3 dir, int x, int z, float & t, glm::vec3 & normal) const;
+		bool ray_triangle(glm::vec3 from, glm::vec3 dir, glm::vec3 a, glm::vec3 b, glm::vec3 c, float & t) const;
+
+		float cell_size;
+		int width; // samples along x
+		int length; // samples along z
+		float min_x;
+		float min_z;
+		float min_height;
+		float max_height;
+		std::vector<float> heights; // heights[z * width + x]
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef _HUD_HPP_
+#define _HUD_HPP_
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <GL/glew.h>
+#include "shader.hpp"
+#include "stb_image.hpp"
+
+#define HUD_ATLAS_WIDTH 2048
+#define HUD_ATLAS_GUTTER 8 // edge texels repeated around each image so mip levels don't bleed
+#define HUD_ATLAS_MIP_LEVELS 4 // cells are aligned on 1 << HUD_ATLAS_MIP_LEVELS texels
+#define HUD_MAX_QUADS 64
+
+// screen space rectangle of one HUD element (normalized device coordinates)
+struct HudQuad
+{
+	float x0;
+	float y0;
+	float x1;
+	float y1;
+	float z;
+};
+
+// atlas rectangle of one HUD image
+struct HudGlyph
+{
+	float u0;
+	float v0;
+	float u1;
+	float v1;
+	bool loaded;
+};
+
+// packs the HUD images into one atlas and draws every quad of a frame from one dynamic buffer
+class HudBatcher
+{
+	public:
+
+		HudBatcher();
+		~HudBatcher();
+		void add_image(int id, const std::string & path, bool flip);
+		void build();
+		bool has_image(int id) const;
+		void add_quad(int id, const HudQuad & quad, float fill = 1.0f);
+		void flush(Shader & shader);
+		size_t get_gpu_bytes() const;
+
+	private:
+
+		struct Image
+		{
+			int id;
+			int width;
+			int height;
+			unsigned char* data;
+		};
+
+		std::vector<Image> images; // pending until build()
+		std::vector<HudGlyph> glyphs; // indexed by image id
+		std::vector<float> vertices; // position (3) + tex coords (2)
+		GLuint atlas;
+		int atlas_height;
+		GLuint VAO;
+		GLuint VBO;
+		GLuint EBO;
+};
+
+#endif
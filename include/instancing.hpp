@@ -0,0 +1,60 @@
+#ifndef _INSTANCING_HPP_
+#define _INSTANCING_HPP_
+
+#include <GL/glew.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "shader.hpp"
+#include "object.hpp"
+
+#define INSTANCE_SSBO_BINDING 6
+
+// one prototype drawn once per transform, the geometry of each instance is the prototype moved by its offset
+class InstanceGroup
+{
+	public:
+
+		InstanceGroup(Object* p_prototype);
+		~InstanceGroup();
+		int add_instance(glm::mat4 offset = glm::mat4(1.0f));
+		int add_copy(Object* copy); // -1 when the copy isn't the prototype moved
+		void set_transform(int instance, const glm::mat4 & model);
+		void draw(Shader& s, int lod = 0);
+		int get_instance_count() const;
+
+	private:
+
+		Object* prototype;
+		std::vector<glm::mat4> offsets;
+		std::vector<glm::mat4> transforms; // model * offset, streamed each draw
+		GLuint SSBO;
+		int capacity;
+};
+
+// a set of parts drawn together, identical ones share a single instanced draw
+class InstanceBatch
+{
+	public:
+
+		~InstanceBatch();
+		int add(Object* object);
+		void set_transform(int part, const glm::mat4 & model);
+		void draw(Shader& s, int lod = 0);
+		int get_part_count() const;
+		int get_group_count() const;
+
+	private:
+
+		struct Slot
+		{
+			int group;
+			int instance;
+		};
+
+		std::vector<InstanceGroup*> groups;
+		std::vector<Slot> parts;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef _LOD_HPP_
+#define _LOD_HPP_
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <glm/glm.hpp>
+#include "mesh.hpp"
+#include "mesh_optimizer.hpp"
+#include "simplifier.hpp"
+
+#define LOD_CACHE_MAGIC 0x444F4C50 // "PLOD"
+#define LOD_CACHE_DIR "../assets/cache/"
+#define LOD_MIN_TRIANGLES 1024 // smaller meshes keep their full detail only
+#define LOD_MAX_ERROR 0.01f // first level, relative to the mesh radius, doubled at each level
+#define LOD_MIN_REDUCTION 0.8f // a level keeping more than this share of the previous one is dropped
+#define LOD_MAX_PASSES 16
+
+// quadric simplification of render meshes, every lod indexes the full detail vertices
+class LodBuilder
+{
+	public:
+
+		LodBuilder(float p_max_error = LOD_MAX_ERROR);
+		void build(const std::vector<Vertex> & vertices, const std::vector<int> & indices, LodChain & chain);
+		bool load(const std::string & path, unsigned int checksum, int nb_vertices, int nb_indices, LodChain & chain);
+		void save(const std::string & path, unsigned int checksum, const LodChain & chain);
+		static unsigned int checksum(const std::vector<Vertex> & vertices, const std::vector<int> & indices);
+
+	private:
+
+		void weld(const std::vector<Vertex> & vertices, const std::vector<int> & indices, std::vector<int> & tris, std::vector<int> & position_id, std::vector<bool> & locked);
+
+		float max_error;
+};
+
+#endif
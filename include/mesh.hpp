@@ -9,12 +9,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <math.h>
+#include <cstring>
 #include <algorithm>
 #include "shader.hpp"
 #include "animation.hpp"
 #include "joint.hpp"
+#include "occlusion.hpp"
 
 #define PI 3.14159265
+#define MESH_ARENA_VERTICES 131072 // initial capacity of each arena buffer, doubled when full
+#define MESH_ARENA_INDICES 524288
+#define MATERIAL_SSBO_BINDING 1
+#define DRAW_SSBO_BINDING 2
+#define MESH_MAX_LODS 4 // full detail included
+#define LOD_PIXEL_ERROR 1.0f // projected simplification error allowed before switching to a finer lod
+#define LOD_SCREEN_HEIGHT 1080.0f
+#define LOD_FADE_FRAMES 16
+#define LOD_SHADOW 2 // shadow casters never go finer than this level
+#define FNV_OFFSET_BASIS 2166136261u
 
 enum DRAWING_MODE
 {
@@ -46,17 +58,55 @@ struct Vertex
 	}
 };
 
+// bitwise vertex identity, for welding the corners OBJ exports repeat
+struct VertexHash
+{
+	size_t operator()(const Vertex & v) const
+	{
+		const unsigned int * bits = reinterpret_cast<const unsigned int*>(&v);
+		size_t hash = 0;
+		for(int i = 0; i < sizeof(Vertex) / sizeof(unsigned int); i++)
+			hash = (hash * 31) ^ bits[i];
+		return hash;
+	}
+};
+
+// positions only, for welding across uv and normal seams
+struct PositionHash
+{
+	size_t operator()(const glm::vec3 & p) const
+	{
+		const unsigned int * bits = reinterpret_cast<const unsigned int*>(&p);
+		return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+	}
+};
+
+struct VertexEqual
+{
+	bool operator()(const Vertex & a, const Vertex & b) const
+	{
+		return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+	}
+};
+
+// FNV-1a for the cache checksums, chain calls through hash to cover several buffers
+inline unsigned int fnv1a(const void * data, size_t size, unsigned int hash = FNV_OFFSET_BASIS)
+{
+	const unsigned char * bytes = reinterpret_cast<const unsigned char*>(data);
+	for(size_t b = 0; b < size; b++)
+		hash = (hash ^ bytes[b]) * 16777619u;
+	return hash;
+}
+
 struct Texture
 {
 	GLuint id;
 	TextureType type;
-	std::string texture_file_path;
 
-	Texture(GLuint tex_id, TextureType t, std::string tex_file_path)
+	Texture(GLuint tex_id, TextureType t)
 	{
 		id = tex_id;
 		type = t;
-		texture_file_path = tex_file_path;
 	}
 };
 
@@ -96,31 +146,145 @@ struct AABB
     std::string name;
 };
 
+// simplified index lists into the full detail vertices, coarser at each level
+struct LodChain
+{
+	std::vector<std::vector<int>> indices;
+	std::vector<float> errors; // world units, one per level
+};
+
+// gpu vertex layouts, picked per mesh
+enum VertexFormat
+{
+	VERTEX_FULL, // Vertex as is (dynamic meshes)
+	VERTEX_STATIC,
+	VERTEX_STATIC_TILED, // uvs outside [0, 1] keep float precision
+	VERTEX_SKINNED,
+	VERTEX_FORMAT_COUNT
+};
+
+struct StaticVertex
+{
+	glm::vec3 position;
+	GLuint normal; // snorm 10:10:10:2
+	GLushort texCoords[2]; // unorm16
+};
+
+struct StaticTiledVertex
+{
+	glm::vec3 position;
+	GLuint normal;
+	glm::vec2 texCoords;
+};
+
+struct SkinnedVertex
+{
+	glm::vec3 position;
+	GLuint normal;
+	GLushort texCoords[2];
+	GLubyte bonesID[2]; // 0 means no influence
+	GLubyte bonesWeight[2]; // unorm8
+};
+
+// one range of an arena buffer, in vertices or indices
+struct ArenaRange
+{
+	int offset;
+	int count;
+};
+
+struct ArenaBuffer
+{
+	GLuint id;
+	int stride;
+	int capacity;
+	int used; // high water mark
+	std::vector<ArenaRange> free_list; // sorted by offset
+};
+
+// static meshes suballocate their vertices and indices from shared buffers, one VAO per vertex format
+class MeshArena
+{
+	public:
+
+		static MeshArena & get();
+		void allocate(VertexFormat format, bool short_indices, const void* vertex_data, int vertex_count, const void* index_data, int index_count, int & base_vertex, int & first_index);
+		void release(VertexFormat format, bool short_indices, int base_vertex, int vertex_count, int first_index, int index_count);
+		void bind(VertexFormat format, bool short_indices);
+		void destroy();
+		size_t get_used_bytes() const;
+		size_t get_gpu_bytes() const;
+
+	private:
+
+		MeshArena();
+		int reserve(ArenaBuffer & buffer, int count);
+		void give_back(ArenaBuffer & buffer, int offset, int count);
+		void setup_VAO(VertexFormat format);
+
+		GLuint VAO[VERTEX_FORMAT_COUNT];
+		ArenaBuffer vertex_buffers[VERTEX_FORMAT_COUNT];
+		ArenaBuffer index_buffers[2]; // 32 bit, 16 bit
+};
+
 class Mesh
 {
 	public:
 
-		Mesh(std::vector<Vertex> vertices_list, std::vector<int> indices_list, Material m, std::string p_name, bool p_drawable = false, bool p_dynamic_draw = false, bool p_lap = false);
+		Mesh(std::vector<Vertex> vertices_list, std::vector<int> indices_list, Material m, std::string p_name, bool p_drawable = false, bool p_dynamic_draw = false, bool p_lap = false, LodChain p_lods = LodChain());
 		void recreate(std::vector<Vertex> vertices_list, std::vector<int> indices_list);
         ~Mesh();
         bool is_drawable();
 		std::string get_name();
-		void draw(Shader& s, DRAWING_MODE mode = SOLID);
-		void draw(Shader& s, std::map<std::string, Joint*> bones_ptr_list, Animation* anim, int frame, Joint* skeleton);
+		void draw(Shader& s, DRAWING_MODE mode = SOLID, int lod = 0);
+		void draw_instanced(Shader& s, int nb_instances, int lod = 0);
+		void draw_skinned(Shader& s);
 		std::vector<Vertex> const& get_vertex_list() const;
 		std::vector<int> const& get_index_list() const;
+		std::vector<glm::vec3> const& get_position_list() const;
+		void compact_geometry();
+		void release_geometry();
+		size_t get_cpu_bytes() const;
+		size_t get_gpu_bytes() const;
         void update_VBO(std::vector<Vertex> const & updated_vertices);
         void reset_drawable();
         bool is_lap_building() const;
+		int get_lod_count() const;
 
 	private:
 
+		void bind_material(Shader& s);
+		void create_buffers();
+		void compute_bounds();
+		void upload_to_arena();
+		void bind_VAO();
+		GLenum index_type() const;
+
+		// dynamic meshes own their buffers, static ones live in the arena
 		GLuint VAO;
 		GLuint VBO;
 		GLuint EBO;
+		VertexFormat format;
+		bool short_indices;
+		int base_vertex;
+		int first_index;
+		int vertex_count;
+		int index_count; // full detail
+		int arena_index_count; // every lod
+
+		// lod 0 is the full detail range above
+		int nb_lods;
+		int lod_first_index[MESH_MAX_LODS];
+		int lod_index_count[MESH_MAX_LODS];
+		float lod_error[MESH_MAX_LODS];
+		glm::vec3 bounds_center;
+		float bounds_radius;
 
+		// cpu geometry, dropped once uploaded unless physics holds on to it (compact positions + indices)
 		std::vector<Vertex> vertices;
 		std::vector<int> indices;
+		std::vector<glm::vec3> positions;
+		LodChain lods; // already in the arena, kept with the cpu geometry for the software occluders
 		Material material;
 		std::string name;
         bool drawable;
@@ -165,23 +329,99 @@ class DrawMaster
         DrawMaster();
         ~DrawMaster();
         void destroy(struct QuadTree* node);
-        void build_tree(std::vector<Mesh*> m);
+        void build_tree(const std::vector<Mesh*> & m);
         void process_drawable_meshes_list(glm::vec3 cam_pos, glm::vec3 cam_view_dir, glm::vec3 cam_right, glm::vec3 cam_up);
         void print_tree(struct QuadTree * node = nullptr);
         std::vector<AABB> get_drawable_meshes_AABB();
+        void draw(Shader& s, bool shadow_pass = false);
+        OcclusionCuller & get_occlusion();
 
     private:
+        struct DrawList;
+
         /* ---------- METHODS ---------- */
 
         void merge_AABB(const AABB & a, const AABB & b, AABB & res);
         void process_top_level_AABB(AABB & top_level, std::vector<AABB> list);
         void process_QuadTree_subLevels(struct QuadTree * node, int lvl);
-        void fill_tree(struct QuadTree * node, const std::vector<AABB> & AABB_list, std::vector<Mesh*> m);
+        void fill_tree(struct QuadTree * node, const std::vector<AABB> & AABB_list, const std::vector<Mesh*> & m);
         bool overlap(const AABB & mesh_AABB, struct QuadTree * node);
         void update_drawable(const struct AABB & f_AABB, struct QuadTree * node);
+        void upload_materials();
+        void select_lods(glm::vec3 cam_pos, float cam_fov);
+        void build_draw_list(DrawList & list, bool shadow_pass);
 
         /* ---------- PROPERTIES ---------- */
         struct QuadTree* root;
+
+        // indirect submission
+        struct DrawElementsIndirectCommand
+        {
+            GLuint count;
+            GLuint instance_count;
+            GLuint first_index;
+            GLint base_vertex;
+            GLuint base_instance; // index in the draw SSBO
+        };
+
+        // std430 layout, one per command
+        struct GpuDraw
+        {
+            GLint material;
+            GLfloat fade; // dither coverage, > 0 incoming lod, < 0 outgoing lod
+        };
+
+        // a visible mesh at one lod, two of them while a transition fades
+        struct DrawItem
+        {
+            int mesh;
+            int lod;
+            float fade;
+        };
+
+        struct LodState
+        {
+            int lod;
+            int prev_lod;
+            int fade_frame; // LOD_FADE_FRAMES once settled
+        };
+
+        struct GpuMaterial
+        {
+            glm::vec4 base_color; // w = has textures
+        };
+
+        // consecutive commands sharing a vertex format, an index type and a diffuse texture
+        struct DrawBatch
+        {
+            VertexFormat format;
+            bool short_indices;
+            GLuint texture;
+            int count;
+        };
+
+        // commands of one pass and the buffers they are streamed to
+        struct DrawList
+        {
+            std::vector<DrawElementsIndirectCommand> commands;
+            std::vector<GpuDraw> draws;
+            std::vector<DrawBatch> batches;
+            GLuint indirect_buffer;
+            GLuint draw_SSBO;
+        };
+
+        std::vector<Mesh*> meshes;
+        std::vector<GLuint> diffuse_maps; // per mesh, 0 when untextured
+        std::vector<LodState> lod_states; // per mesh
+        std::vector<DrawItem> items;
+        std::vector<int> cull_meshes;
+        std::vector<GLuint> cull_counts;
+        std::vector<bool> cull_visible;
+        DrawList camera_list; // built and culled once per frame, the depth pass reuses it
+        DrawList shadow_list;
+        bool camera_list_dirty;
+        GLuint material_SSBO;
+        OcclusionCuller occlusion;
 };
 
 #endif
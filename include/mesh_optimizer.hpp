@@ -0,0 +1,51 @@
+#ifndef _MESH_OPTIMIZER_HPP_
+#define _MESH_OPTIMIZER_HPP_
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "mesh.hpp"
+
+#define MESH_CACHE_MAGIC 0x48534D50 // "PMSH"
+#define MESH_CACHE_DIR "../assets/cache/"
+#define VERTEX_CACHE_SIZE 32 // lru size the triangle order is optimized for
+#define VERTEX_FIFO_SIZE 16 // fifo size the acmr/atvr report is measured with
+#define OVERDRAW_THRESHOLD 1.05f // share of the cache efficiency the overdraw clusters may give up
+
+// import time statistics, acmr = misses per triangle, atvr = misses per vertex
+struct MeshOptStats
+{
+	unsigned int triangles_before;
+	unsigned int triangles_after;
+	unsigned int vertices_before;
+	unsigned int vertices_after;
+	unsigned int misses_before;
+	unsigned int misses_after;
+};
+
+// reorders render meshes for the post-transform cache, early z and vertex fetch
+class MeshOptimizer
+{
+	public:
+
+		void optimize(std::vector<Vertex> & vertices, std::vector<int> & indices, MeshOptStats & stats);
+		void optimize_vertex_cache(std::vector<int> & indices, int nb_vertices);
+		bool load(const std::string & path, unsigned int checksum, std::vector<Vertex> & vertices, std::vector<int> & indices, MeshOptStats & stats);
+		void save(const std::string & path, unsigned int checksum, const std::vector<Vertex> & vertices, const std::vector<int> & indices, const MeshOptStats & stats);
+		static unsigned int cache_misses(const std::vector<int> & indices, int nb_vertices);
+		static void weld(const std::vector<Vertex> & vertices, const std::vector<int> & indices, std::vector<int> & remap, std::vector<int> & tris);
+
+	private:
+
+		void optimize_overdraw(const std::vector<Vertex> & vertices, std::vector<int> & indices);
+		void remap_fetch(std::vector<Vertex> & vertices, std::vector<int> & indices);
+		float vertex_score(int cache_position, int remaining) const;
+};
+
+#endif
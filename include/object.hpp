@@ -9,9 +9,13 @@
 #include <assimp/postprocess.h>
 #include <omp.h>
 #include "mesh.hpp"
+#include "lod.hpp"
+#include "mesh_optimizer.hpp"
 #include "joint.hpp"
 #include "animation.hpp"
 
+#define INSTANCE_MATCH_EPSILON 1e-4f // relative to the mesh radius
+
 enum SMOKE_DIR
 {
 	SMOKE_LEFT,
@@ -31,13 +35,18 @@ class Object
 		Object(const std::string& obj_path, bool drawable = false, bool p_lap = false, bool p_dynamic = false);
 		~Object();
 		Joint* get_skeleton();
-		void draw(Shader& shader, DRAWING_MODE mode = SOLID);
-		void draw(Shader& shader, Animation* anim, int frame);
+		void draw(Shader& shader, DRAWING_MODE mode = SOLID, int lod = 0);
+		void draw_instanced(Shader& shader, int nb_instances, int lod = 0);
+		void draw_pose(Shader& shader);
+		Pose& get_pose();
 		std::vector<Animation*> get_animations();
 		std::map<std::string, Joint*> get_joints_ptr_list();
-        std::vector<Mesh*> get_mesh_collection();
+        std::vector<Mesh*> const & get_mesh_collection() const;
 		static GLuint create_texture(std::string tex_path, bool flip = false);
         void reset_drawable();
+		void release_geometry();
+		void memory_usage(size_t & cpu, size_t & gpu) const;
+		bool match_instance(const Object & copy, glm::mat4 & offset) const;
 		
 		// smoke data
 		std::vector<glm::vec3> get_left_sources() const;
@@ -53,19 +62,25 @@ class Object
 		void explore_node(aiNode* node, const aiScene* scene, bool drawable, bool p_lap, bool p_dynamic);
 		Mesh* get_mesh(aiMesh* mesh, const aiScene* scene, bool drawable, bool p_lap, bool p_dynamic);
 		int texture_already_loaded(std::string texture_path);
+		std::string get_texture_path(GLuint tex_id) const;
+		void optimize_mesh(std::vector<Vertex> & vertices, std::vector<int> & indices);
+		void load_lods(const std::vector<Vertex> & vertices, const std::vector<int> & indices, LodChain & lods);
 		
 		// Animation related methods
 		void create_joint_hierarchy(const aiScene* scene);
 		void create_joint_hierarchy_aux(aiNode* bone, Joint* j, int& id);
-		std::vector<aiNodeAnim*> get_parent_joints_list(Joint* j, aiAnimation* currAnim);
-		glm::mat4 chainComputePoseMatrix(glm::mat4 matrix, std::vector<aiNodeAnim*> parentAnimJointList, int frame, aiNodeAnim* animJoint, std::vector<double> kFrameTime);
-		glm::mat4 get_joint_poseMatrix_atFrame(aiNodeAnim* joint, int frame, glm::mat4 matrix);
+		void flatten_joint_hierarchy();
+		Animation* create_animation(aiAnimation* anim);
 
 		std::vector<Mesh*> mesh_collection;
 		std::vector<Texture> texture_collection;
+		std::vector<std::string> texture_paths; // parallel to texture_collection, only used while loading
+		std::string cache_name; // file stem, only used while loading
+		MeshOptStats opt_stats; // summed over the file, only used while loading
 		Joint* skeleton;
 		std::map<std::string, Joint*> joints_ptr_list;
 		std::vector<Animation*> animations;
+		Pose pose;
 
 		// smoke emission sources
 		glm::vec3 smoke_left_dir;
@@ -0,0 +1,92 @@
+#ifndef _OCCLUSION_HPP_
+#define _OCCLUSION_HPP_
+
+#include <GL/glew.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "shader.hpp"
+
+#define OCCLUSION_GROUP_SIZE 64 // cull shader local size
+#define OCCLUSION_HIZ_GROUP_SIZE 8
+#define OCCLUSION_COMMAND_BINDING 3
+#define OCCLUSION_BOUNDS_BINDING 4
+#define OCCLUSION_STATS_BINDING 5
+#define OCCLUSION_CPU_WIDTH 256 // software depth buffer, same aspect as the window
+#define OCCLUSION_CPU_HEIGHT 128
+#define OCCLUSION_MIN_OCCLUDER_SIZE 100.0f // world units, smaller meshes hide too little to be worth rasterizing
+#define OCCLUSION_NEAR_W 0.1f
+#define OCCLUSION_STATS_FRAMES 120
+
+enum OCCLUSION_MODE
+{
+	OCCLUSION_OFF,
+	OCCLUSION_GPU, // last frame's depth reduced into a hi-z pyramid, tested in a compute shader
+	OCCLUSION_CPU // coarse occluders rasterized in software, for testing without the gpu path
+};
+
+struct OcclusionStats
+{
+	GLuint drawn_triangles;
+	GLuint occluded_triangles;
+	GLuint drawn_meshes;
+	GLuint occluded_meshes;
+};
+
+// tests mesh bounding boxes against a max depth pyramid and drops the hidden ones from the indirect list
+class OcclusionCuller
+{
+	public:
+
+		OcclusionCuller();
+		~OcclusionCuller();
+		void set_mode(OCCLUSION_MODE p_mode, bool p_print_stats = false);
+		OCCLUSION_MODE get_mode() const;
+		void set_bounds(const std::vector<glm::vec3> & min_corners, const std::vector<glm::vec3> & max_corners);
+		void add_occluder(const std::vector<glm::vec3> & positions, const std::vector<int> & indices);
+		void invalidate();
+		void build_hiz(GLuint depth_texture, int width, int height, glm::mat4 p_view_proj);
+		void rasterize(glm::mat4 p_view_proj);
+		void cull_gpu(GLuint indirect_buffer, int nb_commands);
+		void cull_cpu(const std::vector<int> & mesh_ids, const std::vector<GLuint> & index_counts, std::vector<bool> & visible);
+		void report();
+
+	private:
+
+		void create_hiz(int width, int height);
+		void read_gpu_stats();
+		bool test_cpu(glm::vec3 min_corner, glm::vec3 max_corner) const;
+		float sample_cpu(int level, int x, int y) const;
+
+		OCCLUSION_MODE mode;
+		bool print_stats;
+		bool ready; // false until a depth pyramid matches view_proj
+		glm::mat4 view_proj; // camera that produced the pyramid
+
+		// gpu path
+		Shader* hiz_shader;
+		Shader* cull_shader;
+		GLuint hiz_texture;
+		int hiz_width; // level 0, half the depth texture
+		int hiz_height;
+		int hiz_levels;
+		int depth_width;
+		int depth_height;
+		GLuint bounds_SSBO;
+		GLuint stats_SSBO;
+		bool stats_pending; // the stats buffer holds a frame not read back yet
+
+		// cpu path
+		std::vector<glm::vec3> bounds_min;
+		std::vector<glm::vec3> bounds_max;
+		std::vector<glm::vec3> occluders; // 3 positions per triangle
+		std::vector<std::vector<float>> cpu_levels; // max depth pyramid, level 0 = OCCLUSION_CPU_WIDTH x OCCLUSION_CPU_HEIGHT
+
+		// accumulated since the last report
+		OcclusionStats totals;
+		int nb_frames;
+};
+
+#endif
@@ -5,28 +5,61 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <filesystem>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#define SHADER_CACHE_MAGIC 0x52444853 // "SHDR"
+#define SHADER_CACHE_DIR "../assets/cache/shaders/"
+
 class Shader
 {
 	public:
 
 		Shader(const std::string & vertex_shader_file, const std::string & fragment_shader_file, const std::string & geometry_shader_file = "../shaders/default/geometry.glsl");
+		Shader(const std::string & compute_shader_file);
+		~Shader();
 		GLuint get_id() const;
 		void set_int(const std::string & name, int v) const;
 		void set_float(const std::string & name, float v) const;
 		void set_vec3f(const std::string & name, glm::vec3 v) const;
 		void set_Matrix(const std::string & name, glm::mat4 m) const;
+		void bind_uniform_block(const std::string & name, GLuint binding) const;
 		void set_texture(const std::string & texture_path, int tex_unit, const std::string & uniform_name, bool flip);
 		void use() const;
 
+		// hot reload (see ShaderReloader)
+		static const std::vector<Shader*> & get_live();
+		bool uses_file(const std::string & path) const;
+		void begin_reload();
+		bool poll_reload(bool parallel);
+		const std::string & get_reload_error() const;
+
 	private:
 
 		void compile(const char * vertex_shader_code, const char * fragment_shader_code, const char * geometry_shader_code);
+		void compile_compute(const char * compute_shader_code);
+		bool load_binary(unsigned long long source_hash);
+		void save_binary(unsigned long long source_hash) const;
+		static unsigned long long hash(const char * text, unsigned long long seed = 14695981039346656037ull);
+		static unsigned long long driver_hash();
+		static std::string cache_path(unsigned long long source_hash);
+		static std::vector<Shader*> & live();
+		static bool read_source(const std::string & path, std::string & code);
+		void copy_uniforms(GLuint from, GLuint to) const;
 		
 		GLuint id;
+		std::vector<std::string> files; // vertex, fragment, geometry or compute only
+		GLuint pending; // program being rebuilt, swapped in once linked
+		std::vector<GLuint> pending_stages;
+		unsigned long long pending_hash;
+		std::string reload_error;
 };
 
 #endif
@@ -0,0 +1,56 @@
+#ifndef _SHADER_RELOAD_HPP_
+#define _SHADER_RELOAD_HPP_
+
+#include <GL/glew.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <filesystem>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "shader.hpp"
+
+#define SHADER_RELOAD_DIR "../shaders/"
+#define OVERLAY_GLYPH_WIDTH 4 // 3x5 glyph plus one texel of spacing
+#define OVERLAY_GLYPH_HEIGHT 6
+#define OVERLAY_SCALE 3 // screen pixels per glyph texel
+#define OVERLAY_MARGIN 8 // pixels from the top left corner
+#define OVERLAY_MAX_COLUMNS 120
+#define OVERLAY_MAX_LINES 40
+
+// watches the shader folders, rebuilds edited programs between frames and shows failed builds on screen
+class ShaderReloader
+{
+	public:
+
+		ShaderReloader();
+		~ShaderReloader();
+		void poll();
+		void draw_overlay(int width, int height);
+		bool is_parallel() const;
+
+	private:
+
+		void read_events(std::set<std::string> & changed);
+		void build_text();
+		void upload_text();
+
+		int fd; // inotify instance, -1 when watching failed
+		std::map<int, std::string> watched; // watch descriptor -> folder
+		bool parallel; // driver compiles and links off the render thread
+
+		// error overlay
+		Shader* overlay_shader;
+		GLuint VAO;
+		GLuint VBO;
+		GLuint texture;
+		std::vector<std::string> lines;
+		int columns;
+		bool dirty; // lines changed since the last upload
+		int last_width;
+		int last_height;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef _SIMPLIFIER_HPP_
+#define _SIMPLIFIER_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <cfloat>
+#include <glm/glm.hpp>
+
+#define SIMPLIFIER_BORDER_WEIGHT 10.0 // open borders resist collapsing this much more than the surface
+
+// quadric edge collapses onto existing vertices, shared by the lod chains and the collision proxies
+class QuadricSimplifier
+{
+	public:
+
+		int collapse_pass(const std::vector<glm::vec3> & positions, const std::vector<int> & position_id, const std::vector<bool> & locked, std::vector<int> & tris, int target, double max_cost, double & pass_cost);
+
+	private:
+
+		struct Quadric
+		{
+			double a[10]; // symmetric 4x4 (a2, ab, ac, ad, b2, bc, bd, c2, cd, d2)
+		};
+
+		void add_plane(Quadric & q, glm::dvec3 n, double d, double w);
+		double evaluate(const Quadric & q, glm::vec3 p);
+		bool flips(int v, glm::vec3 target, int other, const std::vector<glm::vec3> & positions, const std::vector<int> & tris, const std::vector<int> & adj_offset, const std::vector<int> & adj);
+};
+
+#endif
@@ -3,8 +3,8 @@
 
 #include <iostream>
 #include <vector>
-#include <random>
 #include <map>
+#include <cmath>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -14,20 +14,15 @@
 #include "animation.hpp"
 #include "object.hpp"
 
-#define MAX_PARTICLES 240
+#define MAX_PARTICLES 24000 // ring capacity, only the live window of it is simulated and drawn each frame
+#define SMOKE_EMISSION_RATE 60.0f // particles per second and per source
+#define SMOKE_WORK_GROUP_SIZE 64
 
-struct Particle
+// GPU side particle, std430 layout shared by the compute pass and the vertex attributes
+struct GpuParticle
 {
-	glm::vec3 position;
-	float lifeTime;
-	glm::vec3 direction;
-
-	Particle(glm::vec3 pos, glm::vec3 dir)
-	{
-		position = pos;
-		lifeTime = 0.0f;
-		direction = dir;
-	}
+	glm::vec4 position; // xyz position, w lifeTime
+	glm::vec4 direction;
 };
 
 class Smoke
@@ -35,8 +30,10 @@ class Smoke
 	public:
 
 		Smoke(std::vector<glm::vec3> sources, glm::vec3 sources_dir);
+		~Smoke();
 		void set_init_dir(glm::vec3 dir);
-		void draw(double delta, Shader* smoke_shader);
+		void update(double delta, Shader* compute_shader);
+		void render(Shader* smoke_shader);
 
 	private:
 
@@ -49,16 +46,15 @@ class Smoke
 		glm::vec3 s3;
 		glm::vec3 direction;
 		
-		// set of particles
-		std::vector<struct Particle> particles;
-		std::random_device rd;
-		std::mt19937 gen;
-		std::uniform_real_distribution<float> dis;
+		// ring of particles on the GPU, newest particle at index first
+		int first;
+		int count; // live window, only these are simulated and drawn
+		float emission;
+		int seed;
 
 		// smoke attributes
 		float velocity;
 		float dissolve;
-		float jitter;
 };
 
 #endif
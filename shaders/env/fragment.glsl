@@ -1,4 +1,4 @@
-#version 330 core
+#version 460 core
 
 out vec4 frag_color;
 
@@ -10,6 +10,8 @@ in GS_OUT
 	vec4 frag_pos_sunlightSpace_env;
 	vec4 frag_pos_sunlightSpace_pod;
 	float visibility;
+	flat vec4 base_color;
+	flat float fade;
 } fs_in;
 
 struct Material
@@ -90,14 +92,22 @@ float pod_shadowFactor(vec4 frag)
 
 const float exposure = 0.2;
 
+// 4x4 ordered dither
+const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+
 void main()
 {
+	// lod transition: the incoming lod covers the cells under its fade, the outgoing lod the others
+	float threshold = (bayer[(int(gl_FragCoord.x) & 3) + (int(gl_FragCoord.y) & 3) * 4] + 0.5) / 16.0;
+	if((fs_in.fade > 0.0 && threshold > fs_in.fade) || (fs_in.fade < 0.0 && threshold <= -fs_in.fade))
+		discard;
+
 	if(fs_in.shadows == 0)
 	{
 		// color
 		vec4 sky = vec4(0.243, 0.396, 0.549, 1.0);
 		vec4 tatooine_color = vec4(1.0, 0.635, 0.188, 1.0);
-		vec4 base_color = texture(material.diffuse_1, fs_in.texCoords);
+		vec4 base_color = (fs_in.base_color.w > 0.5) ? texture(material.diffuse_1, fs_in.texCoords) : vec4(fs_in.base_color.rgb, 1.0);
 
 		// ambient
 		vec3 ambient = sun.color * 0.03;
@@ -1,4 +1,4 @@
-#version 330 core
+#version 460 core
 
 layout (triangles) in;
 layout (triangle_strip, max_vertices=3) out;
@@ -11,6 +11,8 @@ in VS_OUT
 	vec4 frag_pos_sunlightSpace_env;
 	vec4 frag_pos_sunlightSpace_pod;
 	float visibility;
+	flat vec4 base_color;
+	flat float fade;
 } gs_in[];
 
 out GS_OUT
@@ -21,6 +23,8 @@ out GS_OUT
 	vec4 frag_pos_sunlightSpace_env;
 	vec4 frag_pos_sunlightSpace_pod;
 	float visibility;
+	flat vec4 base_color;
+	flat float fade;
 } gs_out;
 
 void main()
@@ -32,6 +36,8 @@ void main()
 	gs_out.frag_pos_sunlightSpace_env = gs_in[0].frag_pos_sunlightSpace_env;
 	gs_out.frag_pos_sunlightSpace_pod = gs_in[0].frag_pos_sunlightSpace_pod;
 	gs_out.visibility = gs_in[0].visibility;
+	gs_out.base_color = gs_in[0].base_color;
+	gs_out.fade = gs_in[0].fade;
 	EmitVertex();
 	
 	gl_Position = gl_in[1].gl_Position;
@@ -41,6 +47,8 @@ void main()
 	gs_out.frag_pos_sunlightSpace_env = gs_in[1].frag_pos_sunlightSpace_env;
 	gs_out.frag_pos_sunlightSpace_pod = gs_in[1].frag_pos_sunlightSpace_pod;
 	gs_out.visibility = gs_in[1].visibility;
+	gs_out.base_color = gs_in[1].base_color;
+	gs_out.fade = gs_in[1].fade;
 	EmitVertex();
 	
 	gl_Position = gl_in[2].gl_Position;
@@ -50,6 +58,8 @@ void main()
 	gs_out.frag_pos_sunlightSpace_env = gs_in[2].frag_pos_sunlightSpace_env;
 	gs_out.frag_pos_sunlightSpace_pod = gs_in[2].frag_pos_sunlightSpace_pod;
 	gs_out.visibility = gs_in[2].visibility;
+	gs_out.base_color = gs_in[2].base_color;
+	gs_out.fade = gs_in[2].fade;
 	EmitVertex();
 
 	EndPrimitive();
@@ -1,4 +1,4 @@
-#version 330 core
+#version 460 core
 
 layout (location=0) in vec3 pos;
 layout (location=1) in vec3 vertex_normal;
@@ -14,6 +14,8 @@ out VS_OUT
 	vec4 frag_pos_sunlightSpace_env;
 	vec4 frag_pos_sunlightSpace_pod;
 	float visibility;
+	flat vec4 base_color;
+	flat float fade;
 } vs_out;
 
 uniform mat4 model;
@@ -21,12 +23,38 @@ uniform mat4 view;
 uniform mat4 proj;
 
 uniform int animation;
+layout (std140) uniform JointPalette
+{
+	mat4 palette[64];
+};
 uniform int shadowPass;
 uniform mat4 sunlightSpaceMatrix_env;
 uniform mat4 sunlightSpaceMatrix_pod;
 
 uniform int process_pod_shadowPass;
 
+// materials of the indirect path, one per mesh
+struct GpuMaterial
+{
+	vec4 base_color; // w = has textures
+};
+layout (std430, binding=1) readonly buffer Materials
+{
+	GpuMaterial materials[];
+};
+
+// per command data, indexed by the command base instance
+struct GpuDraw
+{
+	int material;
+	float fade; // > 0 incoming lod, < 0 outgoing lod
+};
+layout (std430, binding=2) readonly buffer Draws
+{
+	GpuDraw draws[];
+};
+uniform int indirect;
+
 const float fog_density = 0.0025f;
 const float gradient = 1.5f;
 
@@ -39,6 +67,14 @@ void main()
 	vs_out.frag_pos_sunlightSpace_env = sunlightSpaceMatrix_env * model * vec4(pos, 1.0);
 	vs_out.frag_pos_sunlightSpace_pod = sunlightSpaceMatrix_pod * model * vec4(pos, 1.0);
 	vs_out.visibility = 1.0f;
+	vs_out.base_color = vec4(1.0);
+	vs_out.fade = 1.0;
+	if(indirect == 1)
+	{
+		GpuDraw d = draws[gl_BaseInstance];
+		vs_out.base_color = materials[d.material].base_color;
+		vs_out.fade = d.fade;
+	}
 
 	float dist_to_camera;
 
@@ -52,7 +88,15 @@ void main()
 		}
 		else if(animation == 1)
 		{
-			gl_Position = proj * view * model * vec4(pos, 1.0);
+			// bones ids start at 1, -1 means no influence
+			mat4 skin = mat4(1.0);
+			if(vertex_bonesID.x > 0.0)
+			{
+				skin = palette[int(vertex_bonesID.x) - 1] * vertex_bonesWeight.x;
+				if(vertex_bonesID.y > 0.0)
+					skin += palette[int(vertex_bonesID.y) - 1] * vertex_bonesWeight.y;
+			}
+			gl_Position = proj * view * model * skin * vec4(pos, 1.0);
 		}
 	}
 	else if(shadowPass == 1)
@@ -0,0 +1,106 @@
+#version 460 core
+
+layout (local_size_x = 64) in;
+
+struct DrawElementsIndirectCommand
+{
+	uint count;
+	uint instance_count;
+	uint first_index;
+	int base_vertex;
+	uint base_instance;
+};
+
+struct GpuDraw
+{
+	int material; // mesh index
+	float fade;
+};
+
+struct Bounds
+{
+	vec4 min_corner;
+	vec4 max_corner;
+};
+
+layout (std430, binding = 2) readonly buffer Draws
+{
+	GpuDraw draws[];
+};
+
+layout (std430, binding = 3) buffer Commands
+{
+	DrawElementsIndirectCommand commands[];
+};
+
+layout (std430, binding = 4) readonly buffer MeshBounds
+{
+	Bounds bounds[];
+};
+
+layout (std430, binding = 5) buffer Stats
+{
+	uint drawn_triangles;
+	uint occluded_triangles;
+	uint drawn_meshes;
+	uint occluded_meshes;
+};
+
+uniform sampler2D hiz;
+uniform mat4 view_proj; // camera of the frame the pyramid was built from
+uniform int nb_commands;
+uniform int hiz_levels;
+
+bool visible(vec3 min_corner, vec3 max_corner)
+{
+	// screen rectangle and nearest depth of the box, anything reaching behind the camera is kept
+	vec3 ndc_min = vec3(1.0);
+	vec3 ndc_max = vec3(-1.0);
+	for(int c = 0; c < 8; c++)
+	{
+		vec3 corner = mix(min_corner, max_corner, vec3(c & 1, (c >> 1) & 1, (c >> 2) & 1));
+		vec4 clip = view_proj * vec4(corner, 1.0);
+		if(clip.w < 0.1)
+			return true;
+		vec3 ndc = clip.xyz / clip.w;
+		ndc_min = min(ndc_min, ndc);
+		ndc_max = max(ndc_max, ndc);
+	}
+
+	vec2 uv_min = clamp(ndc_min.xy * 0.5 + 0.5, 0.0, 1.0);
+	vec2 uv_max = clamp(ndc_max.xy * 0.5 + 0.5, 0.0, 1.0);
+	float box_depth = ndc_min.z * 0.5 + 0.5;
+
+	// the level where the rectangle spans at most 2x2 texels
+	vec2 size = (uv_max - uv_min) * vec2(textureSize(hiz, 0));
+	int level = clamp(int(ceil(log2(max(max(size.x, size.y), 1.0)))), 0, hiz_levels - 1);
+
+	ivec2 level_size = textureSize(hiz, level);
+	ivec2 p0 = min(ivec2(uv_min * vec2(level_size)), level_size - 1);
+	ivec2 p1 = min(ivec2(uv_max * vec2(level_size)), level_size - 1);
+	float occluder_depth = max(max(texelFetch(hiz, p0, level).r, texelFetch(hiz, ivec2(p1.x, p0.y), level).r),
+		max(texelFetch(hiz, ivec2(p0.x, p1.y), level).r, texelFetch(hiz, p1, level).r));
+
+	return box_depth <= occluder_depth;
+}
+
+void main()
+{
+	int i = int(gl_GlobalInvocationID.x);
+	if(i >= nb_commands)
+		return;
+
+	Bounds b = bounds[draws[i].material];
+	uint triangles = commands[i].count / 3;
+	if(visible(b.min_corner.xyz, b.max_corner.xyz))
+	{
+		atomicAdd(drawn_triangles, triangles);
+		atomicAdd(drawn_meshes, 1);
+	}
+	else
+	{
+		commands[i].instance_count = 0;
+		atomicAdd(occluded_triangles, triangles);
+		atomicAdd(occluded_meshes, 1);
+	}
+}
@@ -0,0 +1,41 @@
+#version 460 core
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (r32f, binding = 0) uniform writeonly image2D dst;
+uniform sampler2D src; // depth texture for level 0, the pyramid itself afterwards
+uniform int src_level;
+uniform int src_width;
+uniform int src_height;
+
+float fetch(ivec2 p)
+{
+	return texelFetch(src, min(p, ivec2(src_width - 1, src_height - 1)), src_level).r;
+}
+
+void main()
+{
+	ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 dst_size = imageSize(dst);
+	if(p.x >= dst_size.x || p.y >= dst_size.y)
+		return;
+
+	// farthest depth of the texels below, the last column/row also takes the leftover odd texels
+	ivec2 s = p * 2;
+	ivec2 s_end = s + 2;
+	if(p.x == dst_size.x - 1)
+		s_end.x = max(s_end.x, src_width);
+	if(p.y == dst_size.y - 1)
+		s_end.y = max(s_end.y, src_height);
+
+	float depth = 0.0;
+	for(int y = s.y; y < s_end.y; y++)
+	{
+		for(int x = s.x; x < s_end.x; x++)
+		{
+			depth = max(depth, fetch(ivec2(x, y)));
+		}
+	}
+
+	imageStore(dst, p, vec4(depth));
+}
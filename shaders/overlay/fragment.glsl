@@ -0,0 +1,17 @@
+#version 460 core
+
+uniform sampler2D img;
+
+in GS_OUT
+{
+	vec2 tCoords;
+} fs_in;
+
+out vec4 frag_color;
+
+void main()
+{
+	// glyph texels in red over a dark backdrop
+	float ink = texture(img, fs_in.tCoords).r;
+	frag_color = mix(vec4(0.05, 0.05, 0.05, 0.75), vec4(1.0, 0.25, 0.2, 1.0), ink);
+}
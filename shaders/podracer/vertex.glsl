@@ -1,4 +1,4 @@
-#version 330 core
+#version 460 core
 
 layout(location=0) in vec3 pos;
 layout(location=1) in vec3 normal;
@@ -18,6 +18,13 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 proj;
 
+// instanced parts read their own model matrix
+uniform int instanced;
+layout (std430, binding = 6) readonly buffer InstanceTransforms
+{
+	mat4 instance_models[];
+};
+
 uniform int shadowPass;
 uniform mat4 sunlightSpaceMatrix_env;
 uniform mat4 sunlightSpaceMatrix_pod;
@@ -27,25 +34,26 @@ uniform int process_pod_shadowPass;
 void main()
 {
 	mat4 norm_mat;
+	mat4 world = (instanced == 1) ? instance_models[gl_InstanceID] : model;
 	vs_out.texCoords = tex;
 	vs_out.shadows = shadowPass;
 	
-	norm_mat = inverse(transpose(model));
+	norm_mat = inverse(transpose(world));
 	vs_out.frag_norm = vec3(norm_mat * vec4(normal, 1.0));
-	vs_out.frag_pos = vec3(model * vec4(pos, 1.0));
-	vs_out.frag_pos_sunlightSpace_env = sunlightSpaceMatrix_env * model * vec4(pos, 1.0);
-	vs_out.frag_pos_sunlightSpace_pod = sunlightSpaceMatrix_pod * model * vec4(pos, 1.0);
+	vs_out.frag_pos = vec3(world * vec4(pos, 1.0));
+	vs_out.frag_pos_sunlightSpace_env = sunlightSpaceMatrix_env * world * vec4(pos, 1.0);
+	vs_out.frag_pos_sunlightSpace_pod = sunlightSpaceMatrix_pod * world * vec4(pos, 1.0);
 		
 	if(shadowPass == 0)
 	{
-		gl_Position = proj * view * model * vec4(pos, 1.0);
+		gl_Position = proj * view * world * vec4(pos, 1.0);
 	}
 	else if(shadowPass == 1)
 	{
         if(process_pod_shadowPass == 1)
-			gl_Position = sunlightSpaceMatrix_pod * model * vec4(pos, 1.0);
+			gl_Position = sunlightSpaceMatrix_pod * world * vec4(pos, 1.0);
         else
-			gl_Position = sunlightSpaceMatrix_env * model * vec4(pos, 1.0);
+			gl_Position = sunlightSpaceMatrix_env * world * vec4(pos, 1.0);
 	}
 }
 
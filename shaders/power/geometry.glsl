@@ -1,11 +1,13 @@
-#version 330 core
+#version 400 core
 
-layout (triangles) in;
-layout (triangle_strip, max_vertices = 3) out;
+#define NB_NODES 12
+
+layout (lines, invocations = 3) in;
+layout (triangle_strip, max_vertices = 24) out;
 
 in VS_OUT
 {
-	vec2 texCoords;
+	vec3 position;
 } gs_in[];
 
 out GS_OUT
@@ -13,20 +15,73 @@ out GS_OUT
 	vec2 texCoords;
 } gs_out;
 
-void main()
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 proj;
+
+uniform int seed;
+uniform float thickness;
+uniform float jitter1;
+uniform float jitter2;
+
+uint hash(uint x)
 {
-	gl_Position = gl_in[0].gl_Position;
-	gs_out.texCoords = gs_in[0].texCoords;
-	EmitVertex();
-	
-	gl_Position = gl_in[1].gl_Position;
-	gs_out.texCoords = gs_in[1].texCoords;
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+// [0, 1)
+float random(uint x)
+{
+	return float(hash(x) & 0x00ffffffu) / 16777216.0;
+}
+
+void emit_node(vec3 pos, mat4 mvp)
+{
+	gl_Position = mvp * vec4(pos, 1.0);
+	gs_out.texCoords = vec2(0.0, 0.0);
 	EmitVertex();
-	
-	gl_Position = gl_in[2].gl_Position;
-	gs_out.texCoords = gs_in[2].texCoords;
+
+	gl_Position = mvp * vec4(pos + vec3(0.0, thickness, 0.0), 1.0);
+	gs_out.texCoords = vec2(0.0, 1.0);
 	EmitVertex();
+}
+
+void main()
+{
+	mat4 mvp = proj * view * model;
+	vec3 start = gs_in[0].position;
+	vec3 end = gs_in[1].position;
+	float diff_x = end.x - start.x;
+
+	// one arc per invocation, the last one is wilder
+	float jitter = (gl_InvocationID == 2) ? jitter2 : jitter1;
+	uint key = hash(uint(seed) * 2654435761u + uint(gl_InvocationID) * 97u);
+
+	// sorted offsets along x from cumulated random gaps
+	float gaps[NB_NODES - 1];
+	float total = 0.0;
+	for(int i = 0; i < NB_NODES - 1; i++)
+	{
+		gaps[i] = 0.05 + random(key + uint(i));
+		total += gaps[i];
+	}
+
+	emit_node(start, mvp);
+	float offset = 0.0;
+	for(int i = 1; i < NB_NODES - 1; i++)
+	{
+		offset += gaps[i - 1];
+		float t = 0.01 + 0.98 * (offset / total);
+		float rand_y = (random(key + uint(32 + 2 * i)) * 2.0 - 1.0) * jitter;
+		float rand_z = (random(key + uint(33 + 2 * i)) * 2.0 - 1.0) * jitter;
+		emit_node(start + vec3(t * diff_x, rand_y, rand_z), mvp);
+	}
+	emit_node(end, mvp);
 
 	EndPrimitive();
 }
-
@@ -1,21 +1,14 @@
-#version 330 core
+#version 400 core
 
 layout (location = 0) in vec3 pos;
-layout (location = 1) in vec2 texCoords;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
 
 out VS_OUT
 {
-	vec2 texCoords;
+	vec3 position;
 } vs_out;
 
 void main()
 {
-	gl_Position = proj * view * model * vec4(pos, 1.0);
-
-	vs_out.texCoords = texCoords;
+	// connector endpoint in model space, the geometry shader builds the bolts
+	vs_out.position = pos;
 }
-
@@ -0,0 +1,75 @@
+#version 430 core
+
+layout (local_size_x = 64) in;
+
+struct Particle
+{
+	vec4 position; // xyz position, w lifeTime
+	vec4 direction;
+};
+
+layout (std430, binding = 0) buffer Particles
+{
+	Particle particles[];
+};
+
+uniform int capacity;
+uniform int emitStart;
+uniform int emitCount;
+uniform int liveCount;
+uniform int seed;
+uniform float delta;
+uniform float velocity;
+uniform float dissolve;
+uniform vec3 s1;
+uniform vec3 s2;
+uniform vec3 s3;
+uniform vec3 direction;
+
+uint hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+float jitter(uint x)
+{
+	return float(hash(x) & 0x00ffffffu) / 16777216.0 * 0.25;
+}
+
+void main()
+{
+	// one invocation per particle of the live window, newest first from emitStart
+	int offset = int(gl_GlobalInvocationID.x);
+	if(offset >= liveCount)
+		return;
+	int i = (emitStart + offset) % capacity;
+
+	// emission, new particles are the first emitCount of the window
+	if(offset < emitCount)
+	{
+		int source = offset % 3;
+		vec3 pos = (source == 0) ? s1 : ((source == 1) ? s2 : s3);
+		particles[i].position = vec4(pos, 0.0);
+		particles[i].direction = vec4(direction, 0.0);
+		return;
+	}
+
+	// integration
+	vec4 p = particles[i].position;
+	if(p.w >= dissolve)
+		return;
+
+	vec3 dir = particles[i].direction.xyz;
+	float ratio = delta * 60.0;
+	uint key = hash(uint(i) * 3u + uint(seed) * 2654435761u);
+	vec3 j = vec3(jitter(key), jitter(key + 1u), jitter(key + 2u));
+	p.xyz += velocity * ratio * dir;
+	p.xyz += ratio * j * dir;
+	p.w += delta;
+	particles[i].position = p;
+}
@@ -19,6 +19,8 @@ out GS_OUT
 void main()
 {
 	float deathTimer = 0.5f;
+	if(gs_in[0].lifeTime >= deathTimer)
+		return;
 	gs_out.lifeTime = gs_in[0].lifeTime;
 
 	// compute percentage texture size increase
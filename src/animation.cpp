@@ -6,62 +6,242 @@
 
 #include "animation.hpp"
 
-Keyframe::Keyframe(int p_frame)
+// out = a * b on column major matrices, out may alias a or b
+static inline void mat4_mul(const glm::mat4 & a, const glm::mat4 & b, glm::mat4 & out)
 {
-	frame = p_frame;
+#if defined(__SSE__)
+	const float* pa = glm::value_ptr(a);
+	const float* pb = glm::value_ptr(b);
+	__m128 a0 = _mm_loadu_ps(pa);
+	__m128 a1 = _mm_loadu_ps(pa + 4);
+	__m128 a2 = _mm_loadu_ps(pa + 8);
+	__m128 a3 = _mm_loadu_ps(pa + 12);
+
+	__m128 col[4];
+	for(int c = 0; c < 4; c++)
+	{
+		const float* bc = pb + 4 * c;
+		__m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+		r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+		r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+		r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+		col[c] = r;
+	}
+
+	float* po = glm::value_ptr(out);
+	for(int c = 0; c < 4; c++)
+		_mm_storeu_ps(po + 4 * c, col[c]);
+#else
+	out = a * b;
+#endif
+}
+
+// T * R * S written straight into the matrix columns
+static inline void compose_trs(const glm::vec3 & t, const glm::quat & r, const glm::vec3 & s, glm::mat4 & out)
+{
+	glm::mat3 rot = glm::mat3_cast(r);
+	out[0] = glm::vec4(rot[0] * s.x, 0.0f);
+	out[1] = glm::vec4(rot[1] * s.y, 0.0f);
+	out[2] = glm::vec4(rot[2] * s.z, 0.0f);
+	out[3] = glm::vec4(t, 1.0f);
+}
+
+Animation::Animation(std::string p_name, double p_duration, double p_ticks_per_second) :
+	name(p_name),
+	duration(p_duration),
+	ticks_per_second(p_ticks_per_second)
+{}
+
+std::string Animation::get_name() const
+{
+	return name;
 }
 
-Keyframe::~Keyframe()
+double Animation::get_duration() const
 {
-	int joint_pose_count = joint_pose_list.size();
-	for(int i = 0; i < joint_pose_count; i++)
+	return duration;
+}
+
+double Animation::get_ticks_per_second() const
+{
+	return ticks_per_second;
+}
+
+int Animation::get_nb_tracks() const
+{
+	return tracks.size();
+}
+
+void Animation::add_track(int joint, const std::vector<float> & key_times, const std::vector<glm::vec3> & key_translations, const std::vector<glm::quat> & key_rotations, const std::vector<glm::vec3> & key_scales)
+{
+	Track t;
+	t.joint = joint;
+	t.first_key = times.size();
+	t.nb_keys = key_times.size();
+	tracks.push_back(t);
+
+	times.insert(times.end(), key_times.begin(), key_times.end());
+	translations.insert(translations.end(), key_translations.begin(), key_translations.end());
+	rotations.insert(rotations.end(), key_rotations.begin(), key_rotations.end());
+	scales.insert(scales.end(), key_scales.begin(), key_scales.end());
+}
+
+int Animation::find_key(const Track & track, float time, int & cursor) const
+{
+	const float* t = &times[track.first_key];
+	int last = track.nb_keys - 2;
+
+	// playback moves forward, so the previous key or the next one is almost always right
+	if(cursor <= last && t[cursor] <= time && time < t[cursor + 1])
+		return cursor;
+	if(cursor + 1 <= last && t[cursor + 1] <= time && time < t[cursor + 2])
+		return ++cursor;
+
+	// jumped (loop, seek) : binary search
+	int k = std::upper_bound(t, t + track.nb_keys, time) - t - 1;
+	cursor = std::max(0, std::min(k, last));
+	return cursor;
+}
+
+void Animation::sample(double time, std::vector<int> & cursors, std::vector<glm::mat4> & local_poses) const
+{
+	int nb_tracks = tracks.size();
+	cursors.resize(nb_tracks, 0);
+
+	for(int i = 0; i < nb_tracks; i++)
 	{
-		delete joint_pose_list.at(i);
+		const Track & track = tracks[i];
+		if(track.nb_keys == 0 || track.joint < 0 || track.joint >= static_cast<int>(local_poses.size()))
+			continue;
+
+		glm::vec3 translation;
+		glm::quat rotation;
+		glm::vec3 scale;
+
+		if(track.nb_keys == 1)
+		{
+			translation = translations[track.first_key];
+			rotation = rotations[track.first_key];
+			scale = scales[track.first_key];
+		}
+		else
+		{
+			int k = track.first_key + find_key(track, static_cast<float>(time), cursors[i]);
+			float span = times[k + 1] - times[k];
+			float f = (span > 0.0f) ? glm::clamp((static_cast<float>(time) - times[k]) / span, 0.0f, 1.0f) : 0.0f;
+
+			translation = glm::mix(translations[k], translations[k + 1], f);
+			rotation = glm::slerp(rotations[k], rotations[k + 1], f);
+			scale = glm::mix(scales[k], scales[k + 1], f);
+		}
+
+		compose_trs(translation, rotation, scale, local_poses[track.joint]);
 	}
 }
 
-int Keyframe::get_frame()
+Pose::Pose() :
+	current(nullptr),
+	UBO(0)
+{}
+
+Pose::~Pose()
 {
-	return frame;
+	if(UBO != 0)
+		glDeleteBuffers(1, &UBO);
 }
 
-void Keyframe::add_joint_pose(JointPose* jPose)
+void Pose::set_skeleton(const std::vector<int> & p_parents, const std::vector<glm::mat4> & p_offsets)
 {
-	joint_pose_list.push_back(jPose);
+	parents = p_parents;
+	offsets = p_offsets;
+	int nb_joints = std::min(static_cast<int>(parents.size()), MAX_JOINTS);
+	if(static_cast<int>(parents.size()) > MAX_JOINTS)
+		std::cerr << "skeleton has " << parents.size() << " joints, only " << MAX_JOINTS << " are skinned" << std::endl;
+	parents.resize(nb_joints);
+	offsets.resize(nb_joints, glm::mat4(1.0f));
+	globals.assign(nb_joints, glm::mat4(1.0f));
+
+	// rest pose from the offsets: global bind = inverse(offset), local = parent offset * global
+	bind_locals.resize(nb_joints);
+	for(int j = 0; j < nb_joints; j++)
+	{
+		glm::mat4 bind = glm::inverse(offsets[j]);
+		bind_locals[j] = (parents[j] < 0) ? bind : offsets[parents[j]] * bind;
+	}
+	locals = bind_locals;
+	palette.assign(nb_joints, glm::mat4(1.0f));
+	cursors.clear();
+	current = nullptr;
 }
 
-JointPose* Keyframe::get_joint_pose_by_name(const char* joint_name)
+void Pose::evaluate(const Animation* anim, double time)
 {
-	int joint_pose_count = joint_pose_list.size();
-	for(int i = 0; i < joint_pose_count; i++)
+	if(anim != current)
 	{
-		if(std::strcmp(joint_pose_list.at(i)->name.c_str(), joint_name) == 0)
-			return joint_pose_list.at(i);
+		cursors.clear();
+		current = anim;
+	}
+
+	// joints without a track keep their rest pose
+	std::copy(bind_locals.begin(), bind_locals.end(), locals.begin());
+	if(anim != nullptr)
+	{
+		double duration = anim->get_duration();
+		if(duration > 0.0)
+		{
+			time = std::fmod(time, duration);
+			if(time < 0.0)
+				time += duration;
+		}
+		anim->sample(time, cursors, locals);
+	}
+
+	// parents are stored before their children, a single forward pass is enough
+	int nb_joints = parents.size();
+	for(int j = 0; j < nb_joints; j++)
+	{
+		if(parents[j] < 0)
+			globals[j] = locals[j];
+		else
+			mat4_mul(globals[parents[j]], locals[j], globals[j]);
+		mat4_mul(globals[j], offsets[j], palette[j]);
 	}
-	return nullptr;
 }
 
-std::vector<JointPose*>& Keyframe::get_joint_pose_list()
+void Pose::evaluate_batch(std::vector<PoseJob> & jobs)
 {
-	return joint_pose_list;
+	// every pose owns its buffers, objects can be evaluated independently
+	int nb_jobs = jobs.size();
+	#pragma omp parallel for schedule(dynamic) if(nb_jobs > 1)
+	for(int i = 0; i < nb_jobs; i++)
+	{
+		jobs[i].pose->evaluate(jobs[i].anim, jobs[i].time);
+	}
 }
 
-Animation::Animation(std::string p_name, double p_duration) :
-	name(p_name),
-	duration(p_duration)
-{}
-
-std::string Animation::get_name() const
+void Pose::upload()
 {
-	return name;
+	if(UBO == 0)
+	{
+		glGenBuffers(1, &UBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glBufferData(GL_UNIFORM_BUFFER, MAX_JOINTS * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+	}
+	else
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+
+	if(!palette.empty())
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, palette.size() * sizeof(glm::mat4), palette.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, JOINT_PALETTE_BINDING, UBO);
 }
 
-void Animation::add_keyframe(Keyframe* key)
+int Pose::get_nb_joints() const
 {
-	keys.push_back(key);
+	return parents.size();
 }
 
-std::vector<Keyframe*>& Animation::get_keyframes()
+std::vector<glm::mat4> const& Pose::get_palette() const
 {
-	return keys;
+	return palette;
 }
@@ -74,6 +74,7 @@ void Audio::load_sound(std::string file_path)
 
 	// append it to the buffers array
 	sounds.push_back(sound_buffer);
+	durations.push_back((sample_rate > 0) ? static_cast<float>(fileInfos.frames) / static_cast<float>(sample_rate) : 0.0f);
 }
 
 // ##################################################
@@ -96,6 +97,16 @@ void Source::set_volume(int volume)
 	alSourcef(source_id, AL_GAIN, static_cast<float>(volume) / 100.0f);
 }
 
+void Source::set_gain(float gain)
+{
+	alSourcef(source_id, AL_GAIN, gain);
+}
+
+void Source::set_pitch(float pitch)
+{
+	alSourcef(source_id, AL_PITCH, pitch);
+}
+
 void Source::set_looping(bool loop)
 {
 	if(loop)
@@ -109,9 +120,28 @@ void Source::stop_sound()
 	alSourceStop(source_id);
 }
 
-void Source::play_sound(ALuint sound_buffer)
+void Source::set_spatial(bool spatial)
+{
+	// non spatial sources stay on the listener, only mono buffers get positioned by OpenAL
+	alSourcei(source_id, AL_SOURCE_RELATIVE, spatial ? AL_FALSE : AL_TRUE);
+	alSourcef(source_id, AL_REFERENCE_DISTANCE, AUDIO_REFERENCE_DISTANCE);
+	alSourcef(source_id, AL_MAX_DISTANCE, AUDIO_MAX_DISTANCE);
+	alSourcef(source_id, AL_ROLLOFF_FACTOR, spatial ? AUDIO_ROLLOFF : 0.0f);
+	if(!spatial)
+		set_position(glm::vec3(0.0f), glm::vec3(0.0f));
+}
+
+void Source::set_position(glm::vec3 position, glm::vec3 velocity)
+{
+	alSource3f(source_id, AL_POSITION, position.x, position.y, position.z);
+	alSource3f(source_id, AL_VELOCITY, velocity.x, velocity.y, velocity.z);
+}
+
+void Source::play_sound(ALuint sound_buffer, float offset)
 {
 	alSourcei(source_id, AL_BUFFER, sound_buffer);
+	if(offset > 0.0f)
+		alSourcef(source_id, AL_SEC_OFFSET, offset);
 	alSourcePlay(source_id);
 }
 
@@ -128,3 +158,752 @@ float Source::get_elapsed_time() const
 	alGetSourcef(source_id, AL_SEC_OFFSET, &elapsed_time);
 	return static_cast<float>(elapsed_time);
 }
+
+// ##################################################
+// ##################################################
+// ##################################################
+
+StreamingSource::StreamingSource(std::string file_path) :
+	file(nullptr),
+	format(AL_FORMAT_MONO16),
+	queued_frames(0),
+	running(true),
+	playing(false),
+	looping(false),
+	start_request(false)
+{
+	alGenSources(1, &source_id);
+	alGenBuffers(STREAM_NB_BUFFERS, buffers);
+
+	file = sf_open(file_path.c_str(), SFM_READ, &file_infos);
+	if(file == nullptr)
+	{
+		std::cerr << "Error: failed reading sound file " << file_path << "." << std::endl;
+		return;
+	}
+
+	// query file format
+	if(file_infos.channels == 1)
+		format = AL_FORMAT_MONO16;
+	else if(file_infos.channels == 2)
+		format = AL_FORMAT_STEREO16;
+	else
+		std::cerr << "Error: unknown sound file format." << std::endl;
+
+	samples.resize(STREAM_BUFFER_FRAMES * file_infos.channels);
+	worker = std::thread(&StreamingSource::stream, this);
+}
+
+StreamingSource::~StreamingSource()
+{
+	running = false;
+	if(worker.joinable())
+		worker.join();
+
+	alSourceStop(source_id);
+	alSourcei(source_id, AL_BUFFER, 0);
+	alDeleteSources(1, &source_id);
+	alDeleteBuffers(STREAM_NB_BUFFERS, buffers);
+	if(file != nullptr)
+		sf_close(file);
+}
+
+void StreamingSource::set_volume(int volume)
+{
+	alSourcef(source_id, AL_GAIN, static_cast<float>(volume) / 100.0f);
+}
+
+void StreamingSource::set_gain(float gain)
+{
+	alSourcef(source_id, AL_GAIN, gain);
+}
+
+void StreamingSource::set_pitch(float pitch)
+{
+	alSourcef(source_id, AL_PITCH, pitch);
+}
+
+void StreamingSource::set_spatial(bool spatial)
+{
+	alSourcei(source_id, AL_SOURCE_RELATIVE, spatial ? AL_FALSE : AL_TRUE);
+	alSourcef(source_id, AL_REFERENCE_DISTANCE, AUDIO_REFERENCE_DISTANCE);
+	alSourcef(source_id, AL_MAX_DISTANCE, AUDIO_MAX_DISTANCE);
+	alSourcef(source_id, AL_ROLLOFF_FACTOR, spatial ? AUDIO_ROLLOFF : 0.0f);
+	if(!spatial)
+		set_position(glm::vec3(0.0f), glm::vec3(0.0f));
+}
+
+void StreamingSource::set_position(glm::vec3 position, glm::vec3 velocity)
+{
+	alSource3f(source_id, AL_POSITION, position.x, position.y, position.z);
+	alSource3f(source_id, AL_VELOCITY, velocity.x, velocity.y, velocity.z);
+}
+
+void StreamingSource::set_looping(bool loop)
+{
+	// AL_LOOPING would loop over the queued buffers only, the decoder rewinds the file instead
+	looping = loop;
+}
+
+void StreamingSource::stop_sound()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	start_request = false;
+	playing = false;
+	alSourceStop(source_id);
+	alSourcei(source_id, AL_BUFFER, 0);
+}
+
+void StreamingSource::play_sound()
+{
+	// the worker rewinds, decodes the first buffers and starts the source
+	// both flags change together, the worker must never see one without the other
+	std::lock_guard<std::mutex> guard(lock);
+	playing = true;
+	start_request = true;
+}
+
+bool StreamingSource::is_playing() const
+{
+	return playing;
+}
+
+float StreamingSource::get_elapsed_time() const
+{
+	if(file == nullptr || file_infos.samplerate == 0)
+		return 0.0f;
+
+	std::lock_guard<std::mutex> guard(lock);
+	ALint offset = 0;
+	alGetSourcei(source_id, AL_SAMPLE_OFFSET, &offset);
+	sf_count_t frames = (queued_frames + offset) % std::max<sf_count_t>(file_infos.frames, 1);
+	return static_cast<float>(frames) / static_cast<float>(file_infos.samplerate);
+}
+
+bool StreamingSource::fill_buffer(ALuint buffer)
+{
+	sf_count_t frames = sf_readf_short(file, samples.data(), STREAM_BUFFER_FRAMES);
+	if(frames < STREAM_BUFFER_FRAMES && looping)
+	{
+		sf_seek(file, 0, SEEK_SET);
+		frames += sf_readf_short(file, samples.data() + frames * file_infos.channels, STREAM_BUFFER_FRAMES - frames);
+	}
+	if(frames <= 0)
+		return false;
+
+	ALsizei size = static_cast<ALsizei>(frames * file_infos.channels * sizeof(ALshort));
+	alBufferData(buffer, format, samples.data(), size, file_infos.samplerate);
+	alSourceQueueBuffers(source_id, 1, &buffer);
+	return true;
+}
+
+void StreamingSource::restart()
+{
+	alSourceStop(source_id);
+	alSourcei(source_id, AL_BUFFER, 0);
+	sf_seek(file, 0, SEEK_SET);
+	queued_frames = 0;
+
+	for(int i = 0; i < STREAM_NB_BUFFERS; i++)
+	{
+		if(!fill_buffer(buffers[i]))
+			break;
+	}
+	alSourcePlay(source_id);
+
+	// the refill loop only runs while playing, set it here too so a restarted source is always refilled
+	ALint queued = 0;
+	alGetSourcei(source_id, AL_BUFFERS_QUEUED, &queued);
+	playing = queued > 0;
+}
+
+void StreamingSource::stream()
+{
+	while(running)
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			if(start_request)
+			{
+				start_request = false;
+				restart();
+			}
+			else if(!playing)
+			{
+				// a source left running with nothing refilling it would die after STREAM_NB_BUFFERS buffers
+				ALint state = AL_STOPPED;
+				alGetSourcei(source_id, AL_SOURCE_STATE, &state);
+				assert(state != AL_PLAYING);
+			}
+			else if(playing)
+			{
+				// recycle the buffers the source is done with
+				ALint processed = 0;
+				alGetSourcei(source_id, AL_BUFFERS_PROCESSED, &processed);
+				while(processed-- > 0)
+				{
+					ALuint buffer;
+					ALint size = 0;
+					alSourceUnqueueBuffers(source_id, 1, &buffer);
+					alGetBufferi(buffer, AL_SIZE, &size);
+					queued_frames += size / (file_infos.channels * sizeof(ALshort));
+					fill_buffer(buffer);
+				}
+
+				ALint queued = 0;
+				ALint state = AL_STOPPED;
+				alGetSourcei(source_id, AL_BUFFERS_QUEUED, &queued);
+				alGetSourcei(source_id, AL_SOURCE_STATE, &state);
+				if(state != AL_PLAYING)
+				{
+					// end of file, or the decoder fell behind and the source starved
+					if(queued > 0)
+						alSourcePlay(source_id);
+					else
+						playing = false;
+				}
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+// ##################################################
+// ##################################################
+// ##################################################
+
+AudioSystem::AudioSystem() :
+	nb_streams(0),
+	listener_position(0.0f),
+	device(nullptr),
+	running(false),
+	nb_real_voices(0),
+	bench_total(0)
+{
+	for(int i = 0; i <= AUDIO_MAX_SOURCES * 4; i++)
+	{
+		bench_time[i] = 0.0;
+		bench_ticks[i] = 0;
+	}
+}
+
+AudioSystem::~AudioSystem()
+{
+	running = false;
+	if(mixer.joinable())
+		mixer.join();
+
+	int nb_voices = voices.size();
+	for(int i = 0; i < nb_voices; i++)
+	{
+		delete voices.at(i);
+	}
+}
+
+int AudioSystem::add_sound(const std::string & file_path)
+{
+	sound_files.push_back(file_path);
+	return sound_files.size() - 1;
+}
+
+int AudioSystem::add_voice(int volume, bool looping, const std::string & stream_path)
+{
+	Voice* v = new Voice();
+	v->source = nullptr;
+	v->stream = nullptr;
+	v->stream_path = stream_path;
+	v->sound = -1;
+	v->volume = volume;
+	v->looping = looping;
+	v->spatial = false;
+	v->priority = 1.0f;
+	v->position = glm::vec3(0.0f);
+	v->velocity = glm::vec3(0.0f);
+	v->started = false;
+	v->virtual_time = 0.0f;
+	v->audibility = 0.0f;
+	v->audible = false;
+	v->gain = 1.0f;
+	v->gain_target = 1.0f;
+	v->gain_rate = 0.0f;
+	v->stop_after_fade = false;
+	v->pitch = 1.0f;
+	v->pitch_target = 1.0f;
+	v->pitch_rate = 0.0f;
+	v->status = 0;
+	v->elapsed_time = 0.0f;
+
+	voices.push_back(v);
+	return voices.size() - 1;
+}
+
+int AudioSystem::add_emitter(int volume, bool looping, float priority, const std::string & stream_path)
+{
+	int index = add_voice(volume, looping, stream_path);
+	voices.at(index)->spatial = true;
+	voices.at(index)->priority = priority;
+	return index;
+}
+
+void AudioSystem::start()
+{
+	// sounds and voices are fixed from now on, the mixer thread reads them without locking
+	running = true;
+	mixer = std::thread(&AudioSystem::run, this);
+}
+
+void AudioSystem::push(const AudioCommand & cmd)
+{
+	// the mixer drains the queue every few milliseconds, being full is only transient
+	while(!commands.push(cmd))
+		std::this_thread::yield();
+}
+
+void AudioSystem::play(int voice, int sound)
+{
+	Voice* v = voices.at(voice);
+	int s = v->status;
+	while(!v->status.compare_exchange_weak(s, (s | 1) + 2));
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_PLAY;
+	cmd.voice = voice;
+	cmd.target = sound;
+	push(cmd);
+}
+
+void AudioSystem::stop(int voice)
+{
+	Voice* v = voices.at(voice);
+	int s = v->status;
+	while(!v->status.compare_exchange_weak(s, (s & ~1) + 2));
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_STOP;
+	cmd.voice = voice;
+	push(cmd);
+}
+
+void AudioSystem::set_volume(int voice, int volume)
+{
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_VOLUME;
+	cmd.voice = voice;
+	cmd.value = static_cast<float>(volume);
+	push(cmd);
+}
+
+void AudioSystem::crossfade(int from, int to, float duration)
+{
+	// to = -1 only fades out
+	if(to >= 0)
+	{
+		Voice* v = voices.at(to);
+		int s = v->status;
+		while(!v->status.compare_exchange_weak(s, (s | 1) + 2));
+	}
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_CROSSFADE;
+	cmd.voice = from;
+	cmd.target = to;
+	cmd.duration = duration;
+	push(cmd);
+}
+
+void AudioSystem::ramp_gain(int voice, float gain, float duration)
+{
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_GAIN_RAMP;
+	cmd.voice = voice;
+	cmd.value = gain;
+	cmd.duration = duration;
+	push(cmd);
+}
+
+void AudioSystem::ramp_pitch(int voice, float pitch, float duration)
+{
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_PITCH_RAMP;
+	cmd.voice = voice;
+	cmd.value = pitch;
+	cmd.duration = duration;
+	push(cmd);
+}
+
+void AudioSystem::move(int voice, glm::vec3 position, glm::vec3 velocity)
+{
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_MOVE;
+	cmd.voice = voice;
+	cmd.position = position;
+	cmd.velocity = velocity;
+	push(cmd);
+}
+
+void AudioSystem::set_listener(glm::vec3 position, glm::vec3 velocity, glm::vec3 forward, glm::vec3 up)
+{
+	AudioCommand cmd = {};
+	cmd.type = AUDIO_LISTENER;
+	cmd.voice = -1;
+	cmd.position = position;
+	cmd.velocity = velocity;
+	cmd.forward = forward;
+	cmd.up = up;
+	push(cmd);
+}
+
+bool AudioSystem::is_playing(int voice) const
+{
+	return (voices.at(voice)->status & 1) != 0;
+}
+
+float AudioSystem::get_elapsed_time(int voice) const
+{
+	return voices.at(voice)->elapsed_time;
+}
+
+int AudioSystem::get_nb_real_voices() const
+{
+	return nb_real_voices;
+}
+
+void AudioSystem::run()
+{
+	// every OpenAL call happens on this thread (and the streaming decoders)
+	device = new Audio();
+	alDistanceModel(AL_INVERSE_DISTANCE_CLAMPED);
+	alDopplerFactor(1.0f);
+	alSpeedOfSound(AUDIO_SPEED_OF_SOUND);
+
+	int nb_sounds = sound_files.size();
+	for(int i = 0; i < nb_sounds; i++)
+	{
+		device->load_sound(sound_files.at(i));
+	}
+
+	// streams keep a source each, buffered voices share what is left
+	int nb_voices = voices.size();
+	for(int i = 0; i < nb_voices; i++)
+	{
+		Voice* v = voices.at(i);
+		if(!v->stream_path.empty())
+		{
+			v->stream = new StreamingSource(v->stream_path);
+			v->stream->set_looping(v->looping);
+			v->stream->set_spatial(v->spatial);
+			v->stream->set_volume(v->volume);
+			nb_streams++;
+		}
+	}
+	int pool_size = std::max(0, AUDIO_MAX_SOURCES - nb_streams);
+	for(int i = 0; i < pool_size; i++)
+	{
+		free_sources.push_back(new Source());
+	}
+	candidates.reserve(nb_voices);
+
+	std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+	while(running)
+	{
+		AudioCommand cmd;
+		while(commands.pop(cmd))
+		{
+			execute(cmd);
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		float delta = std::chrono::duration<float>(now - last).count();
+		last = now;
+		update_voices(delta);
+
+#if AUDIO_BENCHMARK == 1
+		int nb_active = 0;
+		for(int i = 0; i < nb_voices; i++)
+		{
+			if(voices.at(i)->started)
+				nb_active++;
+		}
+		nb_active = std::min(nb_active, AUDIO_MAX_SOURCES * 4);
+		bench_time[nb_active] += std::chrono::duration<double>(std::chrono::steady_clock::now() - now).count();
+		bench_ticks[nb_active]++;
+		bench_total++;
+		if(bench_total % 2000 == 0)
+		{
+			std::cout << "AUDIO BENCHMARK (" << bench_total << " mixer ticks, " << nb_real_voices << " real voices)" << std::endl;
+			for(int i = 0; i <= AUDIO_MAX_SOURCES * 4; i++)
+			{
+				if(bench_ticks[i] > 0)
+					std::cout << "	" << i << " active emitters = " << (bench_time[i] / bench_ticks[i]) * 1000000.0 << " us/tick" << std::endl;
+			}
+		}
+#endif
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_TICK));
+	}
+
+	for(int i = 0; i < nb_voices; i++)
+	{
+		delete voices.at(i)->source;
+		delete voices.at(i)->stream;
+	}
+	int nb_free = free_sources.size();
+	for(int i = 0; i < nb_free; i++)
+	{
+		delete free_sources.at(i);
+	}
+	delete device;
+}
+
+static float ramp_rate(float from, float to, float duration)
+{
+	if(duration <= 0.0f)
+		return 0.0f; // immediate
+	return std::abs(to - from) / duration;
+}
+
+static float step_toward(float value, float target, float rate, float delta)
+{
+	if(rate <= 0.0f)
+		return target;
+	float step = rate * delta;
+	if(std::abs(target - value) <= step)
+		return target;
+	return (target > value) ? value + step : value - step;
+}
+
+void AudioSystem::start_voice(Voice* v)
+{
+	v->started = true;
+	v->virtual_time = 0.0f;
+	v->stop_after_fade = false;
+	if(v->stream != nullptr)
+		v->stream->play_sound();
+	else if(v->source != nullptr && v->sound >= 0 && v->sound < static_cast<int>(device->sounds.size()))
+		v->source->play_sound(device->sounds.at(v->sound));
+	// a virtual voice gets a source during the next selection if it is audible enough
+}
+
+void AudioSystem::stop_voice(Voice* v)
+{
+	v->started = false;
+	v->stop_after_fade = false;
+	if(v->stream != nullptr)
+		v->stream->stop_sound();
+	if(v->source != nullptr)
+	{
+		v->source->stop_sound();
+		free_sources.push_back(v->source);
+		v->source = nullptr;
+	}
+}
+
+void AudioSystem::execute(const AudioCommand & cmd)
+{
+	if(cmd.type == AUDIO_LISTENER)
+	{
+		ALfloat orientation[6] = {cmd.forward.x, cmd.forward.y, cmd.forward.z, cmd.up.x, cmd.up.y, cmd.up.z};
+		alListener3f(AL_POSITION, cmd.position.x, cmd.position.y, cmd.position.z);
+		alListener3f(AL_VELOCITY, cmd.velocity.x, cmd.velocity.y, cmd.velocity.z);
+		alListenerfv(AL_ORIENTATION, orientation);
+		listener_position = cmd.position;
+		return;
+	}
+
+	Voice* v = voices.at(cmd.voice);
+
+	switch(cmd.type)
+	{
+		case AUDIO_PLAY:
+			v->status -= 2;
+			v->gain = 1.0f;
+			v->gain_target = 1.0f;
+			if(cmd.target >= 0)
+				v->sound = cmd.target;
+			start_voice(v);
+			break;
+
+		case AUDIO_STOP:
+			v->status -= 2;
+			stop_voice(v);
+			break;
+
+		case AUDIO_VOLUME:
+			v->volume = static_cast<int>(cmd.value);
+			break;
+
+		case AUDIO_CROSSFADE:
+			v->gain_target = 0.0f;
+			v->gain_rate = ramp_rate(v->gain, 0.0f, cmd.duration);
+			v->stop_after_fade = true;
+			if(cmd.target >= 0)
+			{
+				Voice* in = voices.at(cmd.target);
+				in->status -= 2;
+				in->gain = 0.0f;
+				in->gain_target = 1.0f;
+				in->gain_rate = ramp_rate(0.0f, 1.0f, cmd.duration);
+				start_voice(in);
+			}
+			break;
+
+		case AUDIO_GAIN_RAMP:
+			v->gain_target = cmd.value;
+			v->gain_rate = ramp_rate(v->gain, cmd.value, cmd.duration);
+			v->stop_after_fade = false;
+			break;
+
+		case AUDIO_PITCH_RAMP:
+			v->pitch_target = cmd.value;
+			v->pitch_rate = ramp_rate(v->pitch, cmd.value, cmd.duration);
+			break;
+
+		case AUDIO_MOVE:
+			v->position = cmd.position;
+			v->velocity = cmd.velocity;
+			break;
+
+		default:
+			break;
+	}
+}
+
+float AudioSystem::attenuation(const Voice* v) const
+{
+	// same curve as AL_INVERSE_DISTANCE_CLAMPED
+	if(!v->spatial)
+		return 1.0f;
+	float d = glm::clamp(glm::length(v->position - listener_position), AUDIO_REFERENCE_DISTANCE, AUDIO_MAX_DISTANCE);
+	return AUDIO_REFERENCE_DISTANCE / (AUDIO_REFERENCE_DISTANCE + AUDIO_ROLLOFF * (d - AUDIO_REFERENCE_DISTANCE));
+}
+
+void AudioSystem::select_real_voices()
+{
+	// the most audible buffered voices get the hardware sources, the others go on virtually
+	candidates.clear();
+	int nb_voices = voices.size();
+	for(int i = 0; i < nb_voices; i++)
+	{
+		Voice* v = voices.at(i);
+		v->audible = false;
+		if(v->stream == nullptr && v->started && v->audibility >= AUDIO_MIN_AUDIBILITY)
+			candidates.push_back(v);
+	}
+
+	int pool_size = std::max(0, AUDIO_MAX_SOURCES - nb_streams);
+	int nb_candidates = candidates.size();
+	if(nb_candidates > pool_size)
+	{
+		std::nth_element(candidates.begin(), candidates.begin() + pool_size, candidates.end(), [](const Voice* a, const Voice* b){
+			return a->audibility > b->audibility;
+		});
+		nb_candidates = pool_size;
+	}
+	for(int i = 0; i < nb_candidates; i++)
+	{
+		candidates[i]->audible = true;
+	}
+
+	// release first so the sources can be handed over in the same tick
+	for(int i = 0; i < nb_voices; i++)
+	{
+		Voice* v = voices.at(i);
+		if(v->source != nullptr && !v->audible)
+		{
+			v->virtual_time = v->source->get_elapsed_time();
+			v->source->stop_sound();
+			free_sources.push_back(v->source);
+			v->source = nullptr;
+		}
+	}
+	for(int i = 0; i < nb_voices; i++)
+	{
+		Voice* v = voices.at(i);
+		if(v->audible && v->source == nullptr && !free_sources.empty())
+		{
+			v->source = free_sources.back();
+			free_sources.pop_back();
+			v->source->set_looping(v->looping);
+			v->source->set_spatial(v->spatial);
+			v->source->set_position(v->position, v->velocity);
+			v->source->play_sound(device->sounds.at(v->sound), v->virtual_time);
+		}
+	}
+
+	nb_real_voices = nb_streams + pool_size - static_cast<int>(free_sources.size());
+}
+
+void AudioSystem::update_voices(float delta)
+{
+	int nb_voices = voices.size();
+	for(int i = 0; i < nb_voices; i++)
+	{
+		Voice* v = voices.at(i);
+
+		v->gain = step_toward(v->gain, v->gain_target, v->gain_rate, delta);
+		v->pitch = step_toward(v->pitch, v->pitch_target, v->pitch_rate, delta);
+		if(v->stop_after_fade && v->gain <= 0.0f)
+			stop_voice(v);
+
+		if(v->started)
+		{
+			if(v->stream != nullptr)
+			{
+				if(!v->stream->is_playing())
+					v->started = false;
+			}
+			else if(v->sound < 0 || v->sound >= static_cast<int>(device->durations.size()))
+				v->started = false;
+			else if(v->source != nullptr)
+			{
+				// reached its end on the hardware
+				if(!v->source->is_playing())
+					stop_voice(v);
+			}
+			else
+			{
+				// virtual : keep the playback position moving
+				float duration = device->durations.at(v->sound);
+				v->virtual_time += delta * v->pitch;
+				if(v->virtual_time >= duration)
+				{
+					if(v->looping && duration > 0.0f)
+						v->virtual_time = std::fmod(v->virtual_time, duration);
+					else
+						v->started = false;
+				}
+			}
+		}
+
+		v->audibility = v->started ? (static_cast<float>(v->volume) / 100.0f) * v->gain * attenuation(v) * v->priority : 0.0f;
+	}
+
+	select_real_voices();
+
+	for(int i = 0; i < nb_voices; i++)
+	{
+		Voice* v = voices.at(i);
+		float gain = static_cast<float>(v->volume) / 100.0f * v->gain;
+		if(v->stream != nullptr)
+		{
+			v->stream->set_gain(gain);
+			v->stream->set_pitch(v->pitch);
+			if(v->spatial)
+				v->stream->set_position(v->position, v->velocity);
+			v->elapsed_time = v->stream->get_elapsed_time();
+		}
+		else if(v->source != nullptr)
+		{
+			v->source->set_gain(gain);
+			v->source->set_pitch(v->pitch);
+			if(v->spatial)
+				v->source->set_position(v->position, v->velocity);
+			v->elapsed_time = v->source->get_elapsed_time();
+		}
+		else
+			v->elapsed_time = v->virtual_time;
+
+		// a play or stop still in the queue knows better than the mixer
+		int status = v->status;
+		if(status < 2)
+			v->status.compare_exchange_strong(status, v->started ? 1 : 0);
+	}
+}
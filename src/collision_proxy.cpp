@@ -0,0 +1,269 @@
+/**
+ * \file
+ * Less is more, as long as you don't fall through the floor
+ * \author Mathias Velo
+ */
+
+#include "collision_proxy.hpp"
+#include <LinearMath/btConvexHullComputer.h>
+
+struct ProxyCacheHeader
+{
+	unsigned int magic;
+	unsigned int checksum;
+	unsigned int type;
+	float max_error;
+	float hull_cell_size;
+};
+
+CollisionProxyBuilder::CollisionProxyBuilder(float p_max_error, float p_hull_cell_size) :
+	max_error(p_max_error),
+	hull_cell_size(p_hull_cell_size)
+{}
+
+void CollisionProxyBuilder::weld(const std::vector<Vertex> & vertices, const std::vector<int> & indices, std::vector<glm::vec3> & positions, std::vector<int> & welded)
+{
+	// OBJ exports split vertices along uv seams, collision only cares about positions
+	std::unordered_map<glm::vec3, int, PositionHash> unique;
+	std::vector<int> remap(vertices.size());
+	positions.clear();
+
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		auto it = unique.find(vertices[i].position);
+		if(it == unique.end())
+		{
+			remap[i] = positions.size();
+			unique[vertices[i].position] = positions.size();
+			positions.push_back(vertices[i].position);
+		}
+		else
+		{
+			remap[i] = it->second;
+		}
+	}
+
+	welded.clear();
+	welded.reserve(indices.size());
+	for(int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		int a = remap[indices[i]];
+		int b = remap[indices[i + 1]];
+		int c = remap[indices[i + 2]];
+		if(a == b || b == c || a == c)
+			continue;
+		welded.push_back(a);
+		welded.push_back(b);
+		welded.push_back(c);
+	}
+}
+
+void CollisionProxyBuilder::simplify(const std::vector<Vertex> & vertices, const std::vector<int> & indices, CollisionProxy & proxy)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<int> tris;
+	weld(vertices, indices, positions, tris);
+	int nb_tris_before = tris.size() / 3;
+
+	// positions are already welded, nothing is a seam and every pass may reach the error bound
+	std::vector<int> position_id(positions.size());
+	for(int i = 0; i < positions.size(); i++)
+		position_id[i] = i;
+	std::vector<bool> locked(positions.size(), false);
+	double max_cost = static_cast<double>(max_error) * static_cast<double>(max_error);
+	QuadricSimplifier simplifier;
+	for(int pass = 0; pass < PROXY_MAX_PASSES; pass++)
+	{
+		double pass_cost = 0.0;
+		if(simplifier.collapse_pass(positions, position_id, locked, tris, 0, max_cost, pass_cost) == 0)
+			break;
+	}
+
+	// compact vertices still referenced
+	std::vector<int> remap(positions.size(), -1);
+	proxy.type = PROXY_TRIANGLES;
+	proxy.positions.clear();
+	proxy.indices.clear();
+	proxy.hulls.clear();
+	for(int i = 0; i < tris.size(); i++)
+	{
+		if(remap[tris[i]] == -1)
+		{
+			remap[tris[i]] = proxy.positions.size();
+			proxy.positions.push_back(positions[tris[i]]);
+		}
+		proxy.indices.push_back(remap[tris[i]]);
+	}
+
+	std::cout << "	- COLLISION PROXY: " << nb_tris_before << " -> " << proxy.indices.size() / 3 << " triangles" << std::endl;
+}
+
+void CollisionProxyBuilder::decompose(const std::vector<Vertex> & vertices, const std::vector<int> & indices, CollisionProxy & proxy)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<int> tris;
+	weld(vertices, indices, positions, tris);
+
+	// cluster triangles in a regular grid, one convex hull per occupied cell
+	std::unordered_map<glm::vec3, std::vector<int>, PositionHash> cells;
+	for(int i = 0; i < tris.size(); i += 3)
+	{
+		glm::vec3 centroid = (positions[tris[i]] + positions[tris[i + 1]] + positions[tris[i + 2]]) / 3.0f;
+		glm::vec3 cell = glm::floor(centroid / hull_cell_size);
+		std::vector<int> & cell_vertices = cells[cell];
+		cell_vertices.push_back(tris[i]);
+		cell_vertices.push_back(tris[i + 1]);
+		cell_vertices.push_back(tris[i + 2]);
+	}
+
+	proxy.type = PROXY_HULLS;
+	proxy.positions.clear();
+	proxy.indices.clear();
+	proxy.hulls.clear();
+	for(auto it = cells.begin(); it != cells.end(); ++it)
+	{
+		std::vector<int> & ids = it->second;
+		std::sort(ids.begin(), ids.end());
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+		if(ids.size() < 4)
+			continue;
+
+		std::vector<float> coords;
+		coords.reserve(ids.size() * 3);
+		for(int i = 0; i < ids.size(); i++)
+		{
+			coords.push_back(positions[ids[i]].x);
+			coords.push_back(positions[ids[i]].y);
+			coords.push_back(positions[ids[i]].z);
+		}
+
+		// keep only the hull vertices
+		btConvexHullComputer hull_computer;
+		hull_computer.compute(coords.data(), 3 * sizeof(float), ids.size(), 0.0f, 0.0f);
+		if(hull_computer.vertices.size() < 4)
+			continue;
+
+		ProxyHull hull;
+		for(int i = 0; i < hull_computer.vertices.size(); i++)
+		{
+			const btVector3 & p = hull_computer.vertices[i];
+			hull.points.push_back(glm::vec3(p.x(), p.y(), p.z()));
+		}
+		proxy.hulls.push_back(hull);
+	}
+
+	std::cout << "	- COLLISION PROXY: " << tris.size() / 3 << " triangles -> " << proxy.hulls.size() << " convex hulls" << std::endl;
+}
+
+bool CollisionProxyBuilder::load(const std::string & path, unsigned int checksum, PROXY_TYPE type, CollisionProxy & proxy)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		return false;
+	unsigned long long remaining = file.tellg();
+	file.seekg(0, file.beg);
+
+	// a proxy of the other kind is stale too, the grandstand keywords may have changed
+	ProxyCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(ProxyCacheHeader));
+	if(!file || header.magic != PROXY_CACHE_MAGIC || header.checksum != checksum || header.type != type || header.max_error != max_error || header.hull_cell_size != hull_cell_size)
+		return false;
+	remaining -= sizeof(ProxyCacheHeader);
+
+	// every count is checked against what is left in the file before anything is allocated
+	auto read_count = [&file, &remaining](unsigned long long element_size, unsigned int & count)
+	{
+		if(remaining < sizeof(unsigned int))
+			return false;
+		file.read(reinterpret_cast<char*>(&count), sizeof(unsigned int));
+		remaining -= sizeof(unsigned int);
+		if(!file || count * element_size > remaining)
+			return false;
+		remaining -= count * element_size;
+		return true;
+	};
+
+	CollisionProxy loaded;
+	loaded.type = type;
+	unsigned int count = 0;
+	if(type == PROXY_TRIANGLES)
+	{
+		if(!read_count(sizeof(glm::vec3), count))
+			return false;
+		loaded.positions.resize(count);
+		file.read(reinterpret_cast<char*>(loaded.positions.data()), count * sizeof(glm::vec3));
+		if(!read_count(sizeof(int), count) || count % 3 != 0)
+			return false;
+		loaded.indices.resize(count);
+		file.read(reinterpret_cast<char*>(loaded.indices.data()), count * sizeof(int));
+		if(!file)
+			return false;
+
+		// bullet reads the vertices straight through these indices
+		for(int i = 0; i < loaded.indices.size(); i++)
+		{
+			if(loaded.indices[i] < 0 || loaded.indices[i] >= loaded.positions.size())
+				return false;
+		}
+	}
+	else
+	{
+		if(!read_count(sizeof(unsigned int), count))
+			return false;
+		loaded.hulls.resize(count);
+		remaining += count * sizeof(unsigned int); // only a bound, each hull takes its own count off below
+		for(int i = 0; i < loaded.hulls.size(); i++)
+		{
+			unsigned int nb_points = 0;
+			if(!read_count(sizeof(glm::vec3), nb_points))
+				return false;
+			loaded.hulls[i].points.resize(nb_points);
+			file.read(reinterpret_cast<char*>(loaded.hulls[i].points.data()), nb_points * sizeof(glm::vec3));
+			if(!file)
+				return false;
+		}
+	}
+
+	proxy = std::move(loaded);
+	return true;
+}
+
+void CollisionProxyBuilder::save(const std::string & path, unsigned int checksum, const CollisionProxy & proxy)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		std::cerr << "Error: failed writing collision proxy " << path << std::endl;
+		return;
+	}
+
+	ProxyCacheHeader header;
+	header.magic = PROXY_CACHE_MAGIC;
+	header.checksum = checksum;
+	header.type = proxy.type;
+	header.max_error = max_error;
+	header.hull_cell_size = hull_cell_size;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(ProxyCacheHeader));
+
+	unsigned int count = 0;
+	if(proxy.type == PROXY_TRIANGLES)
+	{
+		count = proxy.positions.size();
+		file.write(reinterpret_cast<const char*>(&count), sizeof(unsigned int));
+		file.write(reinterpret_cast<const char*>(proxy.positions.data()), count * sizeof(glm::vec3));
+		count = proxy.indices.size();
+		file.write(reinterpret_cast<const char*>(&count), sizeof(unsigned int));
+		file.write(reinterpret_cast<const char*>(proxy.indices.data()), count * sizeof(int));
+	}
+	else
+	{
+		count = proxy.hulls.size();
+		file.write(reinterpret_cast<const char*>(&count), sizeof(unsigned int));
+		for(int i = 0; i < proxy.hulls.size(); i++)
+		{
+			unsigned int nb_points = proxy.hulls[i].points.size();
+			file.write(reinterpret_cast<const char*>(&nb_points), sizeof(unsigned int));
+			file.write(reinterpret_cast<const char*>(proxy.hulls[i].points.data()), nb_points * sizeof(glm::vec3));
+		}
+	}
+}
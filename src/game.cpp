@@ -7,6 +7,7 @@
 #include "game.hpp"
 #include <glm/gtx/string_cast.hpp>
 #define CHECK_RENDER_PASS 0
+#define COLLISION_BENCHMARK 0
 
 Game::Game(const std::string& title) :
 	tuning_button({0.925f, 0.9f, -0.15f, 0.0f, 0.0f,
@@ -206,6 +207,17 @@ Game::Game(const std::string& title) :
     ui_shader->set_float("delta_anim", delta_anim);
 	glActiveTexture(GL_TEXTURE0);
 
+	// race post process shaders
+	grey_shader = new Shader("../shaders/greyscale/vertex.glsl", "../shaders/greyscale/fragment.glsl", "../shaders/greyscale/geometry.glsl");
+	motionBlur_shader = new Shader("../shaders/motion_blur/vertex.glsl", "../shaders/motion_blur/fragment.glsl", "../shaders/motion_blur/geometry.glsl");
+	gaussian_blur_shader = new Shader("../shaders/gaussian_blur/vertex.glsl", "../shaders/gaussian_blur/fragment.glsl", "../shaders/gaussian_blur/geometry.glsl");
+	color_shader = new Shader("../shaders/color_pass/vertex.glsl", "../shaders/color_pass/fragment.glsl", "../shaders/color_pass/geometry.glsl");
+	final_shader = new Shader("../shaders/final_pass/vertex.glsl", "../shaders/final_pass/fragment.glsl", "../shaders/final_pass/geometry.glsl");
+	countdown_shader = new Shader("../shaders/countdown/vertex.glsl", "../shaders/countdown/fragment.glsl", "../shaders/countdown/geometry.glsl");
+	countdown_shader->use();
+	countdown_shader->set_float("alpha", 1.0f);
+	countdown_shader->set_int("img", 0);
+
 	// MENU BOUNDING BOXES
 	bb_play.top_left_x = (WIDTH / 8) * 3;
 	bb_play.top_left_y = (HEIGHT / 2) * 0.334;
@@ -422,7 +434,47 @@ Game::Game(const std::string& title) :
 	flip.push_back(true);
 	tex_path.push_back(std::string("../assets/textures/menu/loading_screen_assets.png")); // 71
 	flip.push_back(false);
+
+	// set by enable_shader_reload()
+	shader_reloader = nullptr;
+
+	// race HUD atlas : speed gauge, top bar and digits (33 to 59 except the sound button)
+	hud = new HudBatcher();
+	for(int t = 33; t <= 59; t++)
+	{
+		if(t != 45)
+			hud->add_image(t, tex_path[t], flip[t]);
+	}
+	hud->build();
+
+	// everything the atlas doesn't hold
 	set_menu_textures();
+
+	// HUD speed
+	hud_speed.layout = {-1.0f, -1.0f, -0.5f, -0.5f, -0.045f};
+	hud_speed.speed_bar = {-0.608f, -0.9488f, -0.548f, -0.5488f, -0.05f};
+	hud_speed.d0 = {-0.897f, -0.847f, -0.812f, -0.677f, -0.05f};
+	hud_speed.d1 = {-0.812f, -0.847f, -0.735f, -0.677f, -0.05f};
+	hud_speed.d2 = {-0.735f, -0.847f, -0.655f, -0.677f, -0.05f};
+
+	// HUD top bar
+	hud_top_bar = {-1.0f, 0.6f, 1.0f, 1.0f, -0.5f};
+	hud_lap.current = {-0.847f, 0.817f, -0.777f, 0.99f, -0.55f};
+	hud_lap.slash = {-0.777f, 0.817f, -0.707f, 0.99f, -0.55f};
+	hud_lap.max = {-0.707f, 0.817f, -0.637f, 0.99f, -0.55f};
+	hud_pos.pos = {0.637f, 0.817f, 0.707f, 0.99f, -0.55f};
+	hud_pos.slash = {0.707f, 0.817f, 0.777f, 0.99f, -0.55f};
+	hud_pos.max = {0.777f, 0.817f, 0.847f, 0.99f, -0.55f};
+
+	// HUD chrono and lap_time (same columns, lap_time lies lower)
+	HudQuad* chrono_quads[] = {&chrono.min_d0, &chrono.min_d1, &chrono.dots2, &chrono.sec_d0, &chrono.sec_d1, &chrono.dot, &chrono.ms_d0, &chrono.ms_d1};
+	HudQuad* lap_time_quads[] = {&lap_time.min_d0, &lap_time.min_d1, &lap_time.dots2, &lap_time.sec_d0, &lap_time.sec_d1, &lap_time.dot, &lap_time.ms_d0, &lap_time.ms_d1};
+	for(int c = 0; c < 8; c++)
+	{
+		float x0 = -0.212f + c * 0.053f;
+		*chrono_quads[c] = {x0, 0.817f, x0 + 0.053f, 0.99f, -0.55f};
+		*lap_time_quads[c] = {x0, 0.817f - 0.45f, x0 + 0.053f, 0.99f - 0.45f, -0.55f};
+	}
     
     // ########## start loading screen geometry ##########
 	GLuint VAO1, VBO1, EBO1;
@@ -511,13 +563,20 @@ Game::Game(const std::string& title) :
 	// minimap
 	minimap = new Minimap("../assets/environment/minimap.obj", this);
 	
-    // World Physics
-    tatooine = new WorldPhysics(this);
-	
-    // Draw master
+    // Draw master (reads the full vertex lists, before physics compacts the ones it keeps)
     draw_master = new DrawMaster();
+    depth_history = false;
     draw_master->build_tree(env->get_mesh_collection());
 	
+    // World Physics
+    tatooine = new WorldPhysics(this);
+
+    // every mesh is on the GPU now, drop the CPU copies nobody reads anymore
+    release_geometry(platform->get_objects());
+    release_geometry(env->get_objects());
+    release_geometry(pod->get_parts());
+    release_geometry(minimap->get_objects());
+	
 	// init timer
 	timer = 0.0;
 	timer1 = 0.0;
@@ -535,68 +594,43 @@ Game::Game(const std::string& title) :
 	countdown_timer = 3;
 
 	// SOUNDS
-	sounds = new Audio();
-	sounds->load_sound("../assets/audio/the_pod_race.wav"); // 0
-	sounds->load_sound("../assets/audio/fire_power_coupling.wav"); // 1
-	sounds->load_sound("../assets/audio/power_coupling.wav"); // 2
-	sounds->load_sound("../assets/audio/start_electric_engine.wav"); // 3
-	sounds->load_sound("../assets/audio/electric_engine_idle.wav"); // 4
-	sounds->load_sound("../assets/audio/fire_engine.wav"); // 5
-	sounds->load_sound("../assets/audio/base_engine.wav"); // 6
-	sounds->load_sound("../assets/audio/break_engine.wav"); // 7
-	sounds->load_sound("../assets/audio/new_lap_record.wav"); // 8
-	sounds->load_sound("../assets/audio/afterburn.wav"); // 9
-	sounds->load_sound("../assets/audio/countdown.wav"); // 10
-	sounds->load_sound("../assets/audio/go.wav"); // 11
-	sounds->load_sound("../assets/audio/collide.wav"); // 12
-	sounds->load_sound("../assets/audio/crash.wav"); // 13
-	
-	main_menu_source = new Source();
-	main_menu_source->set_volume(sound_volume);
-	main_menu_source->set_looping(true);
-	
-	pod_fire_power_coupling = new Source();
-	pod_fire_power_coupling->set_volume(100);
-	
-	pod_power_coupling = new Source();
-	pod_power_coupling->set_volume(100);
-	pod_power_coupling->set_looping(true);
-
-	pod_start_electric_engine = new Source();
-	pod_start_electric_engine->set_volume(30);
-	
-	pod_electric_engine = new Source();
-	pod_electric_engine->set_volume(30);
-	pod_electric_engine->set_looping(true);
-
-	pod_fire_engine = new Source();
-	pod_fire_engine->set_volume(60);
-
-	pod_base_engine = new Source();
-	pod_base_engine->set_volume(30);
-	pod_base_engine->set_looping(true);
-
-	pod_break = new Source();
-	pod_break->set_volume(100);
-	
-	pod_afterburn = new Source();
-	pod_afterburn->set_volume(100);
-	
-	fodesinbeed = new Source();
-	fodesinbeed->set_volume(100);
-
-	tatooine_wind = new Source();
-	tatooine_wind->set_volume(30);
-	tatooine_wind->set_looping(true);
-	
-	countdown_sounds = new Source();
-	countdown_sounds->set_volume(100);
-
-    pod_collide = new Source();
-    pod_collide->set_volume(60);
-    
-    pod_crash = new Source();
-    pod_crash->set_volume(80);
+	audio = new AudioSystem();
+	audio->add_sound("../assets/audio/fire_power_coupling.wav"); // 0
+	audio->add_sound("../assets/audio/start_electric_engine.wav"); // 1
+	audio->add_sound("../assets/audio/fire_engine.wav"); // 2
+	audio->add_sound("../assets/audio/break_engine.wav"); // 3
+	audio->add_sound("../assets/audio/new_lap_record.wav"); // 4
+	audio->add_sound("../assets/audio/afterburn.wav"); // 5
+	audio->add_sound("../assets/audio/countdown.wav"); // 6
+	audio->add_sound("../assets/audio/go.wav"); // 7
+	audio->add_sound("../assets/audio/collide.wav"); // 8
+	audio->add_sound("../assets/audio/crash.wav"); // 9
+
+	// music and long loops are streamed
+	main_menu_source = audio->add_voice(sound_volume, true, "../assets/audio/the_pod_race.wav");
+	pod_fire_power_coupling = audio->add_emitter(100, false, 2.0f);
+	pod_power_coupling = audio->add_emitter(100, true, 4.0f, "../assets/audio/power_coupling.wav");
+	pod_start_electric_engine = audio->add_emitter(30, false, 2.0f);
+	pod_electric_engine = audio->add_emitter(30, true, 4.0f, "../assets/audio/electric_engine_idle.wav");
+	pod_fire_engine = audio->add_emitter(60, false, 2.0f);
+	pod_base_engine = audio->add_emitter(30, true, 4.0f, "../assets/audio/base_engine.wav");
+	pod_break = audio->add_emitter(100, false, 2.0f);
+	pod_afterburn = audio->add_emitter(100, false, 2.0f);
+	fodesinbeed = audio->add_voice(100);
+	tatooine_wind = audio->add_voice(30, true);
+	countdown_sounds = audio->add_voice(100);
+	pod_collide = audio->add_emitter(60, false, 2.0f);
+	pod_crash = audio->add_emitter(80, false, 2.0f);
+#if AUDIO_BENCHMARK == 1
+	// stand-in for a full grid of AI pods, each with its own engine loop
+	audio->add_sound("../assets/audio/base_engine.wav"); // 10
+	for(int i = 0; i < AUDIO_BENCH_EMITTERS; i++)
+	{
+		bench_emitters.push_back(audio->add_emitter(60, true));
+	}
+#endif
+	last_listener_position = glm::vec3(0.0f);
+	audio->start();
 
 	// render pass visualization
 	check_render_pass = false;
@@ -1481,23 +1515,27 @@ Game::~Game()
 	delete(minimap);
 	delete(sky);
 	delete(ui_shader);
+	delete(grey_shader);
+	delete(motionBlur_shader);
+	delete(gaussian_blur_shader);
+	delete(color_shader);
+	delete(final_shader);
+	delete(countdown_shader);
+	delete(hud);
+	delete(shader_reloader);
+
+	for(auto & q : ui_quads)
+	{
+		glDeleteBuffers(1, &q.second.VBO);
+		glDeleteBuffers(1, &q.second.EBO);
+		glDeleteVertexArrays(1, &q.second.VAO);
+	}
     delete(tatooine);
     delete(draw_master);
-	delete(sounds);
-	delete(main_menu_source);
-	delete(pod_fire_power_coupling);
-	delete(pod_power_coupling);
-	delete(pod_start_electric_engine);
-	delete(pod_electric_engine);
-	delete(pod_fire_engine);
-	delete(pod_base_engine);
-	delete(pod_break);
-	delete(pod_afterburn);
-	delete(fodesinbeed);
-	delete(tatooine_wind);
-	delete(countdown_sounds);
-    delete(pod_collide);
-    delete(pod_crash);
+	delete(audio);
+
+	// every mesh is gone, free the shared geometry buffers
+	MeshArena::get().destroy();
     
     glDeleteRenderbuffers(1, &envRBO);
     glDeleteTextures(1, &envTexture);
@@ -1550,6 +1588,115 @@ Game::~Game()
     glDeleteFramebuffers(1, &pong2FBO);
 }
 
+void Game::release_geometry(const std::vector<Object*> & objects)
+{
+	for(int i = 0; i < objects.size(); i++)
+	{
+		objects.at(i)->release_geometry();
+	}
+}
+
+void Game::memory_usage(const std::vector<Object*> & objects, size_t & cpu, size_t & gpu)
+{
+	for(int i = 0; i < objects.size(); i++)
+	{
+		objects.at(i)->memory_usage(cpu, gpu);
+	}
+}
+
+void Game::set_occlusion(OCCLUSION_MODE mode, bool print_stats)
+{
+	draw_master->get_occlusion().set_mode(mode, print_stats);
+}
+
+void Game::enable_shader_reload()
+{
+	if(shader_reloader == nullptr)
+		shader_reloader = new ShaderReloader();
+}
+
+void Game::end_frame()
+{
+	// rebuilt programs are swapped in between two frames, never while one is drawn
+	if(shader_reloader != nullptr)
+		shader_reloader->draw_overlay(width, height);
+	SDL_GL_SwapWindow(window);
+	if(shader_reloader != nullptr)
+		shader_reloader->poll();
+}
+
+void Game::update_poses()
+{
+	// poses are evaluated once per frame, every pass then draws the same palette
+	std::vector<PoseJob> jobs;
+	double time = omp_get_wtime();
+	Environment* environments[] = {platform, env};
+	for(int e = 0; e < 2; e++)
+	{
+		const std::vector<Object*> & objects = environments[e]->get_objects();
+		for(int i = 0; i < objects.size(); i++)
+		{
+			std::vector<Animation*> animations = objects[i]->get_animations();
+			if(animations.empty() || objects[i]->get_pose().get_nb_joints() == 0)
+				continue;
+			jobs.push_back(PoseJob{&objects[i]->get_pose(), animations[0], time * animations[0]->get_ticks_per_second()});
+		}
+	}
+	Pose::evaluate_batch(jobs);
+}
+
+void Game::print_memory_report()
+{
+	auto print_line = [](const std::string & subsystem, size_t cpu, size_t gpu)
+	{
+		std::cout << "	- " << subsystem << ": cpu = " << cpu / (1024.0 * 1024.0) << " MB, gpu = " << gpu / (1024.0 * 1024.0) << " MB" << std::endl;
+	};
+
+	std::cout << "##### MEMORY REPORT #####" << std::endl;
+
+	// meshes and their textures, grouped by owner
+	size_t cpu = 0;
+	size_t gpu = 0;
+	memory_usage(env->get_objects(), cpu, gpu);
+	print_line("environment", cpu, gpu);
+
+	cpu = 0;
+	gpu = 0;
+	memory_usage(platform->get_objects(), cpu, gpu);
+	print_line("platform", cpu, gpu);
+
+	cpu = 0;
+	gpu = 0;
+	memory_usage(pod->get_parts(), cpu, gpu);
+	print_line("podracer", cpu, gpu);
+
+	cpu = 0;
+	gpu = 0;
+	memory_usage(minimap->get_objects(), cpu, gpu);
+	print_line("minimap", cpu, gpu);
+
+	// the arena figures overlap with the meshes above, they show how full the shared buffers are
+	std::cout << "	- mesh arena: used = " << MeshArena::get().get_used_bytes() / (1024.0 * 1024.0) << " MB, allocated = " << MeshArena::get().get_gpu_bytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+
+	size_t menu_gpu = 0;
+	for(int i = 0; i < menu_textures.size(); i++)
+	{
+		if(menu_textures[i].id == 0)
+			continue; // held by the hud atlas
+		GLint width = 0;
+		GLint height = 0;
+		glBindTexture(GL_TEXTURE_2D, menu_textures[i].id);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+		menu_gpu += (size_t)width * height * 4 * 4 / 3;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	print_line("menu textures", 0, menu_gpu);
+	print_line("hud atlas", 0, hud->get_gpu_bytes());
+	print_line("collision", tatooine->get_cpu_bytes(), 0);
+	std::cout << std::endl;
+}
+
 SDL_Window* Game::createWindow(int w, int h, const std::string& title)
 {
 	SDL_Window* window = nullptr;
@@ -1594,13 +1741,93 @@ void Game::set_menu_textures()
 	int tex_count = tex_path.size();
 	for(int t = 0; t < tex_count; t++)
 	{
+		// atlas images are only drawn through the HUD batcher, keep the slot so ids stay aligned
+		if(hud->has_image(t))
+		{
+			menu_textures.push_back(Texture(0, TextureType::DIFFUSE_TEXTURE));
+			continue;
+		}
 		GLuint tex_id = Object::create_texture(tex_path[t], flip[t]);
-		Texture tex(tex_id, TextureType::DIFFUSE_TEXTURE, tex_path[t]);
+		Texture tex(tex_id, TextureType::DIFFUSE_TEXTURE);
 		menu_textures.push_back(tex);
 	}
 }
 
+HudQuad Game::hud_quad(const float * vertices) const
+{
+	// same layout as get_ui_quad : bottom left, bottom right, top left, top right
+	return HudQuad{vertices[0], vertices[1], vertices[5], vertices[11], vertices[2]};
+}
+
+const UiQuad & Game::get_ui_quad(const std::string & name, const float * vertices, int size)
+{
+	auto it = ui_quads.find(name);
+	if(it != ui_quads.end())
+		return it->second;
+
+	int indices[] = {0, 1, 2, 2, 1, 3};
+
+	UiQuad q;
+	glGenVertexArrays(1, &q.VAO);
+	glBindVertexArray(q.VAO);
+
+	glGenBuffers(1, &q.VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, q.VBO);
+	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+
+	glGenBuffers(1, &q.EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, q.EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+
+	return ui_quads.emplace(name, q).first->second;
+}
+
 void Game::start()
+{
+	// every page returns here instead of calling the next one
+	next_page = MAIN;
+	while(next_page != EXIT)
+	{
+		PAGE page = next_page;
+		next_page = EXIT; // a page closed without a choice quits the game
+		switch(page)
+		{
+			case MAIN:
+				main_menu();
+				break;
+			case INFOS:
+				gameInfo();
+				break;
+			case MAP:
+				map();
+				break;
+			case CONTROLS:
+				podracer_controls();
+				break;
+			case POD_SPECS:
+				pod_specs();
+				break;
+			case END_GAME_STATS:
+				end_game_stats();
+				break;
+			case RACE:
+				play();
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void Game::main_menu()
 {
     // set screen to menu width and height
     width = menu_width;
@@ -1624,15 +1851,7 @@ void Game::start()
 	// disable gamma correction
 	glDisable(GL_FRAMEBUFFER_SRGB);
 
-	// menu geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-
-	GLuint VAO1, VBO1, EBO1;
-	GLuint VAO2, VBO2, EBO2;
-	GLuint VAO3, VBO3, EBO3;
-	GLuint VAO4, VBO4, EBO4;
-	GLuint VAO5, VBO5, EBO5;
-	
+	// menu geometry (created on first visit)
 	float menu_background[] = {
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
 		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
@@ -1640,24 +1859,7 @@ void Game::start()
 		1.0f, 1.0f, 0.0f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(menu_background), menu_background, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO1 = get_ui_quad("main_menu.menu_background", menu_background, sizeof(menu_background)).VAO;
 
 	float play_button[] = {
 		-0.2f, 0.5f, -0.15f, 0.0f, 0.0f,
@@ -1666,24 +1868,7 @@ void Game::start()
 		0.2f, 0.666f, -0.15f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO2);
-	glBindVertexArray(VAO2);
-	
-	glGenBuffers(1, &VBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(play_button), play_button, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO2 = get_ui_quad("main_menu.play_button", play_button, sizeof(play_button)).VAO;
 	
 	float infos_button[] = {
 		-0.2f, 0.174f, -0.30f, 0.0f, 0.0f,
@@ -1692,24 +1877,7 @@ void Game::start()
 		0.2f, 0.344f, -0.30f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO3);
-	glBindVertexArray(VAO3);
-	
-	glGenBuffers(1, &VBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(infos_button), infos_button, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO3 = get_ui_quad("main_menu.infos_button", infos_button, sizeof(infos_button)).VAO;
 	
 	float pod_specs_button[] = {
 		-0.25f, -0.166f, -0.30f, 0.0f, 0.0f,
@@ -1718,24 +1886,7 @@ void Game::start()
 		0.25f, 0.0f, -0.30f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO4);
-	glBindVertexArray(VAO4);
-	
-	glGenBuffers(1, &VBO4);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO4);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(pod_specs_button), pod_specs_button, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO4);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO4);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO4 = get_ui_quad("main_menu.pod_specs_button", pod_specs_button, sizeof(pod_specs_button)).VAO;
 	
 	float quit_button[] = {
 		-0.2f, -0.5f, -0.45f, 0.0f, 1.0f,
@@ -1744,24 +1895,7 @@ void Game::start()
 		0.2f, -0.333f, -0.45f, 1.0f, 0.0f
 	};
 
-	glGenVertexArrays(1, &VAO5);
-	glBindVertexArray(VAO5);
-
-	glGenBuffers(1, &VBO5);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO5);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quit_button), quit_button, GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &EBO5);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO5);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+	GLuint VAO5 = get_ui_quad("main_menu.quit_button", quit_button, sizeof(quit_button)).VAO;
 
 	// use ui_shader
 	glActiveTexture(GL_TEXTURE0);
@@ -1830,23 +1964,6 @@ void Game::start()
 			if(user_actions.clicked_play || user_actions.clicked_quit || user_actions.clicked_infos || user_actions.clicked_pod_specs)
 			{
 				show_menu = false;
-				glDeleteBuffers(1, &VBO1);
-				glDeleteBuffers(1, &VBO2);
-				glDeleteBuffers(1, &VBO3);
-				glDeleteBuffers(1, &VBO4);
-				glDeleteBuffers(1, &VBO5);
-			
-				glDeleteBuffers(1, &EBO1);
-				glDeleteBuffers(1, &EBO2);
-				glDeleteBuffers(1, &EBO3);
-				glDeleteBuffers(1, &EBO4);
-				glDeleteBuffers(1, &EBO5);
-
-				glDeleteVertexArrays(1, &VAO1);
-				glDeleteVertexArrays(1, &VAO2);
-				glDeleteVertexArrays(1, &VAO3);
-				glDeleteVertexArrays(1, &VAO4);
-				glDeleteVertexArrays(1, &VAO5);
 			}
 
 			// draw background image
@@ -1915,27 +2032,23 @@ void Game::start()
 			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 		}
 
-		SDL_GL_SwapWindow(window);
+		end_frame();
 	}
 
 	if(user_actions.clicked_play)
 	{
 		user_actions.clicked_play = false;
-		play();
+		next_page = RACE;
 	}
 	else if(user_actions.clicked_infos)
 	{
 		user_actions.clicked_infos = false;
-		gameInfo();
+		next_page = INFOS;
 	}
 	else if(user_actions.clicked_pod_specs)
 	{
 		user_actions.clicked_pod_specs = false;
-		pod_specs();
-	}
-	else if(user_actions.clicked_quit)
-	{
-		quit();
+		next_page = POD_SPECS;
 	}
 }
 
@@ -1953,11 +2066,7 @@ void Game::tuning()
 {	
 	current_page = TUNING;
 	
-	// geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-	
-	GLuint VAO1, VBO1, EBO1;
-	
+	// geometry (created on first visit)
 	float tuning_window[] = {
 		-0.5f, 0.0f, -0.5f, 0.0f, 0.0f,
 		0.5f, 0.0f, -0.5f, 1.0f, 0.0f,
@@ -1965,24 +2074,7 @@ void Game::tuning()
 		0.5f, 0.6f, -0.5f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(tuning_window), tuning_window, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO1 = get_ui_quad("tuning.tuning_window", tuning_window, sizeof(tuning_window)).VAO;
 
 	// sound volume button
 	float sound_button[] = {
@@ -1991,29 +2083,10 @@ void Game::tuning()
 		0.23f + (static_cast<float>(sound_volume)/595.0f), 0.28f, -0.55f, 0.0f, 1.0f,
 		0.25f + (static_cast<float>(sound_volume)/595.0f), 0.28f, -0.55f, 1.0f, 1.0f
 	};
-	
-	GLuint soundButtonVAO, soundButtonVBO, soundButtonEBO;
 
-	glGenVertexArrays(1, &soundButtonVAO);
-	glBindVertexArray(soundButtonVAO);
-
-	glGenBuffers(1, &soundButtonVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, soundButtonVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(sound_button), sound_button, GL_DYNAMIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &soundButtonEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, soundButtonEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	const UiQuad & sound_button_quad = get_ui_quad("tuning.sound_button", sound_button, sizeof(sound_button));
 
-	// post process quad and its grey shader
+	// post process quad
 	float quad[] =
 	{
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
@@ -2024,20 +2097,7 @@ void Game::tuning()
 		-1.0f, 1.0f, 0.0f, 0.0f, 1.0f
 	};
 
-	GLuint VAO, VBO;
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quad), &quad, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glBindVertexArray(0);
-	
-	Shader grey_shader("../shaders/greyscale/vertex.glsl", "../shaders/greyscale/fragment.glsl", "../shaders/greyscale/geometry.glsl");
+	GLuint VAO = get_ui_quad("post_process_quad", quad, sizeof(quad)).VAO;
 
 	while(show_tuning)
 	{
@@ -2047,10 +2107,10 @@ void Game::tuning()
 
 		// post process quad
 		glBindVertexArray(VAO);
-		grey_shader.use();
+		grey_shader->use();
 		glActiveTexture(GL_TEXTURE0);
-		grey_shader.set_int("img", 0);
-		grey_shader.set_int("apply_greyScale", 1);
+		grey_shader->set_int("img", 0);
+		grey_shader->set_int("apply_greyScale", 1);
 		glBindTexture(GL_TEXTURE_2D, colorTexture);
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
@@ -2079,7 +2139,7 @@ void Game::tuning()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
 		// show sound volume button
-		glBindBuffer(GL_ARRAY_BUFFER, soundButtonVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, sound_button_quad.VBO);
 		float sound_button_update[] = {
 			0.23f + (static_cast<float>(sound_volume)/595.0f), 0.25f, -0.55f, 0.0f, 0.0f,
 			0.25f + (static_cast<float>(sound_volume)/595.0f), 0.25f, -0.55f, 1.0f, 0.0f,
@@ -2089,13 +2149,13 @@ void Game::tuning()
 		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(sound_button_update), sound_button_update);
 
 		glBindTexture(GL_TEXTURE_2D, menu_textures[45].id);
-		glBindVertexArray(soundButtonVAO);
+		glBindVertexArray(sound_button_quad.VAO);
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 	
 		// disable gamma correction
 		glDisable(GL_FRAMEBUFFER_SRGB);
 
-		SDL_GL_SwapWindow(window);
+		end_frame();
 	}
 }
 
@@ -2107,13 +2167,7 @@ void Game::gameInfo()
 	// set current page
 	current_page = INFOS;
 
-	// geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-	
-	GLuint VAO1, VBO1, EBO1;
-	GLuint VAO2, VBO2, EBO2;
-	GLuint VAO3, VBO3, EBO3;
-
+	// geometry (created on first visit)
 	float menu_background[] = {
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
 		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
@@ -2121,24 +2175,7 @@ void Game::gameInfo()
 		1.0f, 1.0f, 0.0f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(menu_background), menu_background, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO1 = get_ui_quad("gameInfo.menu_background", menu_background, sizeof(menu_background)).VAO;
 
 	float map_button[] = {
 		-0.5f, -0.25f, -0.15f, 0.0f, 0.0f,
@@ -2147,24 +2184,7 @@ void Game::gameInfo()
 		-0.25f, 0.25f, -0.15f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO2);
-	glBindVertexArray(VAO2);
-
-	glGenBuffers(1, &VBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(map_button), map_button, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO2 = get_ui_quad("gameInfo.map_button", map_button, sizeof(map_button)).VAO;
 
 	float controls_button[] = {
 		0.25f, -0.25f, -0.15f, 0.0f, 0.0f,
@@ -2173,24 +2193,7 @@ void Game::gameInfo()
 		0.5f, 0.25f, -0.15f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO3);
-	glBindVertexArray(VAO3);
-
-	glGenBuffers(1, &VBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(controls_button), controls_button, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO3 = get_ui_quad("gameInfo.controls_button", controls_button, sizeof(controls_button)).VAO;
 
 	// use ui_shader
 	ui_shader->use();
@@ -2253,18 +2256,6 @@ void Game::gameInfo()
 			if(user_actions.clicked_map || user_actions.clicked_controls || user_actions.clicked_back)
 			{
 				show_info_menu = false;
-				
-                glDeleteBuffers(1, &VBO1);
-				glDeleteBuffers(1, &VBO2);
-				glDeleteBuffers(1, &VBO3);
-			
-				glDeleteBuffers(1, &EBO1);
-				glDeleteBuffers(1, &EBO2);
-				glDeleteBuffers(1, &EBO3);
-
-				glDeleteVertexArrays(1, &VAO1);
-				glDeleteVertexArrays(1, &VAO2);
-				glDeleteVertexArrays(1, &VAO3);
 			}
 			// display menu background
 			glBindTexture(GL_TEXTURE_2D, menu_textures[22].id);
@@ -2320,23 +2311,23 @@ void Game::gameInfo()
 			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 		}
 		
-		SDL_GL_SwapWindow(window);
+		end_frame();
 	}
 
 	if(user_actions.clicked_back)
 	{
 		user_actions.clicked_back = false;
-		start();
+		next_page = MAIN;
 	}
 	else if(user_actions.clicked_map)
 	{
 		user_actions.clicked_map = false;
-		map();
+		next_page = MAP;
 	}
 	else if(user_actions.clicked_controls)
 	{
 		user_actions.clicked_controls = false;
-		podracer_controls();
+		next_page = CONTROLS;
 	}
 }
 
@@ -2347,11 +2338,7 @@ void Game::map()
 	
 	current_page = MAP;
 
-	// geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-	
-	GLuint VAO1, VBO1, EBO1;
-
+	// geometry (created on first visit)
 	float map[] = {
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
 		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
@@ -2359,24 +2346,7 @@ void Game::map()
 		1.0f, 1.0f, 0.0f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(map), map, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO1 = get_ui_quad("map.map", map, sizeof(map)).VAO;
 	
 	// use ui_shader
 	ui_shader->use();
@@ -2428,16 +2398,9 @@ void Game::map()
 			current_page = MAP;
 			if(user_actions.clicked_back)
 			{
-				glDeleteBuffers(1, &VBO1);
-				glDeleteBuffers(1, &EBO1);
-				glDeleteVertexArrays(1, &VAO1);
-
-				if(user_actions.clicked_back)
-				{
-					show_map = false;
-					user_actions.clicked_back = false;
-					gameInfo();
-				}
+				show_map = false;
+				user_actions.clicked_back = false;
+				next_page = INFOS;
 			}
 
 			// display map
@@ -2470,7 +2433,7 @@ void Game::map()
 			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 		}
 
-		SDL_GL_SwapWindow(window);
+		end_frame();
 	}
 }
 
@@ -2481,11 +2444,7 @@ void Game::podracer_controls()
 	
 	current_page = CONTROLS;
 
-	// geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-	
-	GLuint VAO1, VBO1, EBO1;
-
+	// geometry (created on first visit)
 	float controls[] = {
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
 		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
@@ -2493,24 +2452,7 @@ void Game::podracer_controls()
 		1.0f, 1.0f, 0.0f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(controls), controls, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO1 = get_ui_quad("podracer_controls.controls", controls, sizeof(controls)).VAO;
 	
 	// use ui_shader
 	ui_shader->use();
@@ -2564,16 +2506,9 @@ void Game::podracer_controls()
 			current_page = CONTROLS;
 			if(user_actions.clicked_back)
 			{
-				glDeleteBuffers(1, &VBO1);
-				glDeleteBuffers(1, &EBO1);
-				glDeleteVertexArrays(1, &VAO1);
-
-				if(user_actions.clicked_back)
-				{
-					show_controls = false;
-					user_actions.clicked_back = false;
-					gameInfo();
-				}
+				show_controls = false;
+				user_actions.clicked_back = false;
+				next_page = INFOS;
 			}
 
 			// display controls
@@ -2608,7 +2543,7 @@ void Game::podracer_controls()
 			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 		}
 
-		SDL_GL_SwapWindow(window);
+		end_frame();
 	}
 }
 
@@ -2623,12 +2558,7 @@ void Game::pod_specs()
 	current_page = POD_SPECS;
 	glClearColor(0.125f, 0.125f, 0.125f, 1.0f);
 	
-	// geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-	
-	GLuint VAO1, VBO1, EBO1;
-	GLuint VAO2, VBO2, EBO2;
-
+	// geometry (created on first visit)
 	// pod specs title
 	float title[] = {
 		-0.4f, 0.5f, -0.0f, 0.0f, 0.0f,
@@ -2637,24 +2567,7 @@ void Game::pod_specs()
 		0.4f, 1.0f, 0.0f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(title), title, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);	
+	GLuint VAO1 = get_ui_quad("pod_specs.title", title, sizeof(title)).VAO;
 	
 	// pod specs
 	float pod_specs[] = {
@@ -2664,24 +2577,7 @@ void Game::pod_specs()
 		0.85f, 0.8f, -0.15f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO2);
-	glBindVertexArray(VAO2);
-
-	glGenBuffers(1, &VBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(pod_specs), pod_specs, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	GLuint VAO2 = get_ui_quad("pod_specs.pod_specs", pod_specs, sizeof(pod_specs)).VAO;
 
 	// render loop
 	show_pod_specs = true;
@@ -2704,6 +2600,10 @@ void Game::pod_specs()
 			glEnable(GL_DEPTH);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+			// effects update
+			pod->update_effects(delta);
+			update_poses();
+
 			if(cast_shadows)
 			{
 				// shadowMap
@@ -2769,10 +2669,6 @@ void Game::pod_specs()
 			if(user_actions.clicked_back)
 			{
 				show_pod_specs = false;
-
-                glDeleteBuffers(1, &VBO1);
-				glDeleteBuffers(1, &EBO1);
-				glDeleteVertexArrays(1, &VAO1);
 			}
 	
 			// delta calculation
@@ -2780,6 +2676,10 @@ void Game::pod_specs()
 			delta = currentFrame - lastFrame;
 			lastFrame = currentFrame;
 			fps = 1.0 / delta;
+
+			// effects update
+			pod->update_effects(delta);
+			update_poses();
 	
 			if(cast_shadows)
 			{
@@ -2849,13 +2749,13 @@ void Game::pod_specs()
 			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 		}
 
-		SDL_GL_SwapWindow(window);
+		end_frame();
 	}
 
 	if(user_actions.clicked_back)
 	{
 		user_actions.clicked_back = false;
-		start();
+		next_page = MAIN;
 	}
 }
 
@@ -2867,69 +2767,7 @@ void Game::end_game_stats()
 	// sound system
 	sound_system();
 
-	// menu geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-
-	GLuint VAO1, VBO1, EBO1;
-	
-    // l1_min
-    GLuint l1_minVAO1, l1_minVBO1, l1_minEBO1;
-	GLuint l1_minVAO2, l1_minVBO2, l1_minEBO2;
-	GLuint l1_minVAO3, l1_minVBO3, l1_minEBO3;
-	// l1_sec
-    GLuint l1_secVAO1, l1_secVBO1, l1_secEBO1;
-	GLuint l1_secVAO2, l1_secVBO2, l1_secEBO2;
-	GLuint l1_secVAO3, l1_secVBO3, l1_secEBO3;
-	// l1_ms
-    GLuint l1_msVAO1, l1_msVBO1, l1_msEBO1;
-	GLuint l1_msVAO2, l1_msVBO2, l1_msEBO2;
-	GLuint l1_msVAO3, l1_msVBO3, l1_msEBO3;
-
-    // l2_min
-    GLuint l2_minVAO1, l2_minVBO1, l2_minEBO1;
-	GLuint l2_minVAO2, l2_minVBO2, l2_minEBO2;
-	GLuint l2_minVAO3, l2_minVBO3, l2_minEBO3;
-	// l2_sec
-    GLuint l2_secVAO1, l2_secVBO1, l2_secEBO1;
-	GLuint l2_secVAO2, l2_secVBO2, l2_secEBO2;
-	GLuint l2_secVAO3, l2_secVBO3, l2_secEBO3;
-	// l2_ms
-    GLuint l2_msVAO1, l2_msVBO1, l2_msEBO1;
-	GLuint l2_msVAO2, l2_msVBO2, l2_msEBO2;
-	GLuint l2_msVAO3, l2_msVBO3, l2_msEBO3;
-
-    // l3_min
-    GLuint l3_minVAO1, l3_minVBO1, l3_minEBO1;
-	GLuint l3_minVAO2, l3_minVBO2, l3_minEBO2;
-	GLuint l3_minVAO3, l3_minVBO3, l3_minEBO3;
-	// l3_sec
-    GLuint l3_secVAO1, l3_secVBO1, l3_secEBO1;
-	GLuint l3_secVAO2, l3_secVBO2, l3_secEBO2;
-	GLuint l3_secVAO3, l3_secVBO3, l3_secEBO3;
-	// l3_ms
-    GLuint l3_msVAO1, l3_msVBO1, l3_msEBO1;
-	GLuint l3_msVAO2, l3_msVBO2, l3_msEBO2;
-	GLuint l3_msVAO3, l3_msVBO3, l3_msEBO3;
-    
-    // total_min
-    GLuint total_minVAO1, total_minVBO1, total_minEBO1;
-	GLuint total_minVAO2, total_minVBO2, total_minEBO2;
-	GLuint total_minVAO3, total_minVBO3, total_minEBO3;
-	// total_sec
-    GLuint total_secVAO1, total_secVBO1, total_secEBO1;
-	GLuint total_secVAO2, total_secVBO2, total_secEBO2;
-	GLuint total_secVAO3, total_secVBO3, total_secEBO3;
-	// total_ms
-    GLuint total_msVAO1, total_msVBO1, total_msEBO1;
-	GLuint total_msVAO2, total_msVBO2, total_msEBO2;
-	GLuint total_msVAO3, total_msVBO3, total_msEBO3;
-    
-    // avg_speed
-    GLuint avgVAO1, avgVBO1, avgEBO1;
-	GLuint avgVAO2, avgVBO2, avgEBO2;
-	GLuint avgVAO3, avgVBO3, avgEBO3;
-	GLuint avgVAO4, avgVBO4, avgEBO4;
-
+	// menu geometry (created on first visit)
 	float background[] = {
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
 		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
@@ -2937,24 +2775,7 @@ void Game::end_game_stats()
 		1.0f, 1.0f, 0.0f, 1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(background), background, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+	GLuint VAO1 = get_ui_quad("end_game_stats.background", background, sizeof(background)).VAO;
 
     float l1_min1[] = {
         -0.274f, 0.231f, - 0.2f, 0.0f, 0.0f,
@@ -2963,50 +2784,12 @@ void Game::end_game_stats()
         -0.189f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_minVAO1);
-	glBindVertexArray(l1_minVAO1);
-
-	glGenBuffers(1, &l1_minVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_minVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_min1), l1_min1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_minEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_minEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l1_min2[] = {
         -0.189f, 0.231f, - 0.2f, 0.0f, 0.0f,
         -0.104f, 0.231f, - 0.2f, 1.0f, 0.0f,
         -0.189f, 0.394f, - 0.2f, 0.0f, 1.0f,
         -0.104f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
-    
-    glGenVertexArrays(1, &l1_minVAO2);
-	glBindVertexArray(l1_minVAO2);
-
-	glGenBuffers(1, &l1_minVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_minVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_min2), l1_min2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_minEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_minEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
 
     float l1_min3[] = {
         -0.104f, 0.231f, - 0.2f, 0.0f, 0.0f,
@@ -3015,24 +2798,7 @@ void Game::end_game_stats()
         0.066f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_minVAO3);
-	glBindVertexArray(l1_minVAO3);
-
-	glGenBuffers(1, &l1_minVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_minVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_min3), l1_min3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_minEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_minEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l1_minVAO3 = get_ui_quad("end_game_stats.l1_min3", l1_min3, sizeof(l1_min3)).VAO;
 
     float l1_sec1[] = {
         0.066f, 0.231f, - 0.2f, 0.0f, 0.0f,
@@ -3041,25 +2807,6 @@ void Game::end_game_stats()
         0.151f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_secVAO1);
-	glBindVertexArray(l1_secVAO1);
-
-	glGenBuffers(1, &l1_secVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_secVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_sec1), l1_sec1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_secEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_secEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float l1_sec2[] = {
         0.151f, 0.231f, - 0.2f, 0.0f, 0.0f,
         0.236f, 0.231f, - 0.2f, 1.0f, 0.0f,
@@ -3067,25 +2814,6 @@ void Game::end_game_stats()
         0.236f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_secVAO2);
-	glBindVertexArray(l1_secVAO2);
-
-	glGenBuffers(1, &l1_secVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_secVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_sec2), l1_sec2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_secEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_secEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float l1_sec3[] = {
         0.236f, 0.231f, - 0.2f, 0.0f, 0.0f,
         0.406f, 0.231f, - 0.2f, 1.0f, 0.0f,
@@ -3093,24 +2821,7 @@ void Game::end_game_stats()
         0.406f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_secVAO3);
-	glBindVertexArray(l1_secVAO3);
-
-	glGenBuffers(1, &l1_secVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_secVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_sec3), l1_sec3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_secEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_secEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l1_secVAO3 = get_ui_quad("end_game_stats.l1_sec3", l1_sec3, sizeof(l1_sec3)).VAO;
     
     float l1_ms1[] = {
         0.406f, 0.231f, - 0.2f, 0.0f, 0.0f,
@@ -3119,25 +2830,6 @@ void Game::end_game_stats()
         0.491f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_msVAO1);
-	glBindVertexArray(l1_msVAO1);
-
-	glGenBuffers(1, &l1_msVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_msVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_ms1), l1_ms1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_msEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_msEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l1_ms2[] = {
         0.491f, 0.231f, - 0.2f, 0.0f, 0.0f,
         0.576f, 0.231f, - 0.2f, 1.0f, 0.0f,
@@ -3145,25 +2837,6 @@ void Game::end_game_stats()
         0.576f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_msVAO2);
-	glBindVertexArray(l1_msVAO2);
-
-	glGenBuffers(1, &l1_msVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_msVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_ms2), l1_ms2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_msEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_msEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l1_ms3[] = {
         0.576f, 0.231f, - 0.2f, 0.0f, 0.0f,
         0.746f, 0.231f, - 0.2f, 1.0f, 0.0f,
@@ -3171,24 +2844,7 @@ void Game::end_game_stats()
         0.746f, 0.394f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l1_msVAO3);
-	glBindVertexArray(l1_msVAO3);
-
-	glGenBuffers(1, &l1_msVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l1_msVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l1_ms3), l1_ms3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l1_msEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l1_msEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l1_msVAO3 = get_ui_quad("end_game_stats.l1_ms3", l1_ms3, sizeof(l1_ms3)).VAO;
 
     float l2_min1[] = {
         -0.274f, 0.0717f, - 0.2f, 0.0f, 0.0f,
@@ -3197,50 +2853,12 @@ void Game::end_game_stats()
         -0.189f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_minVAO1);
-	glBindVertexArray(l2_minVAO1);
-
-	glGenBuffers(1, &l2_minVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_minVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_min1), l2_min1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_minEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_minEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l2_min2[] = {
         -0.189f, 0.0717f, - 0.2f, 0.0f, 0.0f,
         -0.104f, 0.0717f, - 0.2f, 1.0f, 0.0f,
         -0.189f, 0.2347f, - 0.2f, 0.0f, 1.0f,
         -0.104f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
-    
-    glGenVertexArrays(1, &l2_minVAO2);
-	glBindVertexArray(l2_minVAO2);
-
-	glGenBuffers(1, &l2_minVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_minVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_min2), l2_min2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_minEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_minEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
 
     float l2_min3[] = {
         -0.104f, 0.0717f, - 0.2f, 0.0f, 0.0f,
@@ -3249,24 +2867,7 @@ void Game::end_game_stats()
         0.066f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_minVAO3);
-	glBindVertexArray(l2_minVAO3);
-
-	glGenBuffers(1, &l2_minVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_minVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_min3), l2_min3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_minEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_minEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l2_minVAO3 = get_ui_quad("end_game_stats.l2_min3", l2_min3, sizeof(l2_min3)).VAO;
 
     float l2_sec1[] = {
         0.066f, 0.0717f, - 0.2f, 0.0f, 0.0f,
@@ -3275,25 +2876,6 @@ void Game::end_game_stats()
         0.151f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_secVAO1);
-	glBindVertexArray(l2_secVAO1);
-
-	glGenBuffers(1, &l2_secVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_secVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_sec1), l2_sec1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_secEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_secEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float l2_sec2[] = {
         0.151f, 0.0717f, - 0.2f, 0.0f, 0.0f,
         0.236f, 0.0717f, - 0.2f, 1.0f, 0.0f,
@@ -3301,25 +2883,6 @@ void Game::end_game_stats()
         0.236f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_secVAO2);
-	glBindVertexArray(l2_secVAO2);
-
-	glGenBuffers(1, &l2_secVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_secVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_sec2), l2_sec2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_secEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_secEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float l2_sec3[] = {
         0.236f, 0.0717f, - 0.2f, 0.0f, 0.0f,
         0.406f, 0.0717f, - 0.2f, 1.0f, 0.0f,
@@ -3327,24 +2890,7 @@ void Game::end_game_stats()
         0.406f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_secVAO3);
-	glBindVertexArray(l2_secVAO3);
-
-	glGenBuffers(1, &l2_secVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_secVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_sec3), l2_sec3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_secEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_secEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l2_secVAO3 = get_ui_quad("end_game_stats.l2_sec3", l2_sec3, sizeof(l2_sec3)).VAO;
     
     float l2_ms1[] = {
         0.406f, 0.0717f, - 0.2f, 0.0f, 0.0f,
@@ -3353,25 +2899,6 @@ void Game::end_game_stats()
         0.491f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_msVAO1);
-	glBindVertexArray(l2_msVAO1);
-
-	glGenBuffers(1, &l2_msVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_msVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_ms1), l2_ms1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_msEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_msEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l2_ms2[] = {
         0.491f, 0.0717f, - 0.2f, 0.0f, 0.0f,
         0.576f, 0.0717f, - 0.2f, 1.0f, 0.0f,
@@ -3379,25 +2906,6 @@ void Game::end_game_stats()
         0.576f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_msVAO2);
-	glBindVertexArray(l2_msVAO2);
-
-	glGenBuffers(1, &l2_msVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_msVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_ms2), l2_ms2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_msEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_msEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l2_ms3[] = {
         0.576f, 0.0717f, - 0.2f, 0.0f, 0.0f,
         0.746f, 0.0717f, - 0.2f, 1.0f, 0.0f,
@@ -3405,24 +2913,7 @@ void Game::end_game_stats()
         0.746f, 0.2347f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l2_msVAO3);
-	glBindVertexArray(l2_msVAO3);
-
-	glGenBuffers(1, &l2_msVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l2_msVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l2_ms3), l2_ms3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l2_msEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l2_msEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l2_msVAO3 = get_ui_quad("end_game_stats.l2_ms3", l2_ms3, sizeof(l2_ms3)).VAO;
 	
     float l3_min1[] = {
         -0.274f, -0.110f, - 0.2f, 0.0f, 0.0f,
@@ -3431,50 +2922,12 @@ void Game::end_game_stats()
         -0.189f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_minVAO1);
-	glBindVertexArray(l3_minVAO1);
-
-	glGenBuffers(1, &l3_minVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_minVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_min1), l3_min1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_minEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_minEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l3_min2[] = {
         -0.189f, -0.110f, - 0.2f, 0.0f, 0.0f,
         -0.104f, -0.110f, - 0.2f, 1.0f, 0.0f,
         -0.189f, 0.073f, - 0.2f, 0.0f, 1.0f,
         -0.104f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
-    
-    glGenVertexArrays(1, &l3_minVAO2);
-	glBindVertexArray(l3_minVAO2);
-
-	glGenBuffers(1, &l3_minVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_minVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_min2), l3_min2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_minEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_minEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
 
     float l3_min3[] = {
         -0.104f, -0.110f, - 0.2f, 0.0f, 0.0f,
@@ -3483,24 +2936,7 @@ void Game::end_game_stats()
         0.066f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_minVAO3);
-	glBindVertexArray(l3_minVAO3);
-
-	glGenBuffers(1, &l3_minVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_minVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_min3), l3_min3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_minEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_minEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l3_minVAO3 = get_ui_quad("end_game_stats.l3_min3", l3_min3, sizeof(l3_min3)).VAO;
 
     float l3_sec1[] = {
         0.066f, -0.110f, - 0.2f, 0.0f, 0.0f,
@@ -3509,25 +2945,6 @@ void Game::end_game_stats()
         0.151f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_secVAO1);
-	glBindVertexArray(l3_secVAO1);
-
-	glGenBuffers(1, &l3_secVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_secVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_sec1), l3_sec1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_secEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_secEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float l3_sec2[] = {
         0.151f, -0.110f, - 0.2f, 0.0f, 0.0f,
         0.236f, -0.110f, - 0.2f, 1.0f, 0.0f,
@@ -3535,25 +2952,6 @@ void Game::end_game_stats()
         0.236f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_secVAO2);
-	glBindVertexArray(l3_secVAO2);
-
-	glGenBuffers(1, &l3_secVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_secVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_sec2), l3_sec2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_secEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_secEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float l3_sec3[] = {
         0.236f, -0.110f, - 0.2f, 0.0f, 0.0f,
         0.406f, -0.110f, - 0.2f, 1.0f, 0.0f,
@@ -3561,24 +2959,7 @@ void Game::end_game_stats()
         0.406f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_secVAO3);
-	glBindVertexArray(l3_secVAO3);
-
-	glGenBuffers(1, &l3_secVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_secVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_sec3), l3_sec3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_secEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_secEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l3_secVAO3 = get_ui_quad("end_game_stats.l3_sec3", l3_sec3, sizeof(l3_sec3)).VAO;
     
     float l3_ms1[] = {
         0.406f, -0.110f, - 0.2f, 0.0f, 0.0f,
@@ -3587,25 +2968,6 @@ void Game::end_game_stats()
         0.491f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_msVAO1);
-	glBindVertexArray(l3_msVAO1);
-
-	glGenBuffers(1, &l3_msVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_msVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_ms1), l3_ms1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_msEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_msEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l3_ms2[] = {
         0.491f, -0.110f, - 0.2f, 0.0f, 0.0f,
         0.576f, -0.110f, - 0.2f, 1.0f, 0.0f,
@@ -3613,25 +2975,6 @@ void Game::end_game_stats()
         0.576f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_msVAO2);
-	glBindVertexArray(l3_msVAO2);
-
-	glGenBuffers(1, &l3_msVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_msVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_ms2), l3_ms2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_msEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_msEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float l3_ms3[] = {
         0.576f, -0.110f, - 0.2f, 0.0f, 0.0f,
         0.746f, -0.110f, - 0.2f, 1.0f, 0.0f,
@@ -3639,24 +2982,7 @@ void Game::end_game_stats()
         0.746f, 0.073f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &l3_msVAO3);
-	glBindVertexArray(l3_msVAO3);
-
-	glGenBuffers(1, &l3_msVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, l3_msVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(l3_ms3), l3_ms3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &l3_msEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, l3_msEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint l3_msVAO3 = get_ui_quad("end_game_stats.l3_ms3", l3_ms3, sizeof(l3_ms3)).VAO;
     
     float total_min1[] = {
         -0.274f, -0.27593f, - 0.2f, 0.0f, 0.0f,
@@ -3665,50 +2991,12 @@ void Game::end_game_stats()
         -0.189f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_minVAO1);
-	glBindVertexArray(total_minVAO1);
-
-	glGenBuffers(1, &total_minVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, total_minVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_min1), total_min1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_minEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_minEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
     float total_min2[] = {
         -0.189f, -0.27593f, - 0.2f, 0.0f, 0.0f,
         -0.104f, -0.27593f, - 0.2f, 1.0f, 0.0f,
         -0.189f, -0.11293f, - 0.2f, 0.0f, 1.0f,
         -0.104f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
-    
-    glGenVertexArrays(1, &total_minVAO2);
-	glBindVertexArray(total_minVAO2);
-
-	glGenBuffers(1, &total_minVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, total_minVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_min2), total_min2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_minEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_minEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
 
     float total_min3[] = {
         -0.104f, -0.27593f, - 0.2f, 0.0f, 0.0f,
@@ -3717,24 +3005,7 @@ void Game::end_game_stats()
         0.066f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_minVAO3);
-	glBindVertexArray(total_minVAO3);
-
-	glGenBuffers(1, &total_minVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, total_minVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_min3), total_min3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_minEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_minEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint total_minVAO3 = get_ui_quad("end_game_stats.total_min3", total_min3, sizeof(total_min3)).VAO;
 
     float total_sec1[] = {
         0.066f, -0.27593f, - 0.2f, 0.0f, 0.0f,
@@ -3743,25 +3014,6 @@ void Game::end_game_stats()
         0.151f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_secVAO1);
-	glBindVertexArray(total_secVAO1);
-
-	glGenBuffers(1, &total_secVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, total_secVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_sec1), total_sec1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_secEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_secEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float total_sec2[] = {
         0.151f, -0.27593f, - 0.2f, 0.0f, 0.0f,
         0.236f, -0.27593f, - 0.2f, 1.0f, 0.0f,
@@ -3769,25 +3021,6 @@ void Game::end_game_stats()
         0.236f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_secVAO2);
-	glBindVertexArray(total_secVAO2);
-
-	glGenBuffers(1, &total_secVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, total_secVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_sec2), total_sec2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_secEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_secEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float total_sec3[] = {
         0.236f, -0.27593f, - 0.2f, 0.0f, 0.0f,
         0.406f, -0.27593f, - 0.2f, 1.0f, 0.0f,
@@ -3795,24 +3028,7 @@ void Game::end_game_stats()
         0.406f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_secVAO3);
-	glBindVertexArray(total_secVAO3);
-
-	glGenBuffers(1, &total_secVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, total_secVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_sec3), total_sec3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_secEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_secEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint total_secVAO3 = get_ui_quad("end_game_stats.total_sec3", total_sec3, sizeof(total_sec3)).VAO;
     
     float total_ms1[] = {
         0.406f, -0.27593f, - 0.2f, 0.0f, 0.0f,
@@ -3821,50 +3037,12 @@ void Game::end_game_stats()
         0.491f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_msVAO1);
-	glBindVertexArray(total_msVAO1);
-
-	glGenBuffers(1, &total_msVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, total_msVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_ms1), total_ms1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_msEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_msEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
-    float total_ms2[] = {
-        0.491f, -0.27593f, - 0.2f, 0.0f, 0.0f,
-        0.576f, -0.27593f, - 0.2f, 1.0f, 0.0f,
-        0.491f, -0.11293f, - 0.2f, 0.0f, 1.0f,
-        0.576f, -0.11293f, - 0.2f, 1.0f, 1.0f
-    };
-
-    glGenVertexArrays(1, &total_msVAO2);
-	glBindVertexArray(total_msVAO2);
-
-	glGenBuffers(1, &total_msVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, total_msVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_ms2), total_ms2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_msEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_msEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    float total_ms2[] = {
+        0.491f, -0.27593f, - 0.2f, 0.0f, 0.0f,
+        0.576f, -0.27593f, - 0.2f, 1.0f, 0.0f,
+        0.491f, -0.11293f, - 0.2f, 0.0f, 1.0f,
+        0.576f, -0.11293f, - 0.2f, 1.0f, 1.0f
+    };
 
     float total_ms3[] = {
         0.576f, -0.27593f, - 0.2f, 0.0f, 0.0f,
@@ -3873,24 +3051,7 @@ void Game::end_game_stats()
         0.746f, -0.11293f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &total_msVAO3);
-	glBindVertexArray(total_msVAO3);
-
-	glGenBuffers(1, &total_msVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, total_msVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(total_ms3), total_ms3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &total_msEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, total_msEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint total_msVAO3 = get_ui_quad("end_game_stats.total_ms3", total_ms3, sizeof(total_ms3)).VAO;
     
     float avg_d1[] = {
         -0.274f, -0.4662f, - 0.2f, 0.0f, 0.0f,
@@ -3899,25 +3060,6 @@ void Game::end_game_stats()
         -0.189f, -0.3032f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &avgVAO1);
-	glBindVertexArray(avgVAO1);
-
-	glGenBuffers(1, &avgVBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, avgVBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(avg_d1), avg_d1, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &avgEBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, avgEBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float avg_d2[] = {
         -0.189f, -0.4662f, - 0.2f, 0.0f, 0.0f,
         -0.104f, -0.4662f, - 0.2f, 1.0f, 0.0f,
@@ -3925,25 +3067,6 @@ void Game::end_game_stats()
         -0.104f, -0.3032f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &avgVAO2);
-	glBindVertexArray(avgVAO2);
-
-	glGenBuffers(1, &avgVBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, avgVBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(avg_d2), avg_d2, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &avgEBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, avgEBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float avg_d3[] = {
         -0.104f, -0.4662f, - 0.2f, 0.0f, 0.0f,
         -0.019f, -0.4662f, - 0.2f, 1.0f, 0.0f,
@@ -3951,25 +3074,6 @@ void Game::end_game_stats()
         -0.019f, -0.3032f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &avgVAO3);
-	glBindVertexArray(avgVAO3);
-
-	glGenBuffers(1, &avgVBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, avgVBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(avg_d3), avg_d3, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &avgEBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, avgEBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-    
     float avg_d4[] = {
         -0.019f, -0.4662f, - 0.2f, 0.0f, 0.0f,
         0.181f, -0.4662f, - 0.2f, 1.0f, 0.0f,
@@ -3977,24 +3081,7 @@ void Game::end_game_stats()
         0.181f, -0.3032f, - 0.2f, 1.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &avgVAO4);
-	glBindVertexArray(avgVAO4);
-
-	glGenBuffers(1, &avgVBO4);
-	glBindBuffer(GL_ARRAY_BUFFER, avgVBO4);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(avg_d4), avg_d4, GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &avgEBO4);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, avgEBO4);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
+    GLuint avgVAO4 = get_ui_quad("end_game_stats.avg_d4", avg_d4, sizeof(avg_d4)).VAO;
 
     // use ui_shader
 	glActiveTexture(GL_TEXTURE0);
@@ -4011,146 +3098,6 @@ void Game::end_game_stats()
 		if(user_actions.clicked_main_menu)
 		{
 			show_end_game_stats = false;
-			
-            glDeleteBuffers(1, &VBO1);
-            glDeleteBuffers(1, &EBO1);
-			glDeleteVertexArrays(1, &VAO1);
-            
-            glDeleteBuffers(1, &l1_minVBO1);
-            glDeleteBuffers(1, &l1_minVBO2);
-            glDeleteBuffers(1, &l1_minVBO3);
-            glDeleteBuffers(1, &l1_secVBO1);
-            glDeleteBuffers(1, &l1_secVBO2);
-            glDeleteBuffers(1, &l1_secVBO3);
-            glDeleteBuffers(1, &l1_msVBO1);
-            glDeleteBuffers(1, &l1_msVBO2);
-            glDeleteBuffers(1, &l1_msVBO3);
-
-			glDeleteBuffers(1, &l1_minEBO1);
-			glDeleteBuffers(1, &l1_minEBO2);
-			glDeleteBuffers(1, &l1_minEBO3);
-			glDeleteBuffers(1, &l1_secEBO1);
-			glDeleteBuffers(1, &l1_secEBO2);
-			glDeleteBuffers(1, &l1_secEBO3);
-			glDeleteBuffers(1, &l1_msEBO1);
-			glDeleteBuffers(1, &l1_msEBO2);
-			glDeleteBuffers(1, &l1_msEBO3);
-
-			glDeleteVertexArrays(1, &l1_minVAO1);
-			glDeleteVertexArrays(1, &l1_minVAO2);
-			glDeleteVertexArrays(1, &l1_minVAO3);
-			glDeleteVertexArrays(1, &l1_secVAO1);
-			glDeleteVertexArrays(1, &l1_secVAO2);
-			glDeleteVertexArrays(1, &l1_secVAO3);
-			glDeleteVertexArrays(1, &l1_msVAO1);
-			glDeleteVertexArrays(1, &l1_msVAO2);
-			glDeleteVertexArrays(1, &l1_msVAO3);
-
-            glDeleteBuffers(1, &l2_minVBO1);
-            glDeleteBuffers(1, &l2_minVBO2);
-            glDeleteBuffers(1, &l2_minVBO3);
-            glDeleteBuffers(1, &l2_secVBO1);
-            glDeleteBuffers(1, &l2_secVBO2);
-            glDeleteBuffers(1, &l2_secVBO3);
-            glDeleteBuffers(1, &l2_msVBO1);
-            glDeleteBuffers(1, &l2_msVBO2);
-            glDeleteBuffers(1, &l2_msVBO3);
-
-			glDeleteBuffers(1, &l2_minEBO1);
-			glDeleteBuffers(1, &l2_minEBO2);
-			glDeleteBuffers(1, &l2_minEBO3);
-			glDeleteBuffers(1, &l2_secEBO1);
-			glDeleteBuffers(1, &l2_secEBO2);
-			glDeleteBuffers(1, &l2_secEBO3);
-			glDeleteBuffers(1, &l2_msEBO1);
-			glDeleteBuffers(1, &l2_msEBO2);
-			glDeleteBuffers(1, &l2_msEBO3);
-
-			glDeleteVertexArrays(1, &l2_minVAO1);
-			glDeleteVertexArrays(1, &l2_minVAO2);
-			glDeleteVertexArrays(1, &l2_minVAO3);
-			glDeleteVertexArrays(1, &l2_secVAO1);
-			glDeleteVertexArrays(1, &l2_secVAO2);
-			glDeleteVertexArrays(1, &l2_secVAO3);
-			glDeleteVertexArrays(1, &l2_msVAO1);
-			glDeleteVertexArrays(1, &l2_msVAO2);
-			glDeleteVertexArrays(1, &l2_msVAO3);
-            
-            glDeleteBuffers(1, &l3_minVBO1);
-            glDeleteBuffers(1, &l3_minVBO2);
-            glDeleteBuffers(1, &l3_minVBO3);
-            glDeleteBuffers(1, &l3_secVBO1);
-            glDeleteBuffers(1, &l3_secVBO2);
-            glDeleteBuffers(1, &l3_secVBO3);
-            glDeleteBuffers(1, &l3_msVBO1);
-            glDeleteBuffers(1, &l3_msVBO2);
-            glDeleteBuffers(1, &l3_msVBO3);
-
-			glDeleteBuffers(1, &l3_minEBO1);
-			glDeleteBuffers(1, &l3_minEBO2);
-			glDeleteBuffers(1, &l3_minEBO3);
-			glDeleteBuffers(1, &l3_secEBO1);
-			glDeleteBuffers(1, &l3_secEBO2);
-			glDeleteBuffers(1, &l3_secEBO3);
-			glDeleteBuffers(1, &l3_msEBO1);
-			glDeleteBuffers(1, &l3_msEBO2);
-			glDeleteBuffers(1, &l3_msEBO3);
-
-			glDeleteVertexArrays(1, &l3_minVAO1);
-			glDeleteVertexArrays(1, &l3_minVAO2);
-			glDeleteVertexArrays(1, &l3_minVAO3);
-			glDeleteVertexArrays(1, &l3_secVAO1);
-			glDeleteVertexArrays(1, &l3_secVAO2);
-			glDeleteVertexArrays(1, &l3_secVAO3);
-			glDeleteVertexArrays(1, &l3_msVAO1);
-			glDeleteVertexArrays(1, &l3_msVAO2);
-			glDeleteVertexArrays(1, &l3_msVAO3);
-            
-            glDeleteBuffers(1, &total_minVBO1);
-            glDeleteBuffers(1, &total_minVBO2);
-            glDeleteBuffers(1, &total_minVBO3);
-            glDeleteBuffers(1, &total_secVBO1);
-            glDeleteBuffers(1, &total_secVBO2);
-            glDeleteBuffers(1, &total_secVBO3);
-            glDeleteBuffers(1, &total_msVBO1);
-            glDeleteBuffers(1, &total_msVBO2);
-            glDeleteBuffers(1, &total_msVBO3);
-
-			glDeleteBuffers(1, &total_minEBO1);
-			glDeleteBuffers(1, &total_minEBO2);
-			glDeleteBuffers(1, &total_minEBO3);
-			glDeleteBuffers(1, &total_secEBO1);
-			glDeleteBuffers(1, &total_secEBO2);
-			glDeleteBuffers(1, &total_secEBO3);
-			glDeleteBuffers(1, &total_msEBO1);
-			glDeleteBuffers(1, &total_msEBO2);
-			glDeleteBuffers(1, &total_msEBO3);
-
-			glDeleteVertexArrays(1, &total_minVAO1);
-			glDeleteVertexArrays(1, &total_minVAO2);
-			glDeleteVertexArrays(1, &total_minVAO3);
-			glDeleteVertexArrays(1, &total_secVAO1);
-			glDeleteVertexArrays(1, &total_secVAO2);
-			glDeleteVertexArrays(1, &total_secVAO3);
-			glDeleteVertexArrays(1, &total_msVAO1);
-			glDeleteVertexArrays(1, &total_msVAO2);
-			glDeleteVertexArrays(1, &total_msVAO3);
-            
-            glDeleteBuffers(1, &avgVBO1);
-            glDeleteBuffers(1, &avgVBO2);
-            glDeleteBuffers(1, &avgVBO3);
-            glDeleteBuffers(1, &avgVBO4);
-
-			glDeleteBuffers(1, &avgEBO1);
-			glDeleteBuffers(1, &avgEBO2);
-			glDeleteBuffers(1, &avgEBO3);
-			glDeleteBuffers(1, &avgEBO4);
-
-			glDeleteVertexArrays(1, &avgVAO1);
-			glDeleteVertexArrays(1, &avgVAO2);
-			glDeleteVertexArrays(1, &avgVAO3);
-			glDeleteVertexArrays(1, &avgVAO4);
-
 			user_actions.clicked_main_menu = false;
 		}
 
@@ -4167,14 +3114,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // draw l1_min1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_min_d0].id);
-		glBindVertexArray(l1_minVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap1_min_d0, hud_quad(l1_min1));
         
         // draw l1_min2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_min_d1].id);
-		glBindVertexArray(l1_minVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap1_min_d1, hud_quad(l1_min2));
         
         // draw l1_min3
         glBindTexture(GL_TEXTURE_2D, menu_textures[66].id);
@@ -4182,14 +3125,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw l1_sec1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_sec_d0].id);
-		glBindVertexArray(l1_secVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap1_sec_d0, hud_quad(l1_sec1));
         
         // draw l1_sec2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_sec_d1].id);
-		glBindVertexArray(l1_secVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap1_sec_d1, hud_quad(l1_sec2));
         
         // draw l1_sec3
         glBindTexture(GL_TEXTURE_2D, menu_textures[67].id);
@@ -4197,14 +3136,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw l1_ms1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_ms_d0].id);
-		glBindVertexArray(l1_msVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap1_ms_d0, hud_quad(l1_ms1));
         
         // draw l1_ms2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_ms_d1].id);
-		glBindVertexArray(l1_msVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap1_ms_d1, hud_quad(l1_ms2));
         
         // draw l1_ms3
         glBindTexture(GL_TEXTURE_2D, menu_textures[68].id);
@@ -4212,14 +3147,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // draw l2_min1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_min_d0].id);
-		glBindVertexArray(l2_minVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap2_min_d0, hud_quad(l2_min1));
         
         // draw l2_min2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_min_d1].id);
-		glBindVertexArray(l2_minVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap2_min_d1, hud_quad(l2_min2));
         
         // draw l2_min3
         glBindTexture(GL_TEXTURE_2D, menu_textures[66].id);
@@ -4227,14 +3158,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw l2_sec1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_sec_d0].id);
-		glBindVertexArray(l2_secVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap2_sec_d0, hud_quad(l2_sec1));
         
         // draw l2_sec2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_sec_d1].id);
-		glBindVertexArray(l2_secVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap2_sec_d1, hud_quad(l2_sec2));
         
         // draw l2_sec3
         glBindTexture(GL_TEXTURE_2D, menu_textures[67].id);
@@ -4242,14 +3169,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw l2_ms1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_ms_d0].id);
-		glBindVertexArray(l2_msVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap2_ms_d0, hud_quad(l2_ms1));
         
         // draw l2_ms2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_ms_d1].id);
-		glBindVertexArray(l2_msVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap2_ms_d1, hud_quad(l2_ms2));
         
         // draw l2_ms3
         glBindTexture(GL_TEXTURE_2D, menu_textures[68].id);
@@ -4257,14 +3180,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // draw l3_min1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_min_d0].id);
-		glBindVertexArray(l3_minVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap3_min_d0, hud_quad(l3_min1));
         
         // draw l3_min2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_min_d1].id);
-		glBindVertexArray(l3_minVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap3_min_d1, hud_quad(l3_min2));
         
         // draw l3_min3
         glBindTexture(GL_TEXTURE_2D, menu_textures[66].id);
@@ -4272,14 +3191,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw l3_sec1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_sec_d0].id);
-		glBindVertexArray(l3_secVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap3_sec_d0, hud_quad(l3_sec1));
         
         // draw l3_sec2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_sec_d1].id);
-		glBindVertexArray(l3_secVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap3_sec_d1, hud_quad(l3_sec2));
         
         // draw l3_sec3
         glBindTexture(GL_TEXTURE_2D, menu_textures[67].id);
@@ -4287,14 +3202,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw l3_ms1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_ms_d0].id);
-		glBindVertexArray(l3_msVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap3_ms_d0, hud_quad(l3_ms1));
         
         // draw l3_ms2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_ms_d1].id);
-		glBindVertexArray(l3_msVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + lap3_ms_d1, hud_quad(l3_ms2));
         
         // draw l3_ms3
         glBindTexture(GL_TEXTURE_2D, menu_textures[68].id);
@@ -4302,14 +3213,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw total_min1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + total_min_d0].id);
-		glBindVertexArray(total_minVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + total_min_d0, hud_quad(total_min1));
         
         // draw total_min2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + total_min_d1].id);
-		glBindVertexArray(total_minVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + total_min_d1, hud_quad(total_min2));
         
         // draw total_min3
         glBindTexture(GL_TEXTURE_2D, menu_textures[66].id);
@@ -4317,14 +3224,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw total_sec1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + total_sec_d0].id);
-		glBindVertexArray(total_secVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + total_sec_d0, hud_quad(total_sec1));
         
         // draw total_sec2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + total_sec_d1].id);
-		glBindVertexArray(total_secVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + total_sec_d1, hud_quad(total_sec2));
         
         // draw total_sec3
         glBindTexture(GL_TEXTURE_2D, menu_textures[67].id);
@@ -4332,14 +3235,10 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw total_ms1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + total_ms_d0].id);
-		glBindVertexArray(total_msVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + total_ms_d0, hud_quad(total_ms1));
         
         // draw total_ms2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + total_ms_d1].id);
-		glBindVertexArray(total_msVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + total_ms_d1, hud_quad(total_ms2));
         
         // draw total_ms3
         glBindTexture(GL_TEXTURE_2D, menu_textures[68].id);
@@ -4347,905 +3246,96 @@ void Game::end_game_stats()
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         // draw avg1
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + ((avg_speed / 100) % 10)].id);
-		glBindVertexArray(avgVAO1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + ((avg_speed / 100) % 10), hud_quad(avg_d1));
         
         // draw avg2
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + ((avg_speed / 10) % 10)].id);
-		glBindVertexArray(avgVAO2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + ((avg_speed / 10) % 10), hud_quad(avg_d2));
         
         // draw avg3
-        glBindTexture(GL_TEXTURE_2D, menu_textures[47 + (avg_speed % 10)].id);
-		glBindVertexArray(avgVAO3);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        hud->add_quad(47 + (avg_speed % 10), hud_quad(avg_d3));
         
         // draw avg4
         glBindTexture(GL_TEXTURE_2D, menu_textures[69].id);
 		glBindVertexArray(avgVAO4);
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        
-		SDL_GL_SwapWindow(window);
-	}
-
-	start();
-}
-
-void Game::play()
-{
-    // set to fullscreen
-    SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN);
-    SDL_GetWindowSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-	update_menu_bb(width, height);
-    update_framebuffers();
-    minimap->update_framebuffer(width, height);
-
-    // hide cursor
-    SDL_ShowCursor(SDL_DISABLE);
-	
-    // set current page
-	current_page = RACE;
-
-	// clear color
-	glClearColor(Color::LIGHT_GREY[0], Color::LIGHT_GREY[1], Color::LIGHT_GREY[2], Color::LIGHT_GREY[3]);
-	
-	// gamma correction
-	glEnable(GL_FRAMEBUFFER_SRGB);
-	
-	// set proper camera
-	//cam = editor_cam;
-	cam = racing_cam;
-
-	// geometry
-	int indices[] = {0, 1, 2, 2, 1, 3};
-
-	// post process quad and its shadow & grey shaders
-	float quad[] =
-	{
-		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-		1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
-		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-		1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
-		-1.0f, 1.0f, 0.0f, 0.0f, 1.0f
-	};
-
-	GLuint VAO, VBO;
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quad), &quad, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glBindVertexArray(0);
-	
-	Shader shadow_shader("../shaders/shadows/vertex.glsl", "../shaders/shadows/fragment.glsl", "../shaders/shadows/geometry.glsl");
-	Shader grey_shader("../shaders/greyscale/vertex.glsl", "../shaders/greyscale/fragment.glsl", "../shaders/greyscale/geometry.glsl");
-	Shader motionBlur_shader("../shaders/motion_blur/vertex.glsl", "../shaders/motion_blur/fragment.glsl", "../shaders/motion_blur/geometry.glsl");
-	motionBlur_shader.use();
-	motionBlur_shader.set_float("width", static_cast<float>(width));
-	motionBlur_shader.set_float("height", static_cast<float>(height));
-	Shader gaussian_blur_shader("../shaders/gaussian_blur/vertex.glsl", "../shaders/gaussian_blur/fragment.glsl", "../shaders/gaussian_blur/geometry.glsl");
-	Shader color_shader("../shaders/color_pass/vertex.glsl", "../shaders/color_pass/fragment.glsl", "../shaders/color_pass/geometry.glsl");
-	Shader final_shader("../shaders/final_pass/vertex.glsl", "../shaders/final_pass/fragment.glsl", "../shaders/final_pass/geometry.glsl");
-
-	Shader countdown_shader("../shaders/countdown/vertex.glsl", "../shaders/countdown/fragment.glsl", "../shaders/countdown/geometry.glsl");
-	countdown_shader.use();
-	countdown_shader.set_float("alpha", 1.0f);
-	countdown_shader.set_int("img", 0);
-	
-	// countdown
-	float countdown[] =
-	{
-		-0.328f / 2.0, (-0.656f / 2.0) + 0.15f, -0.6f, 0.0f, 0.0f,
-		0.328f / 2.0, (-0.656f / 2.0) + 0.15f, -0.6f, 1.0f, 0.0f,
-		-0.328f / 2.0, (0.656f / 2.0) + 0.15f, -0.6f, 0.0f, 1.0f,
-		0.328f / 2.0, (0.656f / 2.0) + 0.15f, -0.6f, 1.0f, 1.0f
-	};
-	
-	GLuint countdownVAO, countdownVBO, countdownEBO;
-	glGenVertexArrays(1, &countdownVAO);
-	glBindVertexArray(countdownVAO);
-
-	glGenBuffers(1, &countdownVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, countdownVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(countdown), &countdown, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &countdownEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, countdownEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// quit game pop-up
-	float quit[] =
-	{
-		-0.3f, 0.0f, -0.15f, 0.0f, 0.0f,
-		0.3f, 0.0f, -0.15f, 1.0f, 0.0f,
-		-0.3f, 0.6f, -0.15f, 0.0f, 1.0f,
-		0.3f, 0.6f, -0.15f, 1.0f, 1.0f
-	};
-
-	GLuint VAO1, VBO1, EBO1;
-	glGenVertexArrays(1, &VAO1);
-	glBindVertexArray(VAO1);
-
-	glGenBuffers(1, &VBO1);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO1);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quit), &quit, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &EBO1);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO1);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
 
-	// HUD speed
-	float HUD_speed[] =
-	{
-		-1.0f, -1.0f, -0.045f, 0.0f, 0.0f,
-		-0.5f, -1.0f, -0.045f, 1.0f, 0.0f,
-		-1.0f, -0.5f, -0.045f, 0.0f, 1.0f,
-		-0.5f, -0.5f, -0.045f, 1.0f, 1.0f
-	};
-	
-	GLuint VAO2, VBO2, EBO2;
-	glGenVertexArrays(1, &VAO2);
-	glBindVertexArray(VAO2);
 
-	glGenBuffers(1, &VBO2);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_speed), &HUD_speed, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &EBO2);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO2);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD speed bar
-	float HUD_speed_bar[] =
-	{
-		-0.608f, -0.9488f, -0.05f, 0.0f, 0.0f,
-		-0.548f, -0.9488f, -0.05f, 1.0f, 0.0f,
-		-0.608f, -0.5488f, -0.05f, 0.0f, 1.0f,
-		-0.548f, -0.5488f, -0.05f, 1.0f, 1.0f
-	};
-	
-	GLuint VAO3, VBO3, EBO3;
-	glGenVertexArrays(1, &VAO3);
-	glBindVertexArray(VAO3);
-
-	glGenBuffers(1, &VBO3);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO3);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_speed_bar), &HUD_speed_bar, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &EBO3);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO3);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD speed digits
-	float speed_digit0[] =
-	{
-		-0.897f, -0.847f, -0.05f, 0.0f, 0.0f,
-		-0.812f, -0.847f, -0.05f, 1.0f, 0.0f,
-		-0.897f, -0.677f, -0.05f, 0.0f, 1.0f,
-		-0.812f, -0.677f, -0.05f, 1.0f, 1.0f
-	};
-	float speed_digit1[] =
-	{
-		-0.812f, -0.847f, -0.05f, 0.0f, 0.0f,
-		-0.735f, -0.847f, -0.05f, 1.0f, 0.0f,
-		-0.812f, -0.677f, -0.05f, 0.0f, 1.0f,
-		-0.735f, -0.677f, -0.05f, 1.0f, 1.0f
-	};
-	float speed_digit2[] =
-	{
-		-0.735f, -0.847f, -0.05f, 0.0f, 0.0f,
-		-0.655f, -0.847f, -0.05f, 1.0f, 0.0f,
-		-0.735f, -0.677f, -0.05f, 0.0f, 1.0f,
-		-0.655f, -0.677f, -0.05f, 1.0f, 1.0f
-	};
-	
-	GLuint VAO4, VBO4, EBO4;
-	GLuint VAO5, VBO5, EBO5;
-	GLuint VAO6, VBO6, EBO6;
-
-	glGenVertexArrays(1, &VAO4);
-	glBindVertexArray(VAO4);
-	glGenBuffers(1, &VBO4);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO4);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(speed_digit0), &speed_digit0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &EBO4);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO4);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	glBindVertexArray(0);
-	
-	glGenVertexArrays(1, &VAO5);
-	glBindVertexArray(VAO5);
-	glGenBuffers(1, &VBO5);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO5);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(speed_digit1), &speed_digit1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &EBO5);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO5);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	glBindVertexArray(0);
-	
-	glGenVertexArrays(1, &VAO6);
-	glBindVertexArray(VAO6);
-	glGenBuffers(1, &VBO6);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO6);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(speed_digit2), &speed_digit2, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &EBO6);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO6);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	glBindVertexArray(0);
-	
-	// HUD top bar
-	float HUD_top_bar[] =
-	{
-		-1.0f, 0.6f, -0.5f, 0.0f, 0.0f,
-		1.0f, 0.6f, -0.5f, 1.0f, 0.0f,
-		-1.0f, 1.0f, -0.5f, 0.0f, 1.0f,
-		1.0f, 1.0f, -0.5f, 1.0f, 1.0f
-	};
-	
-	GLuint topBarVAO, topBarVBO, topBarEBO;
-	glGenVertexArrays(1, &topBarVAO);
-	glBindVertexArray(topBarVAO);
-
-	glGenBuffers(1, &topBarVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, topBarVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_top_bar), &HUD_top_bar, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &topBarEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, topBarEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD lap current
-	float HUD_lap_current[] =
-	{
-		-0.847f, 0.817f, -0.55f, 0.0f, 0.0f,
-		-0.777f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.847f, 0.99f, -0.55f, 0.0f, 1.0f,
-		-0.777f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint currLapVAO, currLapVBO, currLapEBO;
-	glGenVertexArrays(1, &currLapVAO);
-	glBindVertexArray(currLapVAO);
-
-	glGenBuffers(1, &currLapVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, currLapVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lap_current), &HUD_lap_current, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &currLapEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, currLapEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD lap slash
-	float HUD_lap_slash[] =
-	{
-		-0.777f, 0.817f, -0.55f, 0.0f, 0.0f,
-		-0.707f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.777f, 0.990f, -0.55f, 0.0f, 1.0f,
-		-0.707f, 0.990f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint slashLapVAO, slashLapVBO, slashLapEBO;
-	glGenVertexArrays(1, &slashLapVAO);
-	glBindVertexArray(slashLapVAO);
-
-	glGenBuffers(1, &slashLapVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, slashLapVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lap_slash), &HUD_lap_slash, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &slashLapEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, slashLapEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD lap max
-	float HUD_lap_max[] =
-	{
-		-0.707f, 0.817f, -0.55f, 0.0f, 0.0f,
-		-0.637f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.707f, 0.99f, -0.55f, 0.0f, 1.0f,
-		-0.637f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint maxLapVAO, maxLapVBO, maxLapEBO;
-	glGenVertexArrays(1, &maxLapVAO);
-	glBindVertexArray(maxLapVAO);
-
-	glGenBuffers(1, &maxLapVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, maxLapVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lap_max), &HUD_lap_max, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &maxLapEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, maxLapEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD pos
-	float HUD_pos[] =
-	{
-		0.637f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.707f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.637f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.707f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint posVAO, posVBO, posEBO;
-	glGenVertexArrays(1, &posVAO);
-	glBindVertexArray(posVAO);
-
-	glGenBuffers(1, &posVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, posVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_pos), &HUD_pos, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &posEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, posEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD pos slash
-	float HUD_pos_slash[] =
-	{
-		0.707f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.777f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.707f, 0.990f, -0.55f, 0.0f, 1.0f,
-		0.777f, 0.990f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint slashPosVAO, slashPosVBO, slashPosEBO;
-	glGenVertexArrays(1, &slashPosVAO);
-	glBindVertexArray(slashPosVAO);
-
-	glGenBuffers(1, &slashPosVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, slashPosVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_pos_slash), &HUD_pos_slash, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &slashPosEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, slashPosEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD pos max
-	float HUD_pos_max[] =
-	{
-		0.777f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.847f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.777f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.847f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint maxPosVAO, maxPosVBO, maxPosEBO;
-	glGenVertexArrays(1, &maxPosVAO);
-	glBindVertexArray(maxPosVAO);
-
-	glGenBuffers(1, &maxPosVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, maxPosVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_pos_max), &HUD_pos_max, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &maxPosEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, maxPosEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD chrono min
-	float HUD_chrono_min_d0[] =
-	{
-		-0.212f, 0.817f, -0.55f, 0.0f, 0.0f,
-		-0.159f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.212f, 0.99f, -0.55f, 0.0f, 1.0f,
-		-0.159f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoMinD0VAO, chronoMinD0VBO, chronoMinD0EBO;
-	glGenVertexArrays(1, &chronoMinD0VAO);
-	glBindVertexArray(chronoMinD0VAO);
-
-	glGenBuffers(1, &chronoMinD0VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoMinD0VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_min_d0), &HUD_chrono_min_d0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoMinD0EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoMinD0EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	float HUD_chrono_min_d1[] =
-	{
-		-0.159f, 0.817f, -0.55f, 0.0f, 0.0f,
-		-0.106f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.159f, 0.99f, -0.55f, 0.0f, 1.0f,
-		-0.106f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoMinD1VAO, chronoMinD1VBO, chronoMinD1EBO;
-	glGenVertexArrays(1, &chronoMinD1VAO);
-	glBindVertexArray(chronoMinD1VAO);
-
-	glGenBuffers(1, &chronoMinD1VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoMinD1VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_min_d1), &HUD_chrono_min_d1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoMinD1EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoMinD1EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD chrono 2dots
-	float HUD_chrono_2dots[] =
-	{
-		-0.106f, 0.817f, -0.55f, 0.0f, 0.0f,
-		-0.053f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.106f, 0.99f, -0.55f, 0.0f, 1.0f,
-		-0.053f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chrono2DotsVAO, chrono2DotsVBO, chrono2DotsEBO;
-	glGenVertexArrays(1, &chrono2DotsVAO);
-	glBindVertexArray(chrono2DotsVAO);
-
-	glGenBuffers(1, &chrono2DotsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chrono2DotsVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_2dots), &HUD_chrono_2dots, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chrono2DotsEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chrono2DotsEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD chrono sec d0
-	float HUD_chrono_sec_d0[] =
-	{
-		-0.053f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.0f, 0.817f, -0.55f, 1.0f, 0.0f,
-		-0.053f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.0f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoSecD0VAO, chronoSecD0VBO, chronoSecD0EBO;
-	glGenVertexArrays(1, &chronoSecD0VAO);
-	glBindVertexArray(chronoSecD0VAO);
-
-	glGenBuffers(1, &chronoSecD0VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoSecD0VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_sec_d0), &HUD_chrono_sec_d0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoSecD0EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoSecD0EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD chrono sec d1
-	float HUD_chrono_sec_d1[] =
-	{
-		0.0f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.053f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.0f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.053f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoSecD1VAO, chronoSecD1VBO, chronoSecD1EBO;
-	glGenVertexArrays(1, &chronoSecD1VAO);
-	glBindVertexArray(chronoSecD1VAO);
-
-	glGenBuffers(1, &chronoSecD1VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoSecD1VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_sec_d1), &HUD_chrono_sec_d1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoSecD1EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoSecD1EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD chrono dot
-	float HUD_chrono_dot[] =
-	{
-		0.053f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.106f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.053f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.106f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoDotVAO, chronoDotVBO, chronoDotEBO;
-	glGenVertexArrays(1, &chronoDotVAO);
-	glBindVertexArray(chronoDotVAO);
-
-	glGenBuffers(1, &chronoDotVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoDotVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_dot), &HUD_chrono_dot, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoDotEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoDotEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD chrono ms d0
-	float HUD_chrono_ms_d0[] =
-	{
-		0.106f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.159f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.106f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.159f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoMsD0VAO, chronoMsD0VBO, chronoMsD0EBO;
-	glGenVertexArrays(1, &chronoMsD0VAO);
-	glBindVertexArray(chronoMsD0VAO);
-
-	glGenBuffers(1, &chronoMsD0VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoMsD0VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_ms_d0), &HUD_chrono_ms_d0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoMsD0EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoMsD0EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD chrono ms d1
-	float HUD_chrono_ms_d1[] =
-	{
-		0.159f, 0.817f, -0.55f, 0.0f, 0.0f,
-		0.212f, 0.817f, -0.55f, 1.0f, 0.0f,
-		0.159f, 0.99f, -0.55f, 0.0f, 1.0f,
-		0.212f, 0.99f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint chronoMsD1VAO, chronoMsD1VBO, chronoMsD1EBO;
-	glGenVertexArrays(1, &chronoMsD1VAO);
-	glBindVertexArray(chronoMsD1VAO);
-
-	glGenBuffers(1, &chronoMsD1VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, chronoMsD1VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_chrono_ms_d1), &HUD_chrono_ms_d1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &chronoMsD1EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chronoMsD1EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-    
-    // HUD lap_time min
-	float HUD_lapTime_min_d0[] =
-	{
-		-0.212f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		-0.159f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		-0.212f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		-0.159f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint lapTimeMinD0VAO, lapTimeMinD0VBO, lapTimeMinD0EBO;
-	glGenVertexArrays(1, &lapTimeMinD0VAO);
-	glBindVertexArray(lapTimeMinD0VAO);
+        // digits come from the HUD atlas, drawn in one batch
+        hud->flush(*ui_shader);
+        
+		end_frame();
+	}
 
-	glGenBuffers(1, &lapTimeMinD0VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeMinD0VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_min_d0), &HUD_lapTime_min_d0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeMinD0EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeMinD0EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	float HUD_lapTime_min_d1[] =
-	{
-		-0.159f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		-0.106f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		-0.159f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		-0.106f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
-	};
-	
-	GLuint lapTimeMinD1VAO, lapTimeMinD1VBO, lapTimeMinD1EBO;
-	glGenVertexArrays(1, &lapTimeMinD1VAO);
-	glBindVertexArray(lapTimeMinD1VAO);
+	next_page = MAIN;
+}
 
-	glGenBuffers(1, &lapTimeMinD1VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeMinD1VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_min_d1), &HUD_lapTime_min_d1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeMinD1EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeMinD1EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+void Game::play()
+{
+    // set to fullscreen
+    SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN);
+    SDL_GetWindowSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+	update_menu_bb(width, height);
+    update_framebuffers();
+    minimap->update_framebuffer(width, height);
+    depth_history = false;
+    draw_master->get_occlusion().invalidate();
 
-	// HUD lap_time 2dots
-	float HUD_lapTime_2dots[] =
-	{
-		-0.106f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		-0.053f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		-0.106f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		-0.053f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
-	};
+    // hide cursor
+    SDL_ShowCursor(SDL_DISABLE);
 	
-	GLuint lapTime2DotsVAO, lapTime2DotsVBO, lapTime2DotsEBO;
-	glGenVertexArrays(1, &lapTime2DotsVAO);
-	glBindVertexArray(lapTime2DotsVAO);
+    // set current page
+	current_page = RACE;
 
-	glGenBuffers(1, &lapTime2DotsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTime2DotsVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_2dots), &HUD_lapTime_2dots, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTime2DotsEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTime2DotsEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
+	// clear color
+	glClearColor(Color::LIGHT_GREY[0], Color::LIGHT_GREY[1], Color::LIGHT_GREY[2], Color::LIGHT_GREY[3]);
 	
-	// HUD lap_time sec d0
-	float HUD_lapTime_sec_d0[] =
-	{
-		-0.053f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		0.0f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		-0.053f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		0.0f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
-	};
+	// gamma correction
+	glEnable(GL_FRAMEBUFFER_SRGB);
 	
-	GLuint lapTimeSecD0VAO, lapTimeSecD0VBO, lapTimeSecD0EBO;
-	glGenVertexArrays(1, &lapTimeSecD0VAO);
-	glBindVertexArray(lapTimeSecD0VAO);
+	// set proper camera
+	//cam = editor_cam;
+	cam = racing_cam;
 
-	glGenBuffers(1, &lapTimeSecD0VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeSecD0VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_sec_d0), &HUD_lapTime_sec_d0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeSecD0EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeSecD0EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD lap_time sec d1
-	float HUD_lapTime_sec_d1[] =
+	// post process quad
+	float quad[] =
 	{
-		0.0f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		0.053f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		0.0f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		0.053f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
+		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+		-1.0f, 1.0f, 0.0f, 0.0f, 1.0f
 	};
-	
-	GLuint lapTimeSecD1VAO, lapTimeSecD1VBO, lapTimeSecD1EBO;
-	glGenVertexArrays(1, &lapTimeSecD1VAO);
-	glBindVertexArray(lapTimeSecD1VAO);
 
-	glGenBuffers(1, &lapTimeSecD1VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeSecD1VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_sec_d1), &HUD_lapTime_sec_d1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeSecD1EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeSecD1EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-	
-	// HUD lap_time dot
-	float HUD_lapTime_dot[] =
-	{
-		0.053f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		0.106f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		0.053f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		0.106f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
-	};
+	GLuint VAO = get_ui_quad("post_process_quad", quad, sizeof(quad)).VAO;
 	
-	GLuint lapTimeDotVAO, lapTimeDotVBO, lapTimeDotEBO;
-	glGenVertexArrays(1, &lapTimeDotVAO);
-	glBindVertexArray(lapTimeDotVAO);
-
-	glGenBuffers(1, &lapTimeDotVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeDotVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_dot), &HUD_lapTime_dot, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeDotEBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeDotEBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	// post process shaders are compiled once, only the viewport dependent uniforms change
+	motionBlur_shader->use();
+	motionBlur_shader->set_float("width", static_cast<float>(width));
+	motionBlur_shader->set_float("height", static_cast<float>(height));
 	
-	glBindVertexArray(0);
-
-	// HUD lap_time ms d0
-	float HUD_lapTime_ms_d0[] =
+	// countdown
+	float countdown[] =
 	{
-		0.106f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		0.159f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		0.106f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		0.159f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
+		-0.328f / 2.0, (-0.656f / 2.0) + 0.15f, -0.6f, 0.0f, 0.0f,
+		0.328f / 2.0, (-0.656f / 2.0) + 0.15f, -0.6f, 1.0f, 0.0f,
+		-0.328f / 2.0, (0.656f / 2.0) + 0.15f, -0.6f, 0.0f, 1.0f,
+		0.328f / 2.0, (0.656f / 2.0) + 0.15f, -0.6f, 1.0f, 1.0f
 	};
 	
-	GLuint lapTimeMsD0VAO, lapTimeMsD0VBO, lapTimeMsD0EBO;
-	glGenVertexArrays(1, &lapTimeMsD0VAO);
-	glBindVertexArray(lapTimeMsD0VAO);
+	GLuint countdownVAO = get_ui_quad("play.countdown", countdown, sizeof(countdown)).VAO;
 
-	glGenBuffers(1, &lapTimeMsD0VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeMsD0VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_ms_d0), &HUD_lapTime_ms_d0, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeMsD0EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeMsD0EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
-
-	// HUD lap_time ms d1
-	float HUD_lapTime_ms_d1[] =
+	// quit game pop-up
+	float quit[] =
 	{
-		0.159f, 0.817f - 0.45f, -0.55f, 0.0f, 0.0f,
-		0.212f, 0.817f - 0.45f, -0.55f, 1.0f, 0.0f,
-		0.159f, 0.99f - 0.45f, -0.55f, 0.0f, 1.0f,
-		0.212f, 0.99f - 0.45f, -0.55f, 1.0f, 1.0f
+		-0.3f, 0.0f, -0.15f, 0.0f, 0.0f,
+		0.3f, 0.0f, -0.15f, 1.0f, 0.0f,
+		-0.3f, 0.6f, -0.15f, 0.0f, 1.0f,
+		0.3f, 0.6f, -0.15f, 1.0f, 1.0f
 	};
-	
-	GLuint lapTimeMsD1VAO, lapTimeMsD1VBO, lapTimeMsD1EBO;
-	glGenVertexArrays(1, &lapTimeMsD1VAO);
-	glBindVertexArray(lapTimeMsD1VAO);
-
-	glGenBuffers(1, &lapTimeMsD1VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, lapTimeMsD1VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(HUD_lapTime_ms_d1), &HUD_lapTime_ms_d1, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glGenBuffers(1, &lapTimeMsD1EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lapTimeMsD1EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-	
-	glBindVertexArray(0);
 
-	// set HUD lap struct
-	hud_lap.current = currLapVAO;
-	hud_lap.slash = slashLapVAO;
-	hud_lap.max = maxLapVAO;
-	
-	// set HUD pos struct
-	hud_pos.pos = posVAO;
-	hud_pos.slash = slashPosVAO;
-	hud_pos.max = maxPosVAO;
-	
-	// set HUD chrono struct
-	chrono.min_d0 = chronoMinD0VAO;
-	chrono.min_d1 = chronoMinD1VAO;
-	chrono.dots2 = chrono2DotsVAO;
-	chrono.sec_d0 = chronoSecD0VAO;
-	chrono.sec_d1 = chronoSecD1VAO;
-	chrono.dot = chronoDotVAO;
-	chrono.ms_d0 = chronoMsD0VAO;
-	chrono.ms_d1 = chronoMsD1VAO;
-	
-    // set HUD lap_time struct
-	lap_time.min_d0 = lapTimeMinD0VAO;
-	lap_time.min_d1 = lapTimeMinD1VAO;
-	lap_time.dots2 = lapTime2DotsVAO;
-	lap_time.sec_d0 = lapTimeSecD0VAO;
-	lap_time.sec_d1 = lapTimeSecD1VAO;
-	lap_time.dot = lapTimeDotVAO;
-	lap_time.ms_d0 = lapTimeMsD0VAO;
-	lap_time.ms_d1 = lapTimeMsD1VAO;
-
-	// set HUD speed struct
-	hud_speed.speed_bar = VAO3;
-	hud_speed.speed_bar_VBO = VBO3;
-	hud_speed.layout = VAO2;
-	hud_speed.d0 = VAO4;
-	hud_speed.d1 = VAO5;
-	hud_speed.d2 = VAO6;
+	GLuint VAO1 = get_ui_quad("play.quit", quit, sizeof(quit)).VAO;
 
 	// store previous camera's view matrix
 	bool first_loop = true;
@@ -5299,6 +3389,14 @@ void Game::play()
         // process drawable meshes list
         draw_master->process_drawable_meshes_list(cam->get_position(), cam->get_direction(), cam->get_vector_right(), cam->get_vector_up());
 
+        // occluders from the previous frame, the camera list is culled against them on its first draw
+        OcclusionCuller & occlusion = draw_master->get_occlusion();
+        if(occlusion.get_mode() == OCCLUSION_GPU && depth_history)
+            occlusion.build_hiz(depthTexture, width, height, depth_view_proj);
+        else if(occlusion.get_mode() == OCCLUSION_CPU)
+            occlusion.rasterize(cam->get_projection() * cam->get_view());
+        occlusion.report();
+
 		// shadowMap
 		if(cast_shadows && ! print_quit_game && ! check_render_pass)
 		{
@@ -5318,13 +3416,17 @@ void Game::play()
 		// draw post process quad and quit pop-up
 		if(print_quit_game)
 		{
-			prepare_print_quit_game(VAO, VAO1, &grey_shader);
+			prepare_print_quit_game(VAO, VAO1, grey_shader);
 		}
 		else
 		{
 			// get proper view matrix (bullet or camera based + world step sim)
 			if(!check_render_pass)
+			{
 				set_view_matrix(first_loop);
+				pod->update_effects(delta);
+			}
+			update_poses();
 
 			// print quit game ?
 			if(exit_game)
@@ -5332,7 +3434,7 @@ void Game::play()
                 // show cursor
                 SDL_ShowCursor(SDL_ENABLE);
 				// show quit game
-                quit_game(hud_speed, topBarVAO, hud_lap, hud_pos, chrono);
+                quit_game(hud_speed, hud_top_bar, hud_lap, hud_pos, chrono);
 			}
 			// draw racing game
 			else
@@ -5343,10 +3445,10 @@ void Game::play()
                 // check render pass
 				if(check_render_pass)
 				{
-					view_render_pass(VAO, color_shader);
+					view_render_pass(VAO, *color_shader);
 					
 					// =-=-=-=-= final pass =-=-=-=-=
-					render_HUD(final_shader, VAO, hud_speed, topBarVAO, hud_lap, hud_pos, chrono, true);
+					render_HUD(*final_shader, VAO, hud_speed, hud_top_bar, hud_lap, hud_pos, chrono, true);
 				}
 				else
 				{
@@ -5360,10 +3462,10 @@ void Game::play()
 					render_depth_texture();
 
 					// env motion blur pass
-					render_env_motion_blur_texture(VAO, motionBlur_shader);
+					render_env_motion_blur_texture(VAO, *motionBlur_shader);
 
 					// smoke motion blur pass
-					render_smoke_motion_blur_texture(VAO, motionBlur_shader);
+					render_smoke_motion_blur_texture(VAO, *motionBlur_shader);
 
 					// podracer pass
 					render_podracer();
@@ -5372,21 +3474,21 @@ void Game::play()
 					render_depth_texture(true);
 
 					// gaussian blur pass on bright colors
-					render_gaussian_blur_bright_colors(VAO, gaussian_blur_shader);
+					render_gaussian_blur_bright_colors(VAO, *gaussian_blur_shader);
 
 					// color pass
-					render_color(VAO, color_shader);
+					render_color(VAO, *color_shader);
 
 					// =-=-=-=-= final pass =-=-=-=-=
-					render_HUD(final_shader, VAO, hud_speed, topBarVAO, hud_lap, hud_pos, chrono);
+					render_HUD(*final_shader, VAO, hud_speed, hud_top_bar, hud_lap, hud_pos, chrono);
 		
 					// show countdown animation
 					if(countdown_timer >= 0)
-						process_countdown(countdownVAO, static_cast<float>(delta), countdown_shader);
+						process_countdown(countdownVAO, static_cast<float>(delta), *countdown_shader);
 				}
 			}
 		}
-		SDL_GL_SwapWindow(window);
+		end_frame();
 
         // update nb frames and accumulate pod speed
         nb_frames++;
@@ -5407,12 +3509,12 @@ void Game::play()
     {
         // calculate average pod speed
         avg_speed = avg_speed / nb_frames;
-	    end_game_stats();
+	    next_page = END_GAME_STATS;
     }
     else
     {
         reset();
-        start();
+        next_page = MAIN;
     }
 }
 
@@ -5445,7 +3547,7 @@ void Game::prepare_print_quit_game(GLuint VAO, GLuint VAO1, Shader* grey_shader)
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
-void Game::quit_game(HUD_speed& hud_speed, GLuint topBarVAO, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono)
+void Game::quit_game(HUD_speed& hud_speed, HudQuad& top_bar, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono)
 {
 	exit_game = false;
 	print_quit_game = true;
@@ -5470,7 +3572,10 @@ void Game::quit_game(HUD_speed& hud_speed, GLuint topBarVAO, HUD_lap& hud_lap, H
 	draw_speed_HUD(hud_speed);
 
 	// draw top bar HUD
-	draw_topBar_HUD(topBarVAO, hud_lap, hud_pos, chrono);
+	draw_topBar_HUD(top_bar, hud_lap, hud_pos, chrono);
+	ui_shader->use();
+	ui_shader->set_float("alpha", 1.0f);
+	hud->flush(*ui_shader);
 
 	// draw map HUD
 	draw_map_HUD(true);
@@ -5539,6 +3644,8 @@ void Game::render_depth_texture(bool podracerDepth)
 
 		// draw mos espa arena
 		env->draw(true, true);
+		depth_view_proj = cam->get_projection() * cam->get_view();
+		depth_history = true;
 
 		// draw skybox
 		glDepthFunc(GL_LEQUAL);
@@ -5769,7 +3876,7 @@ void Game::render_color(GLuint VAO, Shader& color_shader)
 	glDrawArrays(GL_TRIANGLES, 0, 6);
 }
 
-void Game::render_HUD(Shader& final_shader, GLuint VAO, HUD_speed& hud_speed, GLuint topBarVAO, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono, bool disable_HUD)
+void Game::render_HUD(Shader& final_shader, GLuint VAO, HUD_speed& hud_speed, HudQuad& top_bar, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono, bool disable_HUD)
 {
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	glEnable(GL_DEPTH);
@@ -5792,7 +3899,12 @@ void Game::render_HUD(Shader& final_shader, GLuint VAO, HUD_speed& hud_speed, GL
 		draw_speed_HUD(hud_speed);
 
 		// draw top bar HUD
-		draw_topBar_HUD(topBarVAO, hud_lap, hud_pos, chrono);
+		draw_topBar_HUD(top_bar, hud_lap, hud_pos, chrono);
+
+		// speed and top bar share one draw call
+		ui_shader->use();
+		ui_shader->set_float("alpha", 1.0f);
+		hud->flush(*ui_shader);
 
 		// draw map HUD
 		draw_map_HUD();
@@ -5935,164 +4047,73 @@ void Game::render_to_shadowMap(bool podShadowMap)
 
 void Game::draw_speed_HUD(HUD_speed& hud_speed)
 {
-	// HUD
-	ui_shader->use();
-	ui_shader->set_float("alpha", 1.0f);
-				
-	//draw HUD speed
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, menu_textures[33].id);
-	glBindVertexArray(hud_speed.layout);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-				
-	//draw HUD speed bar
+	// HUD speed
+	hud->add_quad(33, hud_speed.layout);
+
+	// HUD speed bar
 	int pod_speed = static_cast<int>(pod->speed);
-	float speed_bar_offset = pod->speed / 850.0f;
-	float HUD_speed_bar_update[] =
-	{
-		-0.608f, -0.9488f, -0.05f, 0.0f, 0.0f,
-		-0.548f, -0.9488f, -0.05f, 1.0f, 0.0f,
-		-0.608f, -0.9488f + (0.4f * speed_bar_offset), -0.05f, 0.0f, speed_bar_offset,
-		-0.548f, -0.9488f + (0.4f * speed_bar_offset), -0.05f, 1.0f, speed_bar_offset
-	};
-	glBindBuffer(GL_ARRAY_BUFFER, hud_speed.speed_bar_VBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(HUD_speed_bar_update), HUD_speed_bar_update);
-	glBindTexture(GL_TEXTURE_2D, menu_textures[34].id);
-	glBindVertexArray(hud_speed.speed_bar);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-				
-	// draw speed digits
+	hud->add_quad(34, hud_speed.speed_bar, pod->speed / 850.0f);
+
+	// speed digits
 	int digit_left = pod_speed / 100;
 	int digit_mid = (pod_speed / 10) % 10;
 	int digit_right = pod_speed % 10;
-				
+
 	if(digit_left != 0)
 	{
-		glBindTexture(GL_TEXTURE_2D, menu_textures[35 + digit_left].id);
-		glBindVertexArray(hud_speed.d0);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-				
-		glBindTexture(GL_TEXTURE_2D, menu_textures[35 + digit_mid].id);
-		glBindVertexArray(hud_speed.d1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-				
-		glBindTexture(GL_TEXTURE_2D, menu_textures[35 + digit_right].id);
-		glBindVertexArray(hud_speed.d2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		hud->add_quad(35 + digit_left, hud_speed.d0);
+		hud->add_quad(35 + digit_mid, hud_speed.d1);
+		hud->add_quad(35 + digit_right, hud_speed.d2);
 	}
 	else if(digit_mid != 0)
 	{
-		glBindTexture(GL_TEXTURE_2D, menu_textures[35 + digit_mid].id);
-		glBindVertexArray(hud_speed.d1);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-				
-		glBindTexture(GL_TEXTURE_2D, menu_textures[35 + digit_right].id);
-		glBindVertexArray(hud_speed.d2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		hud->add_quad(35 + digit_mid, hud_speed.d1);
+		hud->add_quad(35 + digit_right, hud_speed.d2);
 	}
 	else if(digit_right != 0)
 	{
-		glBindTexture(GL_TEXTURE_2D, menu_textures[35 + digit_right].id);
-		glBindVertexArray(hud_speed.d2);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		hud->add_quad(35 + digit_right, hud_speed.d2);
 	}
 }
 
-void Game::draw_topBar_HUD(GLuint topBarVAO, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono)
+void Game::draw_topBar_HUD(HudQuad& top_bar, HUD_lap& hud_lap, HUD_pos& hud_pos, HUD_chrono& chrono)
 {
-	// HUD
-	ui_shader->use();
-	ui_shader->set_float("alpha", 1.0f);
-				
-	//draw HUD top bar
-	glBindTexture(GL_TEXTURE_2D, menu_textures[46].id);
-	glBindVertexArray(topBarVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-	// draw HUD current lap
-    if(hit_count_lap_wall && lap_iterate < 3)
-    {
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[48 + lap_iterate].id);
-    }
-    else
-    {
-        if(lap_iterate == -1)
-	        glBindTexture(GL_TEXTURE_2D, menu_textures[48].id);
-        else
-        {
-            if(lap_iterate == 3)
-	            glBindTexture(GL_TEXTURE_2D, menu_textures[48 + lap_iterate - 1].id);
-            else
-	            glBindTexture(GL_TEXTURE_2D, menu_textures[48 + lap_iterate].id);
-        }
-    }
-	glBindVertexArray(hud_lap.current);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD max lap
-	glBindTexture(GL_TEXTURE_2D, menu_textures[50].id);
-	glBindVertexArray(hud_lap.max);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD slash lap
-	glBindTexture(GL_TEXTURE_2D, menu_textures[58].id);
-	glBindVertexArray(hud_lap.slash);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD pos
-	glBindTexture(GL_TEXTURE_2D, menu_textures[48].id);
-	glBindVertexArray(hud_pos.pos);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD slash pos
-	glBindTexture(GL_TEXTURE_2D, menu_textures[58].id);
-	glBindVertexArray(hud_pos.slash);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD max pos
-	glBindTexture(GL_TEXTURE_2D, menu_textures[48].id);
-	glBindVertexArray(hud_pos.max);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	// HUD top bar
+	hud->add_quad(46, top_bar);
+
+	// HUD current lap
+	int current_lap;
+	if(hit_count_lap_wall && lap_iterate < 3)
+		current_lap = lap_iterate;
+	else if(lap_iterate == -1)
+		current_lap = 0;
+	else if(lap_iterate == 3)
+		current_lap = lap_iterate - 1;
+	else
+		current_lap = lap_iterate;
+	hud->add_quad(48 + current_lap, hud_lap.current);
+
+	// HUD max lap, pos and slashes
+	hud->add_quad(50, hud_lap.max);
+	hud->add_quad(58, hud_lap.slash);
+	hud->add_quad(48, hud_pos.pos);
+	hud->add_quad(58, hud_pos.slash);
+	hud->add_quad(48, hud_pos.max);
+
+	// HUD chrono
+	add_chrono_quads(chrono, timer_min_d0, timer_min_d1, timer_sec_d0, timer_sec_d1, timer_ms_d0, timer_ms_d1);
+}
 
-	// draw HUD chrono min d0
-	glBindTexture(GL_TEXTURE_2D, menu_textures[47 + timer_min_d0].id);
-	glBindVertexArray(chrono.min_d0);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono min d1
-	glBindTexture(GL_TEXTURE_2D, menu_textures[47 + timer_min_d1].id);
-	glBindVertexArray(chrono.min_d1);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono 2 dots
-	glBindTexture(GL_TEXTURE_2D, menu_textures[57].id);
-	glBindVertexArray(chrono.dots2);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono sec d0
-	glBindTexture(GL_TEXTURE_2D, menu_textures[47 + timer_sec_d0].id);
-	glBindVertexArray(chrono.sec_d0);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono sec d1
-	glBindTexture(GL_TEXTURE_2D, menu_textures[47 + timer_sec_d1].id);
-	glBindVertexArray(chrono.sec_d1);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono dot
-	glBindTexture(GL_TEXTURE_2D, menu_textures[59].id);
-	glBindVertexArray(chrono.dot);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono ms d0
-	glBindTexture(GL_TEXTURE_2D, menu_textures[47 + timer_ms_d0].id);
-	glBindVertexArray(chrono.ms_d0);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	// draw HUD chrono ms d1
-	glBindTexture(GL_TEXTURE_2D, menu_textures[47 + timer_ms_d1].id);
-	glBindVertexArray(chrono.ms_d1);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+void Game::add_chrono_quads(HUD_chrono& quads, int min_d0, int min_d1, int sec_d0, int sec_d1, int ms_d0, int ms_d1)
+{
+	hud->add_quad(47 + min_d0, quads.min_d0);
+	hud->add_quad(47 + min_d1, quads.min_d1);
+	hud->add_quad(57, quads.dots2);
+	hud->add_quad(47 + sec_d0, quads.sec_d0);
+	hud->add_quad(47 + sec_d1, quads.sec_d1);
+	hud->add_quad(59, quads.dot);
+	hud->add_quad(47 + ms_d0, quads.ms_d0);
+	hud->add_quad(47 + ms_d1, quads.ms_d1);
 }
 
 void Game::draw_map_HUD(bool quit_game)
@@ -6160,138 +4181,20 @@ void Game::draw_lap_time(HUD_chrono& lap_time)
     }
 
 	// HUD
+    if(lap_iterate == 1)
+        add_chrono_quads(lap_time, lap1_min_d0, lap1_min_d1, lap1_sec_d0, lap1_sec_d1, lap1_ms_d0, lap1_ms_d1);
+    else if(lap_iterate == 2)
+        add_chrono_quads(lap_time, lap2_min_d0, lap2_min_d1, lap2_sec_d0, lap2_sec_d1, lap2_ms_d0, lap2_ms_d1);
+    else if(lap_iterate == 3)
+        add_chrono_quads(lap_time, lap3_min_d0, lap3_min_d1, lap3_sec_d0, lap3_sec_d1, lap3_ms_d0, lap3_ms_d1);
+
+	// second HUD batch, tinted by the lap timer animation
 	ui_shader->use();
 	ui_shader->set_float("alpha", 1.0f);
 	ui_shader->set_int("lap_timer_anim", 1);
     delta_anim += 0.3f;
 	ui_shader->set_float("delta_anim", delta_anim);
-
-    if(lap_iterate == 1)
-    {
-	    // draw HUD lap_time min d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_min_d0].id);
-	    glBindVertexArray(lap_time.min_d0);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time min d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_min_d1].id);
-	    glBindVertexArray(lap_time.min_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time 2 dots
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[57].id);
-	    glBindVertexArray(lap_time.dots2);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time sec d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_sec_d0].id);
-	    glBindVertexArray(lap_time.sec_d0);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time sec d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_sec_d1].id);
-	    glBindVertexArray(lap_time.sec_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time dot
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[59].id);
-	    glBindVertexArray(lap_time.dot);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time ms d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_ms_d0].id);
-	    glBindVertexArray(lap_time.ms_d0);
-    	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time ms d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap1_ms_d1].id);
-	    glBindVertexArray(lap_time.ms_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    }
-    else if(lap_iterate == 2)
-    {
-	    // draw HUD lap_time min d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_min_d0].id);
-	    glBindVertexArray(lap_time.min_d0);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time min d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_min_d1].id);
-	    glBindVertexArray(lap_time.min_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time 2 dots
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[57].id);
-	    glBindVertexArray(lap_time.dots2);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time sec d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_sec_d0].id);
-	    glBindVertexArray(lap_time.sec_d0);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time sec d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_sec_d1].id);
-	    glBindVertexArray(lap_time.sec_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time dot
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[59].id);
-	    glBindVertexArray(lap_time.dot);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time ms d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_ms_d0].id);
-	    glBindVertexArray(lap_time.ms_d0);
-    	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time ms d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap2_ms_d1].id);
-	    glBindVertexArray(lap_time.ms_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    }
-    else if(lap_iterate == 3)
-    {
-	    // draw HUD lap_time min d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_min_d0].id);
-	    glBindVertexArray(lap_time.min_d0);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time min d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_min_d1].id);
-	    glBindVertexArray(lap_time.min_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time 2 dots
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[57].id);
-	    glBindVertexArray(lap_time.dots2);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time sec d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_sec_d0].id);
-	    glBindVertexArray(lap_time.sec_d0);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time sec d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_sec_d1].id);
-	    glBindVertexArray(lap_time.sec_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time dot
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[59].id);
-	    glBindVertexArray(lap_time.dot);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time ms d0
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_ms_d0].id);
-	    glBindVertexArray(lap_time.ms_d0);
-    	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	
-	    // draw HUD lap_time ms d1
-	    glBindTexture(GL_TEXTURE_2D, menu_textures[47 + lap3_ms_d1].id);
-	    glBindVertexArray(lap_time.ms_d1);
-	    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    }
+	hud->flush(*ui_shader);
 	ui_shader->set_int("lap_timer_anim", 0);
 }
 
@@ -6303,6 +4206,8 @@ void Game::reset()
 	pod->reset();
 	env->reset();
     tatooine->reset();
+	depth_history = false;
+	draw_master->get_occlusion().invalidate();
 
 	timer = 0.0;
 	timer1 = 0.0;
@@ -6355,170 +4260,206 @@ void Game::reset()
 
 void Game::sound_system()
 {
-	static bool fire_power_coupling_done = false;
-	static bool power_coupling_running = false;
-	static bool start_electric_engine_done = false;
-	static bool electric_engine_running = false;
-	static bool turbojet_fired = false;
-	static bool turbojet_running = false;
-	static bool last_action_break_engine = false;
-	static bool last_action_afterburn = false;
-	static int bip = 0;
-    static bool go_sound = false;
-    static bool new_lap_record = false;
-    static bool pod_crash_done = false;
+	// only pushes commands to the audio thread, no OpenAL call here
+	SoundState & st = sound_state;
+
+	// listener follows the active camera
+	glm::vec3 listener_velocity(0.0f);
+	if(delta > 0.0)
+		listener_velocity = (cam->get_position() - last_listener_position) / static_cast<float>(delta);
+	last_listener_position = cam->get_position();
+	audio->set_listener(cam->get_position(), listener_velocity, cam->get_direction(), cam->get_vector_up());
 
 	if(current_page != RACE)
 	{
-		fire_power_coupling_done = false;
-		power_coupling_running = false;
-		start_electric_engine_done = false;
-		electric_engine_running = false;
-		turbojet_fired = false;
-		turbojet_running = false;
-		last_action_break_engine = false;
-		last_action_afterburn = false;
-		bip = 0;
-        go_sound = false;
-        new_lap_record = false;
-        pod_crash_done = false;
-
-		if(tatooine_wind->is_playing())
-			tatooine_wind->stop_sound();
-		if(pod_base_engine->is_playing())
-			pod_base_engine->stop_sound();
-		if(pod_electric_engine->is_playing())
-			pod_electric_engine->stop_sound();
-		if(pod_power_coupling->is_playing())
-			pod_power_coupling->stop_sound();
-
-		if(!main_menu_source->is_playing())
-			main_menu_source->play_sound(sounds->sounds.at(0));
+		st = SoundState();
+
+		if(audio->is_playing(tatooine_wind))
+			audio->stop(tatooine_wind);
+		if(audio->is_playing(pod_base_engine))
+			audio->stop(pod_base_engine);
+		if(audio->is_playing(pod_electric_engine))
+			audio->stop(pod_electric_engine);
+		if(audio->is_playing(pod_power_coupling))
+			audio->stop(pod_power_coupling);
+
+		if(!audio->is_playing(main_menu_source))
+			audio->play(main_menu_source);
 	}
 	else
 	{
-		if(main_menu_source->is_playing())
-			main_menu_source->stop_sound();
+		// every pod sound is emitted from the chassis
+		if(tatooine != nullptr)
+		{
+			btRaycastVehicle* vehicle = tatooine->get_vehicle();
+			btVector3 origin = vehicle->getChassisWorldTransform().getOrigin();
+			btVector3 velocity = vehicle->getRigidBody()->getLinearVelocity();
+			glm::vec3 pod_position(origin.x(), origin.y(), origin.z());
+			glm::vec3 pod_velocity(velocity.x(), velocity.y(), velocity.z());
+			int pod_voices[] = {pod_fire_power_coupling, pod_power_coupling, pod_start_electric_engine, pod_electric_engine, pod_fire_engine, pod_base_engine, pod_break, pod_afterburn, pod_collide, pod_crash};
+			for(int v : pod_voices)
+			{
+				audio->move(v, pod_position, pod_velocity);
+			}
+
+#if AUDIO_BENCHMARK == 1
+			// emitters circling the pod at different distances and speeds
+			static float bench_angle = 0.0f;
+			bench_angle += static_cast<float>(delta);
+			int nb_emitters = bench_emitters.size();
+			for(int i = 0; i < nb_emitters; i++)
+			{
+				float radius = 20.0f + 40.0f * static_cast<float>(i);
+				float w = 1.0f + 0.1f * static_cast<float>(i);
+				float a = bench_angle * w + static_cast<float>(i);
+				glm::vec3 offset(radius * cos(a), 0.0f, radius * sin(a));
+				glm::vec3 velocity(-radius * w * sin(a), 0.0f, radius * w * cos(a));
+				audio->move(bench_emitters.at(i), pod_position + offset, pod_velocity + velocity);
+				if(!audio->is_playing(bench_emitters.at(i)))
+					audio->play(bench_emitters.at(i), 10);
+			}
+#endif
+		}
+
+		if(audio->is_playing(main_menu_source) && !st.menu_music_fading)
+		{
+			audio->crossfade(main_menu_source, -1, 1.0f);
+			st.menu_music_fading = true;
+		}
 
-		if(countdown_timer > 0 && bip < 3)
+		if(countdown_timer > 0 && st.bip < 3)
 		{
-			if(!countdown_sounds->is_playing())
+			if(!audio->is_playing(countdown_sounds))
 			{
-				bip++;
-				countdown_sounds->play_sound(sounds->sounds.at(10));
+				st.bip++;
+				audio->play(countdown_sounds, 6);
 			}
 		}
-		else if(countdown_timer == 0 && !go_sound)
+		else if(countdown_timer == 0 && !st.go_sound)
 		{
-			if(!countdown_sounds->is_playing())
+			if(!audio->is_playing(countdown_sounds))
             {
-				countdown_sounds->play_sound(sounds->sounds.at(11));
-                go_sound = true;
+				audio->play(countdown_sounds, 7);
+                st.go_sound = true;
             }
 		}
 
 		if(pod->power_coupling_on)
 		{
-			if(!pod_fire_power_coupling->is_playing() && !fire_power_coupling_done)
+			if(!audio->is_playing(pod_fire_power_coupling) && !st.fire_power_coupling_done)
 			{
-				pod_fire_power_coupling->play_sound(sounds->sounds.at(1));
-				fire_power_coupling_done = true;
+				audio->play(pod_fire_power_coupling, 0);
+				st.fire_power_coupling_done = true;
 			}
-			if((pod_fire_power_coupling->get_elapsed_time() >= 0.5f) && fire_power_coupling_done && !power_coupling_running)
+			if((audio->get_elapsed_time(pod_fire_power_coupling) >= 0.5f) && st.fire_power_coupling_done && !st.power_coupling_running)
 			{
-				power_coupling_running = true;
-				pod_power_coupling->play_sound(sounds->sounds.at(2));
+				st.power_coupling_running = true;
+				audio->play(pod_power_coupling);
 			}
 		}
 
 		if(pod->electric_engine_on)
 		{
-			if(!pod_start_electric_engine->is_playing() && !start_electric_engine_done)
+			if(!audio->is_playing(pod_start_electric_engine) && !st.start_electric_engine_done)
 			{
-				pod_start_electric_engine->play_sound(sounds->sounds.at(3));
-				start_electric_engine_done = true;
+				audio->play(pod_start_electric_engine, 1);
+				st.start_electric_engine_done = true;
 			}
-			if((pod_start_electric_engine->get_elapsed_time() >= 3.3f) && start_electric_engine_done && !electric_engine_running)
+			if((audio->get_elapsed_time(pod_start_electric_engine) >= 3.3f) && st.start_electric_engine_done && !st.electric_engine_running)
 			{
-				electric_engine_running = true;
-				pod_electric_engine->play_sound(sounds->sounds.at(4));
+				st.electric_engine_running = true;
+				audio->play(pod_electric_engine);
 			}
 		}
 
 		if(pod->turbojet_on)
 		{
-			if(!turbojet_fired)
+			if(!st.turbojet_fired)
 			{
-				turbojet_fired = true;
-				pod_fire_engine->play_sound(sounds->sounds.at(5));
+				st.turbojet_fired = true;
+				audio->play(pod_fire_engine, 2);
 			}
-			else if(!turbojet_running)
+			else if(!st.turbojet_running)
 			{
-				turbojet_running = true;
-				pod_base_engine->play_sound(sounds->sounds.at(6));
+				st.turbojet_running = true;
+				audio->play(pod_base_engine);
 			}
 
 			if(user_actions.key_up || user_actions.key_space)
 			{
-				last_action_break_engine = false;
+				st.last_action_break_engine = false;
 			}
 
 			if(user_actions.key_up || user_actions.key_down || user_actions.key_right || user_actions.key_left)
 			{
-				last_action_afterburn = false;
+				st.last_action_afterburn = false;
 			}
 
+			int engine_volume = 30;
 			if(user_actions.key_down)
 			{
-				if(!pod_break->is_playing() && !last_action_break_engine)
+				if(!audio->is_playing(pod_break) && !st.last_action_break_engine)
 				{
-					pod_base_engine->set_volume(10);
-					pod_break->play_sound(sounds->sounds.at(7));
+					engine_volume = 10;
+					audio->play(pod_break, 3);
 				}
-				last_action_break_engine = true;
+				else if(st.engine_volume == 10)
+					engine_volume = 10;
+				st.last_action_break_engine = true;
 			}
-			else
-				pod_base_engine->set_volume(30);
 
 			if(user_actions.key_space)
 			{
-				pod_base_engine->set_volume(80);
-				if(!pod_afterburn->is_playing() && !last_action_afterburn)
+				engine_volume = 80;
+				if(!audio->is_playing(pod_afterburn) && !st.last_action_afterburn)
 				{
-					last_action_afterburn = true;
-					pod_afterburn->play_sound(sounds->sounds.at(9));
+					st.last_action_afterburn = true;
+					audio->play(pod_afterburn, 5);
 				}
 			}
-			else if(!user_actions.key_down)
-				pod_base_engine->set_volume(30);
+
+			if(engine_volume != st.engine_volume)
+			{
+				st.engine_volume = engine_volume;
+				audio->set_volume(pod_base_engine, engine_volume);
+			}
+
+			// engine pitch and gain follow the pod speed
+			float engine_load = glm::clamp(pod->speed / pod->max_speed, 0.0f, 1.0f);
+			if(std::abs(engine_load - st.engine_load) > 0.01f)
+			{
+				st.engine_load = engine_load;
+				audio->ramp_pitch(pod_base_engine, 0.8f + 0.6f * engine_load, 0.1f);
+				audio->ramp_gain(pod_base_engine, 0.7f + 0.3f * engine_load, 0.1f);
+			}
 		}
 
-        if(hit_count_lap_wall && !fodesinbeed->is_playing() && (lap_iterate > 0))
+        if(hit_count_lap_wall && !audio->is_playing(fodesinbeed) && (lap_iterate > 0))
         {
-            new_lap_record = true;
-            fodesinbeed->play_sound(sounds->sounds.at(8));
+            st.new_lap_record = true;
+            audio->play(fodesinbeed, 4);
         }
 
-        if(pod->collide_terrain && !pod_collide->is_playing())
+        if(pod->collide_terrain && !audio->is_playing(pod_collide))
         {
             if(pod->speed > 0.1f)
             {
-                pod_collide->play_sound(sounds->sounds.at(12));
+                audio->play(pod_collide, 8);
             }
             pod->collide_terrain = false;
         }
-        else if(pod_collide->is_playing())
+        else if(audio->is_playing(pod_collide))
         {
             pod->collide_terrain = false;
         }
         
-        if(pod->collide_ground && !pod_crash->is_playing() && !pod_crash_done)
+        if(pod->collide_ground && !audio->is_playing(pod_crash) && !st.pod_crash_done)
         {
             if(pod->speed > 0.1f)
             {
-                pod_crash->play_sound(sounds->sounds.at(13));
+                audio->play(pod_crash, 9);
                 pod->collide_ground = false;
-                pod_crash_done = true;
+                st.pod_crash_done = true;
             }
         }
 	}
@@ -6550,6 +4491,8 @@ void Game::check_events()
 				glViewport(0, 0, width, height);
 				update_menu_bb(width, height);
                 update_framebuffers();
+                depth_history = false;
+                draw_master->get_occlusion().invalidate();
                 if(!in_racing_game)
                 {
                     menu_width = width;
@@ -6695,23 +4638,23 @@ void Game::check_events()
 			sound_volume = ((user_actions.mouseX - bb_sound_slider.top_left_x) * 100) / (bb_sound_slider.bottom_right_x - bb_sound_slider.top_left_x);
 			if(sound_volume > 100){sound_volume = 100;}
 			if(sound_volume < 0){sound_volume = 0;}
-			main_menu_source->set_volume(sound_volume);
+			audio->set_volume(main_menu_source, sound_volume);
             float sound_ratio = static_cast<float>(sound_volume);
             sound_ratio /= 100.0f;
             /*
-	        pod_fire_power_coupling->set_volume(static_cast<int>(static_cast<float>(100) * sound_ratio));
-	        pod_power_coupling->set_volume(static_cast<int>(static_cast<float>(100) * sound_ratio));
-	        pod_start_electric_engine->set_volume(static_cast<int>(static_cast<float>(30) * sound_ratio));
-	        pod_electric_engine->set_volume(static_cast<int>(static_cast<float>(30) * sound_ratio));
-	        pod_fire_engine->set_volume(static_cast<int>(static_cast<float>(60) * sound_ratio));
-	        pod_base_engine->set_volume(static_cast<int>(static_cast<float>(30) * sound_ratio));
-	        pod_break->set_volume(static_cast<int>(static_cast<float>(100) * sound_ratio));
-	        pod_afterburn->set_volume(static_cast<int>(static_cast<float>(100) * sound_ratio));
-	        fodesinbeed->set_volume(static_cast<int>(static_cast<float>(100) * sound_ratio));
-	        tatooine_wind->set_volume(static_cast<int>(static_cast<float>(30) * sound_ratio));
-	        countdown_sounds->set_volume(static_cast<int>(static_cast<float>(100) * sound_ratio));
-            pod_collide->set_volume(static_cast<int>(static_cast<float>(60) * sound_ratio));
-            pod_crash->set_volume(static_cast<int>(static_cast<float>(80) * sound_ratio));
+	        audio->set_volume(pod_fire_power_coupling, static_cast<int>(static_cast<float>(100) * sound_ratio));
+	        audio->set_volume(pod_power_coupling, static_cast<int>(static_cast<float>(100) * sound_ratio));
+	        audio->set_volume(pod_start_electric_engine, static_cast<int>(static_cast<float>(30) * sound_ratio));
+	        audio->set_volume(pod_electric_engine, static_cast<int>(static_cast<float>(30) * sound_ratio));
+	        audio->set_volume(pod_fire_engine, static_cast<int>(static_cast<float>(60) * sound_ratio));
+	        audio->set_volume(pod_base_engine, static_cast<int>(static_cast<float>(30) * sound_ratio));
+	        audio->set_volume(pod_break, static_cast<int>(static_cast<float>(100) * sound_ratio));
+	        audio->set_volume(pod_afterburn, static_cast<int>(static_cast<float>(100) * sound_ratio));
+	        audio->set_volume(fodesinbeed, static_cast<int>(static_cast<float>(100) * sound_ratio));
+	        audio->set_volume(tatooine_wind, static_cast<int>(static_cast<float>(30) * sound_ratio));
+	        audio->set_volume(countdown_sounds, static_cast<int>(static_cast<float>(100) * sound_ratio));
+            audio->set_volume(pod_collide, static_cast<int>(static_cast<float>(60) * sound_ratio));
+            audio->set_volume(pod_crash, static_cast<int>(static_cast<float>(80) * sound_ratio));
             */
 		}
 	}
@@ -7211,6 +5154,16 @@ Podracer::Podracer(std::string p_name, Game* p_g)
     air_scoops_right_hinge2 = new Object("../assets/podracers/air_scoops_right_hinge2.obj", true);
     air_scoops_right_hinge3 = new Object("../assets/podracers/air_scoops_right_hinge3.obj", true);
 
+    // the scoops and hinges repeat, copies are drawn as instances of the first one they match
+    air_scoops = new InstanceBatch();
+    std::vector<Object*> air_scoops_parts = {air_scoops_left1, air_scoops_left2, air_scoops_left3, air_scoops_left_hinge1, air_scoops_left_hinge2, air_scoops_left_hinge3,
+            air_scoops_right1, air_scoops_right2, air_scoops_right3, air_scoops_right_hinge1, air_scoops_right_hinge2, air_scoops_right_hinge3};
+    for(int i = 0; i < air_scoops_parts.size(); i++)
+    {
+        air_scoops->add(air_scoops_parts[i]);
+    }
+    std::cout << "AIR SCOOPS: " << air_scoops->get_part_count() << " parts in " << air_scoops->get_group_count() << " instanced draws" << std::endl;
+
     // get rotor left translate vector
     std::vector<Mesh*> rotor_meshes = rotor_left->get_mesh_collection();
     float rotor_left_max_x = 0.0f; float rotor_left_min_x = 0.0f;
@@ -7218,7 +5171,7 @@ Podracer::Podracer(std::string p_name, Game* p_g)
     for(int i = 0; i < rotor_meshes.size(); i++)
     {
         Mesh * m = rotor_meshes.at(i);
-        std::vector<Vertex> vertices = m->get_vertex_list();
+        const std::vector<Vertex> & vertices = m->get_vertex_list();
         for(int j = 0; j < vertices.size(); j++)
         {
             if(j == 0)
@@ -7253,7 +5206,7 @@ Podracer::Podracer(std::string p_name, Game* p_g)
     for(int i = 0; i < rotor_meshes.size(); i++)
     {
         Mesh * m = rotor_meshes.at(i);
-        std::vector<Vertex> vertices = m->get_vertex_list();
+        const std::vector<Vertex> & vertices = m->get_vertex_list();
         for(int j = 0; j < vertices.size(); j++)
         {
             if(j == 0)
@@ -7316,6 +5269,8 @@ Podracer::Podracer(std::string p_name, Game* p_g)
 	smoke_shader->set_texture("../assets/textures/combustion/f2.png", 12, "f2", true);
 	smoke_shader->set_texture("../assets/textures/combustion/f3.png", 13, "f3", true);
 	smoke_shader->set_texture("../assets/textures/combustion/f4.png", 14, "f4", true);
+
+	smoke_compute_shader = new Shader("../shaders/smoke/compute.glsl");
 }
 
 void Podracer::reset()
@@ -7357,14 +5312,34 @@ Podracer::~Podracer()
     delete(air_scoops_right_hinge1);
     delete(air_scoops_right_hinge2);
     delete(air_scoops_right_hinge3);
+    delete(air_scoops);
     delete(pod_shader);
     delete(smoke_left);
 	delete(smoke_right);
 	delete(smoke_shader);
+	delete(smoke_compute_shader);
     delete(power);
     delete(power_shader);
 }
 
+std::vector<Object*> Podracer::get_parts() const
+{
+    return {chariot, dir_left, dir_right, cable_left, cable_right, reactor_left, reactor_right, rotor_left, rotor_right,
+            air_scoops_left1, air_scoops_left2, air_scoops_left3, air_scoops_left_hinge1, air_scoops_left_hinge2, air_scoops_left_hinge3,
+            air_scoops_right1, air_scoops_right2, air_scoops_right3, air_scoops_right_hinge1, air_scoops_right_hinge2, air_scoops_right_hinge3};
+}
+
+void Podracer::update_effects(double delta)
+{
+	// effects are simulated once per frame, every pass renders the same state
+	if(speed > 0.0f)
+	{
+		smoke_left->update(delta, smoke_compute_shader);
+		smoke_right->update(delta, smoke_compute_shader);
+	}
+	power->update(delta);
+}
+
 void Podracer::draw(bool shadowPass, bool depthPass, bool smokePass)
 {
     // translate chariot
@@ -7474,6 +5449,10 @@ void Podracer::draw(bool shadowPass, bool depthPass, bool smokePass)
     
 	// set cam ptr
 	cam = g->cam;
+
+    // the shadow maps get by with a coarse lod
+    int lod = shadowPass ? LOD_SHADOW : 0;
+
 	if(cam->get_type() != Camera::POD_SPECS)
     {
         pod_shader->use();
@@ -7576,75 +5555,52 @@ void Podracer::draw(bool shadowPass, bool depthPass, bool smokePass)
             rotor_right_model = glm::translate(rotor_right_model, glm::vec3(0.0f, 1.5f, 1.5f));
 		    
 		    pod_shader->set_Matrix("model", glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -2.22f, 3.3f)) * chariot_model);
-            cable_left->draw(*pod_shader);
-            cable_right->draw(*pod_shader);
+            cable_left->draw(*pod_shader, SOLID, lod);
+            cable_right->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", chariot_model * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.02f, 0.3f)));
-            chariot->draw(*pod_shader);
-            dir_left->draw(*pod_shader);
-            dir_right->draw(*pod_shader);
+            chariot->draw(*pod_shader, SOLID, lod);
+            dir_left->draw(*pod_shader, SOLID, lod);
+            dir_right->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", reactor_model);
-            reactor_left->draw(*pod_shader);
-            reactor_right->draw(*pod_shader);
+            reactor_left->draw(*pod_shader, SOLID, lod);
+            reactor_right->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", rotor_left_model * rotor_left_shift * rotor_left_rotate * rotor_left_origin);
-            rotor_left->draw(*pod_shader);
+            rotor_left->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", rotor_right_model * rotor_right_shift * rotor_right_rotate * rotor_right_origin);
-            rotor_right->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", reactor_model);
-            air_scoops_left1->draw(*pod_shader);
-            air_scoops_left2->draw(*pod_shader);
-            air_scoops_left3->draw(*pod_shader);
-            air_scoops_left_hinge1->draw(*pod_shader);
-            air_scoops_left_hinge2->draw(*pod_shader);
-            air_scoops_left_hinge3->draw(*pod_shader);
-            air_scoops_right1->draw(*pod_shader);
-            air_scoops_right2->draw(*pod_shader);
-            air_scoops_right3->draw(*pod_shader);
-            air_scoops_right_hinge1->draw(*pod_shader);
-            air_scoops_right_hinge2->draw(*pod_shader);
-            air_scoops_right_hinge3->draw(*pod_shader);
+            rotor_right->draw(*pod_shader, SOLID, lod);
+            for(int i = 0; i < air_scoops->get_part_count(); i++)
+            {
+                air_scoops->set_transform(i, reactor_model);
+            }
+            air_scoops->draw(*pod_shader, lod);
         }
         else
         { 
 		    pod_shader->set_Matrix("model", g->tatooine->chariot_model * tr_left * tr_right * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.02f, 0.6f)));
-		    chariot->draw(*pod_shader);
+		    chariot->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", g->tatooine->chariot_model * tr_left * tr_right * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.02f, 0.6f)) * g->tatooine->dir_left_model);
-            dir_left->draw(*pod_shader);
+            dir_left->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", g->tatooine->chariot_model * tr_left * tr_right * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.02f, 0.6f)) * g->tatooine->dir_right_model);
-            dir_right->draw(*pod_shader);
+            dir_right->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", cable_back * turn_right * turn_left * cable_to_origin);
-            cable_left->draw(*pod_shader);
-            cable_right->draw(*pod_shader);
+            cable_left->draw(*pod_shader, SOLID, lod);
+            cable_right->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", g->tatooine->reactors_model);
-            reactor_left->draw(*pod_shader);
-            reactor_right->draw(*pod_shader);
+            reactor_left->draw(*pod_shader, SOLID, lod);
+            reactor_right->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", g->tatooine->rotor_left_model);
-            rotor_left->draw(*pod_shader);
+            rotor_left->draw(*pod_shader, SOLID, lod);
 		    pod_shader->set_Matrix("model", g->tatooine->rotor_right_model);
-            rotor_right->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_left1_model);
-            air_scoops_left1->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_left2_model);
-            air_scoops_left2->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_left3_model);
-            air_scoops_left3->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_left_hinge1_model);
-            air_scoops_left_hinge1->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_left_hinge2_model);
-            air_scoops_left_hinge2->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_left_hinge3_model);
-            air_scoops_left_hinge3->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_right1_model);
-            air_scoops_right1->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_right2_model);
-            air_scoops_right2->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_right3_model);
-            air_scoops_right3->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_right_hinge1_model);
-            air_scoops_right_hinge1->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_right_hinge2_model);
-            air_scoops_right_hinge2->draw(*pod_shader);
-		    pod_shader->set_Matrix("model", g->tatooine->reactors_model * g->tatooine->air_scoops_right_hinge3_model);
-            air_scoops_right_hinge3->draw(*pod_shader);
+            rotor_right->draw(*pod_shader, SOLID, lod);
+            const glm::mat4 air_scoops_models[] = {g->tatooine->air_scoops_left1_model, g->tatooine->air_scoops_left2_model, g->tatooine->air_scoops_left3_model,
+                    g->tatooine->air_scoops_left_hinge1_model, g->tatooine->air_scoops_left_hinge2_model, g->tatooine->air_scoops_left_hinge3_model,
+                    g->tatooine->air_scoops_right1_model, g->tatooine->air_scoops_right2_model, g->tatooine->air_scoops_right3_model,
+                    g->tatooine->air_scoops_right_hinge1_model, g->tatooine->air_scoops_right_hinge2_model, g->tatooine->air_scoops_right_hinge3_model};
+            for(int i = 0; i < air_scoops->get_part_count(); i++)
+            {
+                air_scoops->set_transform(i, g->tatooine->reactors_model * air_scoops_models[i]);
+            }
+            air_scoops->draw(*pod_shader, lod);
         }
     }
 	if(!shadowPass)
@@ -7663,7 +5619,7 @@ inline void Podracer::draw_aux(bool depthPass, bool smokePass)
 		power_shader->use();
 		power_shader->set_int("depth", 0);
 		power_shader->set_Matrix("model", reactor_model);
-		power->draw(power_shader);
+		power->render(power_shader);
 	}
 	else
 	{
@@ -7684,8 +5640,8 @@ inline void Podracer::draw_aux(bool depthPass, bool smokePass)
 				else
 					smoke_shader->set_int("depthPass", 0);
 			
-				smoke_left->draw(g->delta, smoke_shader);
-				smoke_right->draw(g->delta, smoke_shader);
+				smoke_left->render(smoke_shader);
+				smoke_right->render(smoke_shader);
 			}
 
 			// power_coupling
@@ -7696,7 +5652,7 @@ inline void Podracer::draw_aux(bool depthPass, bool smokePass)
 					power_shader->set_int("depth", 1);
 				else
 					power_shader->set_int("depth", 0);
-				power->draw(power_shader);
+				power->render(power_shader);
 			}
 		}
 		else if(power_coupling_on && !electric_engine_on)
@@ -7709,7 +5665,7 @@ inline void Podracer::draw_aux(bool depthPass, bool smokePass)
 					power_shader->set_int("depth", 1);
 				else
 					power_shader->set_int("depth", 0);
-				power->draw(power_shader);
+				power->render(power_shader);
 			}
 		}
 		else if(power_coupling_on && electric_engine_on)
@@ -7722,7 +5678,7 @@ inline void Podracer::draw_aux(bool depthPass, bool smokePass)
 					power_shader->set_int("depth", 1);
 				else
 					power_shader->set_int("depth", 0);
-				power->draw(power_shader);
+				power->render(power_shader);
 			}
 		}
 	}
@@ -7778,7 +5734,7 @@ Environment::Environment(std::string p_name, Game* p_g)
     // create mesh collection
     for(int i = 0; i < env.size(); i++)
     {
-        std::vector<Mesh*> c = env.at(i)->get_mesh_collection();
+        const std::vector<Mesh*> & c = env.at(i)->get_mesh_collection();
         collection.insert(collection.end(), c.begin(), c.end());
     }
 }
@@ -7837,7 +5793,7 @@ Environment::Environment(std::string p_name, std::string file_path, Game* p_g)
     // create mesh collection
     for(int i = 0; i < env.size(); i++)
     {
-        std::vector<Mesh*> c = env.at(i)->get_mesh_collection();
+        const std::vector<Mesh*> & c = env.at(i)->get_mesh_collection();
         collection.insert(collection.end(), c.begin(), c.end());
     }
 }
@@ -7855,7 +5811,7 @@ void Environment::reset()
 	sunlightSpaceMatrix = sunlightProj * sunlightView;
 }
 
-std::vector<Mesh*> Environment::get_mesh_collection(bool mos_espa, int index)
+std::vector<Mesh*> const & Environment::get_mesh_collection(bool mos_espa, int index) const
 {
     if(!mos_espa)
         return collection;
@@ -7865,6 +5821,11 @@ std::vector<Mesh*> Environment::get_mesh_collection(bool mos_espa, int index)
     }
 }
 
+std::vector<Object*> const & Environment::get_objects() const
+{
+    return env;
+}
+
 void Environment::reset_drawable()
 {
     #pragma omp for
@@ -7996,8 +5957,20 @@ void Environment::draw(bool shadowPass, bool depthPass)
 	else
 		env_shader->set_int("cast_shadows", 0);
 
-	for(int i = 0; i < env.size(); i++)
-        env.at(i)->draw(*env_shader);
+	// the race track goes through the draw master's indirect path
+	if(this == g->env && g->draw_master != nullptr)
+		g->draw_master->draw(*env_shader, shadowPass && !depthPass);
+	else
+	{
+		for(int i = 0; i < env.size(); i++)
+		{
+			// animated objects were posed by Game::update_poses
+			if(!env.at(i)->get_animations().empty() && env.at(i)->get_pose().get_nb_joints() > 0)
+				env.at(i)->draw_pose(*env_shader);
+			else
+				env.at(i)->draw(*env_shader);
+		}
+	}
 }
 
 // ####################################################################################################
@@ -8092,6 +6065,11 @@ Minimap::~Minimap()
     glDeleteFramebuffers(1, &minimapFBO);
 }
 
+std::vector<Object*> Minimap::get_objects() const
+{
+	return {minimap, red_dot};
+}
+
 void Minimap::update_framebuffer(int w, int h)
 {
     float w_ratio = static_cast<float>(w) / WIDTH;
@@ -8248,23 +6226,15 @@ struct RayCallback : public btCollisionWorld::RayResultCallback
 
     ~RayCallback(){}
     
-    btScalar addSingleResult(btCollisionWorld::LocalRayResult & rayResult, bool normalInWorldSpace)
-    {
-        const btCollisionObject * obj = rayResult.m_collisionObject;
-        for(int i = 0; i < ground_objs.size(); i++)
-        {
-            if(ground_objs.at(i) == obj)
-            {
-                distance = 0.0f;
-                break;
-            }
-        }
+    btScalar addSingleResult(btCollisionWorld::LocalRayResult & rayResult, bool normalInWorldSpace)
+    {
+        if(rayResult.m_collisionObject->getUserIndex() == COLLISION_GROUP::TERRAIN)
+            distance = 0.0f;
         return btScalar(1.0f);
     }
 
     // members
     float distance;
-    std::vector<btCollisionObject*> ground_objs;
 };
 
 struct ContactCallback : public btCollisionWorld::ContactResultCallback
@@ -8280,22 +6250,14 @@ struct ContactCallback : public btCollisionWorld::ContactResultCallback
 
     btScalar addSingleResult(btManifoldPoint & cp, const btCollisionObjectWrapper * colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper * colObj1Wrap, int partId1, int index1)
     {
-        const btCollisionObject* obj2 = colObj1Wrap->getCollisionObject();
+        int tag = colObj1Wrap->getCollisionObject()->getUserIndex();
 
-        if(obj2 == lap_count_obj)
+        if(tag == COLLISION_GROUP::LAP_COUNT)
             lap_increase = true;
-        if(obj2 != reactors_obj && obj2 != chariot_obj && obj2 != cable_left_obj && obj2 != cable_right_obj && obj2 != lap_count_obj)
-        {
-            for(int i = 0; i < ground_objs.size(); i++)
-            {
-                if(ground_objs.at(i) == obj2)
-                {
-                    collide_ground = true;
-                    return btScalar(1.0f);
-                }
-            }
+        else if(tag == COLLISION_GROUP::TERRAIN)
+            collide_ground = true;
+        else if(tag != COLLISION_GROUP::POD)
             collide_terrain = true;
-        }
         return btScalar(1.0f);
     }
 
@@ -8303,18 +6265,70 @@ struct ContactCallback : public btCollisionWorld::ContactResultCallback
     bool lap_increase;
     bool collide_terrain;
     bool collide_ground;
-    btCollisionObject * lap_count_obj;
-    btCollisionObject * reactors_obj;
-    btCollisionObject * chariot_obj;
-    btCollisionObject * cable_left_obj;
-    btCollisionObject * cable_right_obj;
-    std::vector<btCollisionObject*> ground_objs;
+};
+
+// wheel rays: closed form test against the terrain heightfields, then a world ray clipped to that hit
+struct TerrainRaycaster : public btVehicleRaycaster
+{
+    TerrainRaycaster(btCollisionWorld * p_world, const std::vector<Heightfield*> * p_heightfields, btCollisionObject * p_terrain_obj)
+    {
+        world = p_world;
+        heightfields = p_heightfields;
+        terrain_obj = p_terrain_obj;
+    }
+
+    ~TerrainRaycaster(){}
+
+    void* castRay(const btVector3 & from, const btVector3 & to, btVehicleRaycasterResult & result)
+    {
+        void * hit_obj = nullptr;
+        glm::vec3 ray_from(from.getX(), from.getY(), from.getZ());
+        glm::vec3 ray_to(to.getX(), to.getY(), to.getZ());
+        btVector3 clipped_to = to;
+        float fraction = 1.0f;
+
+        HeightfieldHit hit;
+        for(int i = 0; i < heightfields->size(); i++)
+        {
+            if(heightfields->at(i)->raycast(ray_from, ray_to, hit) && hit.fraction < fraction)
+            {
+                fraction = hit.fraction;
+                result.m_hitPointInWorld = btVector3(hit.position.x, hit.position.y, hit.position.z);
+                result.m_hitNormalInWorld = btVector3(hit.normal.x, hit.normal.y, hit.normal.z);
+                result.m_distFraction = hit.fraction;
+                clipped_to = result.m_hitPointInWorld;
+                hit_obj = terrain_obj;
+            }
+        }
+
+        // the rest of the track can only matter above the terrain hit
+        btCollisionWorld::ClosestRayResultCallback ray_callback(from, clipped_to);
+        ray_callback.m_collisionFilterGroup = COLLISION_GROUP::POD;
+        ray_callback.m_collisionFilterMask = COLLISION_GROUP::ENV;
+        world->rayTest(from, clipped_to, ray_callback);
+        if(ray_callback.hasHit())
+        {
+            const btRigidBody * body = btRigidBody::upcast(ray_callback.m_collisionObject);
+            if(body && body->hasContactResponse())
+            {
+                result.m_hitPointInWorld = ray_callback.m_hitPointWorld;
+                result.m_hitNormalInWorld = ray_callback.m_hitNormalWorld;
+                result.m_hitNormalInWorld.normalize();
+                result.m_distFraction = fraction * ray_callback.m_closestHitFraction;
+                hit_obj = const_cast<btRigidBody*>(body);
+            }
+        }
+        return hit_obj;
+    }
+
+    // members
+    btCollisionWorld * world;
+    const std::vector<Heightfield*> * heightfields;
+    btCollisionObject * terrain_obj;
 };
 
 RayCallback ray_reactors;
 RayCallback ray_chariot;
-ContactCallback contact;
-ContactCallback contact_lap;
 
 WorldPhysics::WorldPhysics(Game* p_g) :
     engineForce(0.0f),
@@ -8324,7 +6338,16 @@ WorldPhysics::WorldPhysics(Game* p_g) :
     maxBreakingForce(70.0f),
     vehicleSteering(0.0f),
     steeringIncrement(0.0025f),
-    steeringClamp(0.05f)
+    steeringClamp(0.05f),
+    turn_angle(0.0f),
+    rotor_angle(0.0f),
+    dir_left_angle(0.0f),
+    dir_right_angle(0.0f),
+    air_scoops_angle(0.0f),
+    lap_trigger(nullptr),
+    lap_contact(false),
+    terrain_contact(false),
+    ground_contact(false)
 {
     // Game pointer
     g = p_g;
@@ -8356,6 +6379,7 @@ WorldPhysics::WorldPhysics(Game* p_g) :
     solver = new btSequentialImpulseConstraintSolver();
     dynamicsWorld = new btSoftRigidDynamicsWorld(dispatcher, overlappingPairCache, solver, collisionConfiguration);
     dynamicsWorld->setGravity(btVector3(0.0f, -9.8f, 0.0f));
+    dynamicsWorld->setInternalTickCallback(WorldPhysics::tick_callback, this);
 
     softBody_worldInfo = new btSoftBodyWorldInfo();
     softBody_worldInfo->m_broadphase = overlappingPairCache;
@@ -8365,116 +6389,68 @@ WorldPhysics::WorldPhysics(Game* p_g) :
     // ----- bullet init end -----
 
     // ----- create boonta eve static rigid body -----
-    std::vector<Mesh*> env_meshes = g->env->get_mesh_collection(true, 0);
+    // collision uses decimated proxies of the render meshes, built once then read from the collision cache
+    const std::vector<Mesh*> & env_meshes = g->env->get_mesh_collection(true, 0);
 
     for(int i = 0; i < env_meshes.size(); i++)
     {
         Mesh * m = env_meshes.at(i);
-        const std::vector<Vertex> & vertices = m->get_vertex_list();
-        const std::vector<int> & indices = m->get_index_list();
-
-        btTriangleMesh * triangleMesh = new btTriangleMesh();
-        for(int j = 0; j < indices.size(); j += 3)
-        {
-            btVector3 v1(vertices.at(indices.at(j)).position.x, vertices.at(indices.at(j)).position.y, vertices.at(indices.at(j)).position.z);
-            btVector3 v2(vertices.at(indices.at(j+1)).position.x, vertices.at(indices.at(j+1)).position.y, vertices.at(indices.at(j+1)).position.z);
-            btVector3 v3(vertices.at(indices.at(j+2)).position.x, vertices.at(indices.at(j+2)).position.y, vertices.at(indices.at(j+2)).position.z);
-            
-            triangleMesh->addTriangle(v1, v2, v3);
-        }
-        btBvhTriangleMeshShape * env_shape = new btBvhTriangleMeshShape(triangleMesh, true);
-        collisionShapes.push_back(env_shape);
-
-        btTransform env_transform;
-        env_transform.setIdentity();
-        env_transform.setOrigin(btVector3(0, 0, 0));
-
-        btScalar env_mass(0.0);
-        btVector3 env_localInertia(0, 0, 0);
-        btDefaultMotionState * env_motionState = new btDefaultMotionState(env_transform);
-        btRigidBody::btRigidBodyConstructionInfo env_rbInfo(env_mass, env_motionState, env_shape, env_localInertia);
-        btRigidBody * env_body = new btRigidBody(env_rbInfo);
-
-        dynamicsWorld->addRigidBody(env_body, COLLISION_GROUP::ENV, COLLISION_GROUP::POD | COLLISION_GROUP::ENV);
+        add_static_proxy(m, "mos_espa_" + std::to_string(i), is_grandstand(m->get_name()), COLLISION_GROUP::ENV, COLLISION_GROUP::POD | COLLISION_GROUP::ENV);
     }
     
-    std::vector<Mesh*> env_meshes_ground = g->env->get_mesh_collection(true, 1);
+    // the ground is a height field, wheel rays and hover probes test it without walking a BVH
+    const std::vector<Mesh*> & env_meshes_ground = g->env->get_mesh_collection(true, 1);
+    btCollisionObject * terrain_obj = nullptr;
 
     for(int i = 0; i < env_meshes_ground.size(); i++)
     {
-        Mesh * m = env_meshes_ground.at(i);
-        const std::vector<Vertex> & vertices = m->get_vertex_list();
-        const std::vector<int> & indices = m->get_index_list();
-
-        btTriangleMesh * triangleMesh = new btTriangleMesh();
-        for(int j = 0; j < indices.size(); j += 3)
-        {
-            btVector3 v1(vertices.at(indices.at(j)).position.x, vertices.at(indices.at(j)).position.y, vertices.at(indices.at(j)).position.z);
-            btVector3 v2(vertices.at(indices.at(j+1)).position.x, vertices.at(indices.at(j+1)).position.y, vertices.at(indices.at(j+1)).position.z);
-            btVector3 v3(vertices.at(indices.at(j+2)).position.x, vertices.at(indices.at(j+2)).position.y, vertices.at(indices.at(j+2)).position.z);
-            
-            triangleMesh->addTriangle(v1, v2, v3);
-        }
-        btBvhTriangleMeshShape * env_shape = new btBvhTriangleMeshShape(triangleMesh, true);
-        collisionShapes.push_back(env_shape);
-
-        btTransform env_transform;
-        env_transform.setIdentity();
-        env_transform.setOrigin(btVector3(0, 0, 0));
-
-        btScalar env_mass(0.0);
-        btVector3 env_localInertia(0, 0, 0);
-        btDefaultMotionState * env_motionState = new btDefaultMotionState(env_transform);
-        btRigidBody::btRigidBodyConstructionInfo env_rbInfo(env_mass, env_motionState, env_shape, env_localInertia);
-        btRigidBody * env_body = new btRigidBody(env_rbInfo);
-
-        dynamicsWorld->addRigidBody(env_body, COLLISION_GROUP::ENV, COLLISION_GROUP::POD | COLLISION_GROUP::ENV);
-
-        // distance
-        btCollisionObject * obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
-        ray_reactors.ground_objs.push_back(obj);
-        ray_chariot.ground_objs.push_back(obj);
-        contact.ground_objs.push_back(obj);
-        contact_lap.ground_objs.push_back(obj);
+        btCollisionObject * obj = add_static_heightfield(env_meshes_ground.at(i), "mos_espa_ground_" + std::to_string(i), COLLISION_GROUP::TERRAIN, COLLISION_GROUP::POD);
+        terrain_obj = obj;
     }
 
-    std::vector<Mesh*> env_mesh_lap = g->env->get_mesh_collection(true, 2);
+    const std::vector<Mesh*> & env_mesh_lap = g->env->get_mesh_collection(true, 2);
 
     for(int i = 0; i < env_mesh_lap.size(); i++)
     {
+        // lap trigger is tiny, keep its exact geometry
         Mesh * m = env_mesh_lap.at(i);
-        const std::vector<Vertex> & vertices = m->get_vertex_list();
-        const std::vector<int> & indices = m->get_index_list();
-
-        btTriangleMesh * triangleMesh = new btTriangleMesh();
-        for(int j = 0; j < indices.size(); j += 3)
-        {
-            btVector3 v1(vertices.at(indices.at(j)).position.x, vertices.at(indices.at(j)).position.y, vertices.at(indices.at(j)).position.z);
-            btVector3 v2(vertices.at(indices.at(j+1)).position.x, vertices.at(indices.at(j+1)).position.y, vertices.at(indices.at(j+1)).position.z);
-            btVector3 v3(vertices.at(indices.at(j+2)).position.x, vertices.at(indices.at(j+2)).position.y, vertices.at(indices.at(j+2)).position.z);
-            
-            triangleMesh->addTriangle(v1, v2, v3);
-        }
-        btBvhTriangleMeshShape * env_shape = new btBvhTriangleMeshShape(triangleMesh, true);
-        collisionShapes.push_back(env_shape);
+        unsigned int checksum = mesh_checksum(m->get_vertex_list(), m->get_index_list());
 
-        btTransform env_transform;
-        env_transform.setIdentity();
-        env_transform.setOrigin(btVector3(0, 0, 0));
-
-        btScalar env_mass(0.0);
-        btVector3 env_localInertia(0, 0, 0);
-        btDefaultMotionState * env_motionState = new btDefaultMotionState(env_transform);
-        btRigidBody::btRigidBodyConstructionInfo env_rbInfo(env_mass, env_motionState, env_shape, env_localInertia);
-        btRigidBody * env_body = new btRigidBody(env_rbInfo);
+        // the shape points into the mesh geometry, keep it as compact positions
+        m->compact_geometry();
+        const std::vector<glm::vec3> & positions = m->get_position_list();
+        const unsigned char * vertex_base = reinterpret_cast<const unsigned char*>(positions.data());
+        btCollisionShape * shape = create_triangle_shape(vertex_base, sizeof(glm::vec3), positions.size(), m->get_index_list(), checksum, "mos_espa_lap_count_" + std::to_string(i));
+        collisionShapes.push_back(shape);
 
-        dynamicsWorld->addRigidBody(env_body, COLLISION_GROUP::NONE, COLLISION_GROUP::NONE);
+        // ghost trigger volume: the broadphase pairs it with the pod, the solver ignores it
+        lap_trigger = new btGhostObject();
+        lap_trigger->setCollisionShape(shape);
+        lap_trigger->setCollisionFlags(lap_trigger->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+        lap_trigger->setUserIndex(COLLISION_GROUP::LAP_COUNT);
+        dynamicsWorld->addCollisionObject(lap_trigger, COLLISION_GROUP::LAP_COUNT, COLLISION_GROUP::POD);
+    }
 
-        // lap count
-        btCollisionObject * obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
-        contact.lap_count_obj = obj;
-        contact_lap.lap_count_obj = obj;
+#if COLLISION_BENCHMARK == 1
+    // full render geometry in a side world, only queried to compare against the proxies
+    benchDispatcher = new btCollisionDispatcher(collisionConfiguration);
+    benchBroadphase = new btDbvtBroadphase();
+    benchWorld = new btCollisionWorld(benchDispatcher, benchBroadphase, collisionConfiguration);
+    bench_frames = 0;
+    bench_proxy_time = 0.0;
+    bench_full_time = 0.0;
+    bench_contact_mismatch = 0;
+    bench_ray_mismatch = 0;
+    for(int i = 0; i < env_meshes.size(); i++)
+    {
+        add_static_mesh(env_meshes.at(i), "mos_espa_" + std::to_string(i), COLLISION_GROUP::ENV, COLLISION_GROUP::POD | COLLISION_GROUP::ENV, benchWorld);
+    }
+    for(int i = 0; i < env_meshes_ground.size(); i++)
+    {
+        btCollisionObject * obj = add_static_mesh(env_meshes_ground.at(i), "mos_espa_ground_" + std::to_string(i), COLLISION_GROUP::ENV, COLLISION_GROUP::POD | COLLISION_GROUP::ENV, benchWorld);
+        obj->setUserIndex(COLLISION_GROUP::TERRAIN);
     }
+#endif
 
     // ----- create podracer dynamic rigid body -----
     // reactors
@@ -8497,13 +6473,12 @@ WorldPhysics::WorldPhysics(Game* p_g) :
         reactors_body = new btRigidBody(rbInfo);
 
         // add the body to the dynamics world
-        dynamicsWorld->addRigidBody(reactors_body, COLLISION_GROUP::POD, COLLISION_GROUP::POD | COLLISION_GROUP::ENV);
+        dynamicsWorld->addRigidBody(reactors_body, COLLISION_GROUP::POD, COLLISION_GROUP::POD | COLLISION_GROUP::ENV | COLLISION_GROUP::TERRAIN | COLLISION_GROUP::LAP_COUNT);
         reactors_body->setActivationState(DISABLE_DEACTIVATION);
+        reactors_body->setUserIndex(COLLISION_GROUP::POD);
 
     }
-    reactors_colObj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
-    contact.reactors_obj = reactors_colObj;
-    contact_lap.reactors_obj = reactors_colObj;
+    reactors_colObj = reactors_body;
     
     // chariot
     {
@@ -8525,15 +6500,13 @@ WorldPhysics::WorldPhysics(Game* p_g) :
         chariot_body = new btRigidBody(rbInfo);
 
         // add the body to the dynamics world
-        dynamicsWorld->addRigidBody(chariot_body, COLLISION_GROUP::POD, COLLISION_GROUP::POD | COLLISION_GROUP::ENV);
+        dynamicsWorld->addRigidBody(chariot_body, COLLISION_GROUP::POD, COLLISION_GROUP::POD | COLLISION_GROUP::ENV | COLLISION_GROUP::TERRAIN);
         chariot_body->setActivationState(DISABLE_DEACTIVATION);
+        chariot_body->setUserIndex(COLLISION_GROUP::POD);
     }
-    
-    contact.chariot_obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
-    contact_lap.chariot_obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
 
     // ----------********** START CREATE RAYCAST VEHICLE **********----------
-    raycaster = new btDefaultVehicleRaycaster(dynamicsWorld);
+    raycaster = new TerrainRaycaster(dynamicsWorld, &heightfields, terrain_obj);
     vehicle = new btRaycastVehicle(tuning, reactors_body, raycaster);
 
     // add vehicle to the world
@@ -8591,7 +6564,7 @@ WorldPhysics::WorldPhysics(Game* p_g) :
     global_contact.setOrigin(btVector3(0.0f, 1.5f, 0.0f));
     btTransform localFrameInR = reactors_body->getWorldTransform().inverse() * global_contact;
     btTransform localFrameInC = chariot_body->getWorldTransform().inverse() * global_contact;
-    btGeneric6DofConstraint * connection = new btGeneric6DofConstraint(*reactors_body, *chariot_body, localFrameInR, localFrameInC, true);
+    connection = new btGeneric6DofConstraint(*reactors_body, *chariot_body, localFrameInR, localFrameInC, true);
 
     dynamicsWorld->addConstraint(connection);
 
@@ -8697,8 +6670,7 @@ WorldPhysics::WorldPhysics(Game* p_g) :
         // add left soft body to the dynamics world
         dynamicsWorld->addSoftBody(cable_left);
 
-        contact.cable_left_obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
-        contact_lap.cable_left_obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
+        cable_left->setUserIndex(COLLISION_GROUP::POD);
 
         // attach left soft body to chariot and reactors
         btSoftBody::tNodeArray left_nodes = cable_left->m_nodes;
@@ -8731,11 +6703,10 @@ WorldPhysics::WorldPhysics(Game* p_g) :
             }
         }
 
-        // recreate cable left mesh
-        prev_c_left_vertices = init_previous_vertices(vertices, fixed_left_vertices);
-        initial_c_left_vertices = prev_c_left_vertices;
-        initial_c_left_indices = fixed_left_indices;
-        g->pod->cable_left->get_mesh_collection().at(0)->recreate(prev_c_left_vertices, fixed_left_indices);
+        // recreate cable left mesh, one vertex per face corner like the per-frame updates
+        std::vector<int> expanded_left_indices;
+        prev_c_left_vertices = expand_cable_vertices(init_previous_vertices(vertices, fixed_left_vertices), fixed_left_indices, expanded_left_indices);
+        g->pod->cable_left->get_mesh_collection().at(0)->recreate(prev_c_left_vertices, expanded_left_indices);
         
         // -----***** create cable right soft body
         Mesh* cable_right_mesh = g->pod->cable_right->get_mesh_collection().at(0);
@@ -8817,8 +6788,7 @@ WorldPhysics::WorldPhysics(Game* p_g) :
         // add right soft body to the dynamics world
         dynamicsWorld->addSoftBody(cable_right);
         
-        contact.cable_right_obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
-        contact_lap.cable_right_obj = dynamicsWorld->getCollisionObjectArray()[collisionShapes.size() - 1];
+        cable_right->setUserIndex(COLLISION_GROUP::POD);
         
         // attach right soft body to chariot and reactors
         btSoftBody::tNodeArray right_nodes = cable_right->m_nodes;
@@ -8851,11 +6821,13 @@ WorldPhysics::WorldPhysics(Game* p_g) :
             }
         }
         
-        // recreate cable right mesh
-        prev_c_right_vertices = init_previous_vertices(vertices, fixed_right_vertices);
-        initial_c_right_vertices = prev_c_right_vertices;
-        initial_c_right_indices = fixed_right_indices;
-        g->pod->cable_right->get_mesh_collection().at(0)->recreate(prev_c_right_vertices, fixed_right_indices);
+        // recreate cable right mesh, one vertex per face corner like the per-frame updates
+        std::vector<int> expanded_right_indices;
+        prev_c_right_vertices = expand_cable_vertices(init_previous_vertices(vertices, fixed_right_vertices), fixed_right_indices, expanded_right_indices);
+        g->pod->cable_right->get_mesh_collection().at(0)->recreate(prev_c_right_vertices, expanded_right_indices);
+
+    // state restored by reset()
+    save_state(initial_state);
 }
 
 WorldPhysics::~WorldPhysics()
@@ -8873,6 +6845,23 @@ WorldPhysics::~WorldPhysics()
         delete(obj);
     }
 
+#if COLLISION_BENCHMARK == 1
+    for(int i = benchWorld->getNumCollisionObjects() - 1; i >= 0; i--)
+    {
+        btCollisionObject * obj = benchWorld->getCollisionObjectArray()[i];
+        btRigidBody * body = btRigidBody::upcast(obj);
+        if(body && body->getMotionState())
+        {
+            delete(body->getMotionState());
+        }
+        benchWorld->removeCollisionObject(obj);
+        delete(obj);
+    }
+    delete(benchWorld);
+    delete(benchBroadphase);
+    delete(benchDispatcher);
+#endif
+
     // delete collision shapes
     for(int i = 0; i < collisionShapes.size(); i++)
     {
@@ -8880,6 +6869,32 @@ WorldPhysics::~WorldPhysics()
         collisionShapes[i] = 0;
         delete(shape);
     }
+
+    // delete collision proxies child shapes
+    for(int i = 0; i < proxyShapes.size(); i++)
+    {
+        delete(proxyShapes[i]);
+    }
+    for(int i = 0; i < collisionProxies.size(); i++)
+    {
+        delete(collisionProxies.at(i));
+    }
+
+    // delete terrain heightfields (terrain shapes read their samples)
+    for(int i = 0; i < heightfields.size(); i++)
+    {
+        delete(heightfields.at(i));
+    }
+
+    // delete static meshes interfaces and cached BVHs (shapes must be gone first)
+    for(int i = 0; i < meshInterfaces.size(); i++)
+    {
+        delete(meshInterfaces[i]);
+    }
+    for(int i = 0; i < bvhBuffers.size(); i++)
+    {
+        btAlignedFree(bvhBuffers[i]);
+    }
     
     // delete dynamics world
     delete(dynamicsWorld);
@@ -8918,22 +6933,150 @@ void WorldPhysics::reset()
     air_scoops_right_hinge2_model = glm::mat4(1.0f);
     air_scoops_right_hinge3_model = glm::mat4(1.0f);
 
-    // reset cables
-    g->pod->cable_left->get_mesh_collection().at(0)->recreate(initial_c_left_vertices, initial_c_left_indices);
-    g->pod->cable_right->get_mesh_collection().at(0)->recreate(initial_c_right_vertices, initial_c_right_indices);
+    // bodies, vehicle, cables and parts angles as they were after construction
+    restore_state(initial_state);
+}
+
+void WorldPhysics::save_state(PhysicsSnapshot & snapshot)
+{
+    save_rigid_body(reactors_body, snapshot.reactors);
+    save_rigid_body(chariot_body, snapshot.chariot);
+
+    for(int i = 0; i < vehicle->getNumWheels() && i < VEHICLE_NB_WHEELS; i++)
+    {
+        const btWheelInfo & wheel = vehicle->getWheelInfo(i);
+        WheelSnapshot & w = snapshot.wheels[i];
+        w.raycast_info = wheel.m_raycastInfo;
+        w.world_transform = wheel.m_worldTransform;
+        w.steering = wheel.m_steering;
+        w.rotation = wheel.m_rotation;
+        w.delta_rotation = wheel.m_deltaRotation;
+        w.engine_force = wheel.m_engineForce;
+        w.brake = wheel.m_brake;
+        w.suspension_relative_velocity = wheel.m_suspensionRelativeVelocity;
+        w.suspension_force = wheel.m_wheelsSuspensionForce;
+        w.skid_info = wheel.m_skidInfo;
+    }
+
+    // constraint warm starting
+    snapshot.connection_linear_impulse = connection->getTranslationalLimitMotor()->m_accumulatedImpulse;
+    for(int i = 0; i < 3; i++)
+        snapshot.connection_angular_impulse[i] = connection->getRotationalLimitMotor(i)->m_accumulatedImpulse;
+
+    save_soft_body(cable_left, prev_c_left_vertices, snapshot.cable_left);
+    save_soft_body(cable_right, prev_c_right_vertices, snapshot.cable_right);
+
+    snapshot.engineForce = engineForce;
+    snapshot.breakingForce = breakingForce;
+    snapshot.vehicleSteering = vehicleSteering;
+    snapshot.steeringClamp = steeringClamp;
+
+    snapshot.turn_angle = turn_angle;
+    snapshot.rotor_angle = rotor_angle;
+    snapshot.dir_left_angle = dir_left_angle;
+    snapshot.dir_right_angle = dir_right_angle;
+    snapshot.air_scoops_angle = air_scoops_angle;
+}
+
+void WorldPhysics::restore_state(const PhysicsSnapshot & snapshot)
+{
+    restore_rigid_body(reactors_body, snapshot.reactors);
+    restore_rigid_body(chariot_body, snapshot.chariot);
+
+    for(int i = 0; i < vehicle->getNumWheels() && i < VEHICLE_NB_WHEELS; i++)
+    {
+        btWheelInfo & wheel = vehicle->getWheelInfo(i);
+        const WheelSnapshot & w = snapshot.wheels[i];
+        wheel.m_raycastInfo = w.raycast_info;
+        wheel.m_worldTransform = w.world_transform;
+        wheel.m_steering = w.steering;
+        wheel.m_rotation = w.rotation;
+        wheel.m_deltaRotation = w.delta_rotation;
+        wheel.m_engineForce = w.engine_force;
+        wheel.m_brake = w.brake;
+        wheel.m_suspensionRelativeVelocity = w.suspension_relative_velocity;
+        wheel.m_wheelsSuspensionForce = w.suspension_force;
+        wheel.m_skidInfo = w.skid_info;
+    }
+
+    connection->getTranslationalLimitMotor()->m_accumulatedImpulse = snapshot.connection_linear_impulse;
+    for(int i = 0; i < 3; i++)
+        connection->getRotationalLimitMotor(i)->m_accumulatedImpulse = snapshot.connection_angular_impulse[i];
+    connection->calculateTransforms();
+
+    restore_soft_body(cable_left, prev_c_left_vertices, g->pod->cable_left->get_mesh_collection().at(0), snapshot.cable_left);
+    restore_soft_body(cable_right, prev_c_right_vertices, g->pod->cable_right->get_mesh_collection().at(0), snapshot.cable_right);
+
+    engineForce = snapshot.engineForce;
+    breakingForce = snapshot.breakingForce;
+    vehicleSteering = snapshot.vehicleSteering;
+    steeringClamp = snapshot.steeringClamp;
+
+    turn_angle = snapshot.turn_angle;
+    rotor_angle = snapshot.rotor_angle;
+    dir_left_angle = snapshot.dir_left_angle;
+    dir_right_angle = snapshot.dir_right_angle;
+    air_scoops_angle = snapshot.air_scoops_angle;
+}
+
+void WorldPhysics::save_rigid_body(btRigidBody * body, RigidBodySnapshot & snapshot)
+{
+    snapshot.transform = body->getWorldTransform();
+    snapshot.linear_velocity = body->getLinearVelocity();
+    snapshot.angular_velocity = body->getAngularVelocity();
+}
+
+void WorldPhysics::restore_rigid_body(btRigidBody * body, const RigidBodySnapshot & snapshot)
+{
+    body->clearForces();
+    body->setWorldTransform(snapshot.transform);
+    body->setInterpolationWorldTransform(snapshot.transform);
+    body->getMotionState()->setWorldTransform(snapshot.transform);
+    body->setLinearVelocity(snapshot.linear_velocity);
+    body->setAngularVelocity(snapshot.angular_velocity);
+    body->setInterpolationLinearVelocity(snapshot.linear_velocity);
+    body->setInterpolationAngularVelocity(snapshot.angular_velocity);
+    body->setAngularFactor(btVector3(1.0f, 1.0f, 1.0f));
+
+    // drop contacts from the previous position
+    dynamicsWorld->updateSingleAabb(body);
+    overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(body->getBroadphaseHandle(), dispatcher);
+}
+
+void WorldPhysics::save_soft_body(btSoftBody * body, const std::vector<Vertex> & render_vertices, SoftBodySnapshot & snapshot)
+{
+    btSoftBody::tNodeArray & nodes = body->m_nodes;
+    snapshot.positions.resize(nodes.size());
+    snapshot.previous_positions.resize(nodes.size());
+    snapshot.velocities.resize(nodes.size());
+    for(int i = 0; i < nodes.size(); i++)
+    {
+        snapshot.positions[i] = nodes[i].m_x;
+        snapshot.previous_positions[i] = nodes[i].m_q;
+        snapshot.velocities[i] = nodes[i].m_v;
+    }
 
-    // clear forces and velocities
-    btVector3 zeroVector(0, 0, 0);
+    // the render vertices carry the texture coordinates matched against the nodes
+    snapshot.render_vertices.resize(render_vertices.size());
+    std::copy(render_vertices.begin(), render_vertices.end(), snapshot.render_vertices.begin());
+}
 
-    reactors_body->clearForces();
-    reactors_body->setLinearVelocity(zeroVector);
-    reactors_body->setAngularVelocity(zeroVector);
-    reactors_body->setWorldTransform(reactors_initialTransform);
+void WorldPhysics::restore_soft_body(btSoftBody * body, std::vector<Vertex> & render_vertices, Mesh * render_mesh, const SoftBodySnapshot & snapshot)
+{
+    btSoftBody::tNodeArray & nodes = body->m_nodes;
+    for(int i = 0; i < nodes.size() && i < snapshot.positions.size(); i++)
+    {
+        nodes[i].m_x = snapshot.positions[i];
+        nodes[i].m_q = snapshot.previous_positions[i];
+        nodes[i].m_v = snapshot.velocities[i];
+        nodes[i].m_f = btVector3(0.0f, 0.0f, 0.0f);
+    }
+    body->updateNormals();
+    body->updateBounds();
 
-    chariot_body->clearForces();
-    chariot_body->setLinearVelocity(zeroVector);
-    chariot_body->setAngularVelocity(zeroVector);
-    chariot_body->setWorldTransform(chariot_initialTransform);
+    render_vertices.resize(snapshot.render_vertices.size());
+    std::copy(snapshot.render_vertices.begin(), snapshot.render_vertices.end(), render_vertices.begin());
+    render_mesh->update_VBO(render_vertices);
 }
 
 void WorldPhysics::update_dynamics()
@@ -9096,7 +7239,10 @@ void WorldPhysics::update_dynamics()
     wheelIndex = 1;
     vehicle->setSteeringValue(vehicleSteering, wheelIndex);
 
-    // step simulation
+    // step simulation, contacts are collected by the tick callback
+    lap_contact = false;
+    terrain_contact = false;
+    ground_contact = false;
     dynamicsWorld->stepSimulation(1.0f/60.0f, 10);
 
     //distance from pod reactors to ground
@@ -9108,7 +7254,6 @@ void WorldPhysics::update_dynamics()
     //dynamicsWorld->rayTest(chariot_initial_center + chariot_center_of_mass_pos, chariot_initial_center + chariot_center_of_mass_pos + btVector3(0.0f, -2.3f, 0.0f), ray_chariot);
     
     // turn podracer
-    static float turn_angle = 0.0f;
     static float turn_rate = 0.5f;
     glm::mat4 turn_left = glm::mat4(1.0f);
     glm::mat4 turn_right = glm::mat4(1.0f);
@@ -9178,7 +7323,6 @@ void WorldPhysics::update_dynamics()
     reactors_model = reactors_model * turn_right * r_turn_right;
 
     // rotors
-    static float rotor_angle = 0.0f;
     rotor_angle += 36.0f;
     if(rotor_angle > 360.0f)
         rotor_angle = 0.0f;
@@ -9274,7 +7418,6 @@ void WorldPhysics::update_dynamics()
     g->pod->cable_right->get_mesh_collection().at(0)->update_VBO(updated_c_right_vertices);
 
     // direction left model
-    static float dir_left_angle = 0.0f;
     if(g->user_actions.key_left || g->user_actions.key_down)
     {
         dir_left_angle -= 2.0f;
@@ -9303,7 +7446,6 @@ void WorldPhysics::update_dynamics()
     }
 
     // direction right model
-    static float dir_right_angle = 0.0f;
     if(g->user_actions.key_right || g->user_actions.key_down)
     {
         dir_right_angle += 2.0f;
@@ -9332,7 +7474,6 @@ void WorldPhysics::update_dynamics()
     }
 
     // air scoops models
-    static float air_scoops_angle = 0.0f;
     
     if(g->user_actions.key_left || g->user_actions.key_right)
     {
@@ -9515,12 +7656,13 @@ void WorldPhysics::update_dynamics()
         }
     }
 
+#if COLLISION_BENCHMARK == 1
+    benchmark_collisions();
+#endif
+
     // -----=====----- check if another lap is completed -----=====-----
-    dynamicsWorld->contactPairTest(reactors_colObj, contact_lap.lap_count_obj, contact_lap);
-    dynamicsWorld->contactTest(reactors_colObj, contact);
-    if(contact_lap.lap_increase)
+    if(lap_contact)
     {
-        contact_lap.lap_increase = false;
         if(!g->hit_count_lap_wall)
         {
             g->hit_count_lap_wall = true;
@@ -9533,16 +7675,14 @@ void WorldPhysics::update_dynamics()
     }
     
     // -----=====----- check if pod collide terrain -----=====-----
-    if(contact.collide_terrain)
+    if(terrain_contact)
     {
-        contact.collide_terrain = false;
         g->pod->collide_terrain = true;
     }
     
     // -----=====----- check if pod collide ground -----=====-----
-    if(contact.collide_ground)
+    if(ground_contact)
     {
-        contact.collide_ground = false;
         g->pod->collide_ground = true;
     }
 
@@ -9550,6 +7690,345 @@ void WorldPhysics::update_dynamics()
     reactors_body->setAngularFactor(btVector3(1.0f, 1.0f, 1.0f));
 }
 
+btCollisionObject * WorldPhysics::add_static_mesh(Mesh * m, const std::string & cache_name, int group, int mask, btCollisionWorld * world)
+{
+    unsigned int checksum = mesh_checksum(m->get_vertex_list(), m->get_index_list());
+
+    // the collision shape reads positions straight from the mesh compact geometry
+    m->compact_geometry();
+    const std::vector<glm::vec3> & positions = m->get_position_list();
+    const unsigned char * vertex_base = reinterpret_cast<const unsigned char*>(positions.data());
+    btCollisionShape * shape = create_triangle_shape(vertex_base, sizeof(glm::vec3), positions.size(), m->get_index_list(), checksum, cache_name);
+
+    return add_static_body(shape, group, mask, world);
+}
+
+btCollisionObject * WorldPhysics::add_static_proxy(Mesh * m, const std::string & cache_name, bool hulls, int group, int mask)
+{
+    const std::vector<Vertex> & vertices = m->get_vertex_list();
+    const std::vector<int> & indices = m->get_index_list();
+    unsigned int checksum = mesh_checksum(vertices, indices);
+
+    // build step: decimate (or decompose) once, later launches read the proxy back
+    std::string cache_path = std::string(COLLISION_CACHE_DIR) + cache_name + ".proxy";
+    CollisionProxy * proxy = new CollisionProxy();
+    if(!proxy_builder.load(cache_path, checksum, hulls ? PROXY_HULLS : PROXY_TRIANGLES, *proxy))
+    {
+        if(hulls)
+            proxy_builder.decompose(vertices, indices, *proxy);
+        else
+            proxy_builder.simplify(vertices, indices, *proxy);
+
+        std::error_code ec;
+        std::filesystem::create_directories(COLLISION_CACHE_DIR, ec);
+        proxy_builder.save(cache_path, checksum, *proxy);
+    }
+    collisionProxies.push_back(proxy);
+
+    btCollisionShape * shape = nullptr;
+    if(proxy->type == PROXY_TRIANGLES)
+    {
+        // the tree describes the proxy triangles, key it on them and not on the render mesh
+        unsigned int proxy_checksum = position_checksum(proxy->positions, proxy->indices);
+        const unsigned char * vertex_base = reinterpret_cast<const unsigned char*>(proxy->positions.data());
+        shape = create_triangle_shape(vertex_base, sizeof(glm::vec3), proxy->positions.size(), proxy->indices, proxy_checksum, cache_name + "_proxy");
+    }
+    else
+    {
+        btCompoundShape * compound = new btCompoundShape();
+        btTransform identity;
+        identity.setIdentity();
+        for(int i = 0; i < proxy->hulls.size(); i++)
+        {
+            const std::vector<glm::vec3> & points = proxy->hulls.at(i).points;
+            btConvexHullShape * hull = new btConvexHullShape(reinterpret_cast<const btScalar*>(points.data()), points.size(), sizeof(glm::vec3));
+            proxyShapes.push_back(hull);
+            compound->addChildShape(identity, hull);
+        }
+        shape = compound;
+    }
+
+    return add_static_body(shape, group, mask, dynamicsWorld);
+}
+
+btCollisionShape * WorldPhysics::create_triangle_shape(const unsigned char * vertex_base, int vertex_stride, int nb_vertices, const std::vector<int> & indices, unsigned int checksum, const std::string & cache_name)
+{
+    btIndexedMesh indexed_mesh;
+    indexed_mesh.m_numTriangles = indices.size() / 3;
+    indexed_mesh.m_triangleIndexBase = reinterpret_cast<const unsigned char*>(indices.data());
+    indexed_mesh.m_triangleIndexStride = 3 * sizeof(int);
+    indexed_mesh.m_numVertices = nb_vertices;
+    indexed_mesh.m_vertexBase = vertex_base;
+    indexed_mesh.m_vertexStride = vertex_stride;
+    indexed_mesh.m_indexType = PHY_INTEGER;
+    indexed_mesh.m_vertexType = PHY_FLOAT;
+
+    btTriangleIndexVertexArray * mesh_interface = new btTriangleIndexVertexArray();
+    mesh_interface->addIndexedMesh(indexed_mesh, PHY_INTEGER);
+    meshInterfaces.push_back(mesh_interface);
+
+    // try to reload the quantized BVH from the collision cache, build it otherwise
+    std::string cache_path = std::string(COLLISION_CACHE_DIR) + cache_name + ".bvh";
+    btBvhTriangleMeshShape * shape = nullptr;
+    btOptimizedBvh * bvh = load_bvh(cache_path, checksum);
+    if(bvh != nullptr)
+    {
+        shape = new btBvhTriangleMeshShape(mesh_interface, true, false);
+        shape->setOptimizedBvh(bvh);
+    }
+    else
+    {
+        shape = new btBvhTriangleMeshShape(mesh_interface, true, true);
+        save_bvh(cache_path, checksum, shape->getOptimizedBvh());
+    }
+    return shape;
+}
+
+btCollisionObject * WorldPhysics::add_static_heightfield(Mesh * m, const std::string & cache_name, int group, int mask)
+{
+    const std::vector<Vertex> & vertices = m->get_vertex_list();
+    const std::vector<int> & indices = m->get_index_list();
+    unsigned int checksum = mesh_checksum(vertices, indices);
+
+    // resample the ground mesh once, later launches read the grid back
+    std::string cache_path = std::string(COLLISION_CACHE_DIR) + cache_name + ".hfield";
+    Heightfield * heightfield = new Heightfield();
+    if(!heightfield->load(cache_path, checksum, vertices))
+    {
+        heightfield->resample(vertices, indices);
+
+        std::error_code ec;
+        std::filesystem::create_directories(COLLISION_CACHE_DIR, ec);
+        heightfield->save(cache_path, checksum);
+    }
+    heightfields.push_back(heightfield);
+
+    float cell_size = heightfield->get_cell_size();
+    btHeightfieldTerrainShape * shape = new btHeightfieldTerrainShape(heightfield->get_width(), heightfield->get_length(), heightfield->get_data(), 1.0f, heightfield->get_min_height(), heightfield->get_max_height(), 1, PHY_FLOAT, false);
+    shape->setLocalScaling(btVector3(cell_size, 1.0f, cell_size));
+
+    // bullet centers the terrain on its AABB
+    glm::vec3 center = heightfield->get_center();
+    return add_static_body(shape, group, mask, dynamicsWorld, btVector3(center.x, center.y, center.z));
+}
+
+btCollisionObject * WorldPhysics::add_static_body(btCollisionShape * shape, int group, int mask, btCollisionWorld * world, const btVector3 & origin)
+{
+    collisionShapes.push_back(shape);
+
+    btTransform env_transform;
+    env_transform.setIdentity();
+    env_transform.setOrigin(origin);
+
+    btScalar env_mass(0.0);
+    btVector3 env_localInertia(0, 0, 0);
+    btDefaultMotionState * env_motionState = new btDefaultMotionState(env_transform);
+    btRigidBody::btRigidBodyConstructionInfo env_rbInfo(env_mass, env_motionState, shape, env_localInertia);
+    btRigidBody * env_body = new btRigidBody(env_rbInfo);
+    env_body->setUserIndex(group);
+
+    if(world == nullptr || world == dynamicsWorld)
+        dynamicsWorld->addRigidBody(env_body, group, mask);
+    else
+        world->addCollisionObject(env_body, group, mask);
+
+    return env_body;
+}
+
+void WorldPhysics::tick_callback(btDynamicsWorld * world, btScalar time_step)
+{
+    static_cast<WorldPhysics*>(world->getWorldUserInfo())->process_contacts();
+}
+
+void WorldPhysics::process_contacts()
+{
+    // the narrow phase already ran, read its manifolds instead of querying the world again
+    int nb_manifolds = dispatcher->getNumManifolds();
+    for(int i = 0; i < nb_manifolds; i++)
+    {
+        btPersistentManifold * manifold = dispatcher->getManifoldByIndexInternal(i);
+        const btCollisionObject * other = nullptr;
+        if(manifold->getBody0() == reactors_colObj)
+            other = manifold->getBody1();
+        else if(manifold->getBody1() == reactors_colObj)
+            other = manifold->getBody0();
+        else
+            continue;
+
+        bool touching = false;
+        for(int j = 0; j < manifold->getNumContacts(); j++)
+        {
+            if(manifold->getContactPoint(j).getDistance() <= 0.0f)
+            {
+                touching = true;
+                break;
+            }
+        }
+        if(!touching)
+            continue;
+
+        switch(other->getUserIndex())
+        {
+            case COLLISION_GROUP::LAP_COUNT:
+                lap_contact = true;
+                break;
+            case COLLISION_GROUP::TERRAIN:
+                ground_contact = true;
+                break;
+            case COLLISION_GROUP::POD:
+                break;
+            default:
+                terrain_contact = true;
+                break;
+        }
+    }
+}
+
+bool WorldPhysics::is_grandstand(const std::string & mesh_name)
+{
+    // stands and spectator buildings are boxy, convex hulls fit them better than a decimated soup
+    const char * keywords[] = {"spectat", "stand", "stairs", "building"};
+    for(int i = 0; i < 4; i++)
+    {
+        if(mesh_name.find(keywords[i]) != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+unsigned int WorldPhysics::mesh_checksum(const std::vector<Vertex> & vertices, const std::vector<int> & indices)
+{
+    // positions and indices, so an edited OBJ invalidates its cached BVH
+    unsigned int hash = FNV_OFFSET_BASIS;
+    for(int i = 0; i < vertices.size(); i++)
+    {
+        hash = fnv1a(&vertices[i].position, sizeof(glm::vec3), hash);
+    }
+    return fnv1a(indices.data(), indices.size() * sizeof(int), hash);
+}
+
+unsigned int WorldPhysics::position_checksum(const std::vector<glm::vec3> & positions, const std::vector<int> & indices)
+{
+    // same bytes as mesh_checksum, for geometry that isn't a vertex list
+    unsigned int hash = fnv1a(positions.data(), positions.size() * sizeof(glm::vec3));
+    return fnv1a(indices.data(), indices.size() * sizeof(int), hash);
+}
+
+btOptimizedBvh * WorldPhysics::load_bvh(const std::string & cache_path, unsigned int checksum)
+{
+    std::ifstream file(cache_path, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!file.is_open())
+        return nullptr;
+    unsigned long long file_size = file.tellg();
+    file.seekg(0, file.beg);
+
+    BvhCacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(BvhCacheHeader));
+    if(!file || header.magic != BVH_CACHE_MAGIC || header.checksum != checksum || header.size == 0)
+        return nullptr;
+
+    // the serialized tree is everything after the header, a truncated file is rebuilt
+    if(header.size != file_size - sizeof(BvhCacheHeader))
+        return nullptr;
+
+    // deSerializeInPlace keeps pointing into this buffer, it lives until the world is destroyed
+    void * buffer = btAlignedAlloc(header.size, 16);
+    file.read(reinterpret_cast<char*>(buffer), header.size);
+    if(!file)
+    {
+        btAlignedFree(buffer);
+        return nullptr;
+    }
+
+    btOptimizedBvh * bvh = btOptimizedBvh::deSerializeInPlace(buffer, header.size, false);
+    if(bvh == nullptr)
+    {
+        btAlignedFree(buffer);
+        return nullptr;
+    }
+    bvhBuffers.push_back(buffer);
+    return bvh;
+}
+
+void WorldPhysics::save_bvh(const std::string & cache_path, unsigned int checksum, btOptimizedBvh * bvh)
+{
+    if(bvh == nullptr)
+        return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(COLLISION_CACHE_DIR, ec);
+
+    BvhCacheHeader header;
+    header.magic = BVH_CACHE_MAGIC;
+    header.checksum = checksum;
+    header.size = bvh->calculateSerializeBufferSize();
+
+    void * buffer = btAlignedAlloc(header.size, 16);
+    if(bvh->serializeInPlace(buffer, header.size, false))
+    {
+        std::ofstream file(cache_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(file.is_open())
+        {
+            file.write(reinterpret_cast<const char*>(&header), sizeof(BvhCacheHeader));
+            file.write(reinterpret_cast<const char*>(buffer), header.size);
+        }
+        else
+        {
+            std::cerr << "Error: failed writing collision cache " << cache_path << std::endl;
+        }
+    }
+    btAlignedFree(buffer);
+}
+
+#if COLLISION_BENCHMARK == 1
+void WorldPhysics::benchmark_collisions()
+{
+    // same queries as gameplay (pod contacts + wheel rays), against proxies then full render geometry
+    ContactCallback proxy_result;
+    ContactCallback full_result;
+
+    double proxy_start = omp_get_wtime();
+    dynamicsWorld->contactTest(reactors_colObj, proxy_result);
+    bool proxy_hits[4];
+    for(int i = 0; i < vehicle->getNumWheels(); i++)
+    {
+        const btWheelInfo & wheel = vehicle->getWheelInfo(i);
+        btVector3 from = wheel.m_raycastInfo.m_hardPointWS;
+        btVector3 to = from + wheel.m_raycastInfo.m_wheelDirectionWS * (wheel.getSuspensionRestLength() + wheel.m_wheelsRadius);
+        btCollisionWorld::ClosestRayResultCallback ray(from, to);
+        dynamicsWorld->rayTest(from, to, ray);
+        proxy_hits[i] = ray.hasHit();
+    }
+    double full_start = omp_get_wtime();
+    benchWorld->contactTest(reactors_colObj, full_result);
+    for(int i = 0; i < vehicle->getNumWheels(); i++)
+    {
+        const btWheelInfo & wheel = vehicle->getWheelInfo(i);
+        btVector3 from = wheel.m_raycastInfo.m_hardPointWS;
+        btVector3 to = from + wheel.m_raycastInfo.m_wheelDirectionWS * (wheel.getSuspensionRestLength() + wheel.m_wheelsRadius);
+        btCollisionWorld::ClosestRayResultCallback ray(from, to);
+        benchWorld->rayTest(from, to, ray);
+        if(ray.hasHit() != proxy_hits[i])
+            bench_ray_mismatch++;
+    }
+    double full_end = omp_get_wtime();
+
+    bench_proxy_time += full_start - proxy_start;
+    bench_full_time += full_end - full_start;
+    if(proxy_result.collide_terrain != full_result.collide_terrain || proxy_result.collide_ground != full_result.collide_ground)
+        bench_contact_mismatch++;
+    bench_frames++;
+
+    if(bench_frames % 600 == 0)
+    {
+        std::cout << "COLLISION BENCHMARK (" << bench_frames << " frames)" << std::endl;
+        std::cout << "	proxy narrow phase = " << (bench_proxy_time / bench_frames) * 1000000.0 << " us/frame" << std::endl;
+        std::cout << "	full mesh narrow phase = " << (bench_full_time / bench_frames) * 1000000.0 << " us/frame" << std::endl;
+        std::cout << "	contact mismatches = " << bench_contact_mismatch << ", wheel ray mismatches = " << bench_ray_mismatch << std::endl;
+    }
+}
+#endif
+
 btRaycastVehicle* WorldPhysics::get_vehicle()
 {
     return vehicle;
@@ -9583,6 +8062,18 @@ int WorldPhysics::retrieve_correct_index(glm::vec3 ref_pos, const std::vector<st
     return -1;
 }
 
+std::vector<Vertex> WorldPhysics::expand_cable_vertices(const std::vector<Vertex> & unique_vertices, const std::vector<int> & indices, std::vector<int> & expanded_indices)
+{
+    std::vector<Vertex> res;
+    expanded_indices.clear();
+    for(int i = 0; i < indices.size(); i++)
+    {
+        res.push_back(unique_vertices.at(indices.at(i)));
+        expanded_indices.push_back(i);
+    }
+    return res;
+}
+
 std::vector<Vertex> WorldPhysics::init_previous_vertices(std::vector<Vertex> ref_vertices, std::vector<Vertex> v)
 {
     std::vector<Vertex> res;
@@ -9637,3 +8128,38 @@ glm::vec3 WorldPhysics::get_pod_direction()
     btVector3 vector = vehicle->getForwardVector();
     return glm::vec3(vector.x(), vector.y(), vector.z());
 }
+
+float WorldPhysics::get_ground_height(float x, float z)
+{
+    // hover probe, straight down through every terrain tile
+    float height = -FLT_MAX;
+    HeightfieldHit hit;
+    for(int i = 0; i < heightfields.size(); i++)
+    {
+        Heightfield * heightfield = heightfields.at(i);
+        glm::vec3 from(x, heightfield->get_max_height() + 1.0f, z);
+        glm::vec3 to(x, heightfield->get_min_height() - 1.0f, z);
+        if(heightfield->raycast(from, to, hit))
+            height = std::max(height, hit.position.y);
+    }
+    return height;
+}
+
+size_t WorldPhysics::get_cpu_bytes() const
+{
+    size_t bytes = 0;
+    for(int i = 0; i < heightfields.size(); i++)
+    {
+        bytes += (size_t)heightfields.at(i)->get_width() * heightfields.at(i)->get_length() * sizeof(float);
+    }
+    for(int i = 0; i < collisionProxies.size(); i++)
+    {
+        const CollisionProxy * proxy = collisionProxies.at(i);
+        bytes += proxy->positions.capacity() * sizeof(glm::vec3) + proxy->indices.capacity() * sizeof(int);
+        for(int j = 0; j < proxy->hulls.size(); j++)
+        {
+            bytes += proxy->hulls.at(j).points.capacity() * sizeof(glm::vec3);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,367 @@
+/**
+ * \file
+ * The ground is flat, mostly
+ * \author Mathias Velo
+ */
+
+#include "heightfield.hpp"
+
+struct HeightfieldCacheHeader
+{
+	unsigned int magic;
+	unsigned int checksum;
+	float cell_size;
+	int width;
+	int length;
+	float min_x;
+	float min_z;
+	float min_height;
+	float max_height;
+};
+
+Heightfield::Heightfield(float p_cell_size) :
+	cell_size(p_cell_size),
+	width(0),
+	length(0),
+	min_x(0.0f),
+	min_z(0.0f),
+	min_height(0.0f),
+	max_height(0.0f)
+{}
+
+void Heightfield::fit_grid(const std::vector<Vertex> & vertices)
+{
+	float max_x = -FLT_MAX;
+	float max_z = -FLT_MAX;
+	min_x = FLT_MAX;
+	min_z = FLT_MAX;
+	min_height = FLT_MAX;
+	max_height = -FLT_MAX;
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		glm::vec3 p = vertices[i].position;
+		min_x = std::min(min_x, p.x);
+		max_x = std::max(max_x, p.x);
+		min_z = std::min(min_z, p.z);
+		max_z = std::max(max_z, p.z);
+		min_height = std::min(min_height, p.y);
+		max_height = std::max(max_height, p.y);
+	}
+	width = static_cast<int>(std::ceil((max_x - min_x) / cell_size)) + 1;
+	length = static_cast<int>(std::ceil((max_z - min_z) / cell_size)) + 1;
+}
+
+void Heightfield::resample(const std::vector<Vertex> & vertices, const std::vector<int> & indices)
+{
+	fit_grid(vertices);
+	heights.assign(width * length, -FLT_MAX);
+
+	// rasterize each triangle onto the grid samples it covers, keep the highest surface
+	for(int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		glm::vec3 a = vertices[indices[i]].position;
+		glm::vec3 b = vertices[indices[i + 1]].position;
+		glm::vec3 c = vertices[indices[i + 2]].position;
+
+		float area = (b.x - a.x) * (c.z - a.z) - (c.x - a.x) * (b.z - a.z);
+		if(area == 0.0f)
+			continue;
+
+		int x0 = std::max(0, static_cast<int>(std::ceil((std::min(a.x, std::min(b.x, c.x)) - min_x) / cell_size)));
+		int x1 = std::min(width - 1, static_cast<int>(std::floor((std::max(a.x, std::max(b.x, c.x)) - min_x) / cell_size)));
+		int z0 = std::max(0, static_cast<int>(std::ceil((std::min(a.z, std::min(b.z, c.z)) - min_z) / cell_size)));
+		int z1 = std::min(length - 1, static_cast<int>(std::floor((std::max(a.z, std::max(b.z, c.z)) - min_z) / cell_size)));
+
+		for(int z = z0; z <= z1; z++)
+		{
+			for(int x = x0; x <= x1; x++)
+			{
+				float px = min_x + x * cell_size;
+				float pz = min_z + z * cell_size;
+				float w0 = ((b.x - px) * (c.z - pz) - (c.x - px) * (b.z - pz)) / area;
+				float w1 = ((c.x - px) * (a.z - pz) - (a.x - px) * (c.z - pz)) / area;
+				float w2 = 1.0f - w0 - w1;
+				if(w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+					continue;
+				float h = w0 * a.y + w1 * b.y + w2 * c.y;
+				float & stored = heights[z * width + x];
+				stored = std::max(stored, h);
+			}
+		}
+	}
+
+	// fill samples outside the mesh footprint from their neighbours
+	bool holes = true;
+	for(int pass = 0; pass < 8 && holes; pass++)
+	{
+		holes = false;
+		std::vector<float> filled = heights;
+		for(int z = 0; z < length; z++)
+		{
+			for(int x = 0; x < width; x++)
+			{
+				if(heights[z * width + x] != -FLT_MAX)
+					continue;
+				float sum = 0.0f;
+				int count = 0;
+				for(int dz = -1; dz <= 1; dz++)
+				{
+					for(int dx = -1; dx <= 1; dx++)
+					{
+						int nx = x + dx;
+						int nz = z + dz;
+						if(nx < 0 || nz < 0 || nx >= width || nz >= length || heights[nz * width + nx] == -FLT_MAX)
+							continue;
+						sum += heights[nz * width + nx];
+						count++;
+					}
+				}
+				if(count > 0)
+					filled[z * width + x] = sum / count;
+				else
+					holes = true;
+			}
+		}
+		heights.swap(filled);
+	}
+	for(int i = 0; i < heights.size(); i++)
+	{
+		if(heights[i] == -FLT_MAX)
+			heights[i] = min_height;
+	}
+
+	std::cout << "	- HEIGHTFIELD: " << indices.size() / 3 << " triangles -> " << width << " x " << length << " samples" << std::endl;
+}
+
+bool Heightfield::load(const std::string & path, unsigned int checksum, const std::vector<Vertex> & vertices)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		return false;
+	unsigned long long file_size = file.tellg();
+	file.seekg(0, file.beg);
+
+	HeightfieldCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(HeightfieldCacheHeader));
+	if(!file || header.magic != HEIGHTFIELD_CACHE_MAGIC || header.checksum != checksum || header.cell_size != cell_size)
+		return false;
+
+	// the grid must be the one this mesh resamples to, and the file must hold all of it
+	fit_grid(vertices);
+	if(header.width != width || header.length != length)
+		return false;
+	if(file_size - sizeof(HeightfieldCacheHeader) != static_cast<unsigned long long>(width) * length * sizeof(float))
+		return false;
+
+	min_height = header.min_height;
+	max_height = header.max_height;
+	heights.resize(width * length);
+	file.read(reinterpret_cast<char*>(heights.data()), heights.size() * sizeof(float));
+
+	return static_cast<bool>(file);
+}
+
+void Heightfield::save(const std::string & path, unsigned int checksum) const
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		std::cerr << "Error: failed writing heightfield " << path << std::endl;
+		return;
+	}
+
+	HeightfieldCacheHeader header;
+	header.magic = HEIGHTFIELD_CACHE_MAGIC;
+	header.checksum = checksum;
+	header.cell_size = cell_size;
+	header.width = width;
+	header.length = length;
+	header.min_x = min_x;
+	header.min_z = min_z;
+	header.min_height = min_height;
+	header.max_height = max_height;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(HeightfieldCacheHeader));
+	file.write(reinterpret_cast<const char*>(heights.data()), heights.size() * sizeof(float));
+}
+
+float Heightfield::sample(int x, int z) const
+{
+	x = std::max(0, std::min(width - 1, x));
+	z = std::max(0, std::min(length - 1, z));
+	return heights[z * width + x];
+}
+
+float Heightfield::get_height(float x, float z) const
+{
+	float gx = (x - min_x) / cell_size;
+	float gz = (z - min_z) / cell_size;
+	int ix = std::max(0, std::min(width - 2, static_cast<int>(std::floor(gx))));
+	int iz = std::max(0, std::min(length - 2, static_cast<int>(std::floor(gz))));
+	float fx = glm::clamp(gx - ix, 0.0f, 1.0f);
+	float fz = glm::clamp(gz - iz, 0.0f, 1.0f);
+
+	float h00 = sample(ix, iz);
+	float h10 = sample(ix + 1, iz);
+	float h01 = sample(ix, iz + 1);
+	float h11 = sample(ix + 1, iz + 1);
+
+	if(fx + fz <= 1.0f)
+		return h00 + fx * (h10 - h00) + fz * (h01 - h00);
+	else
+		return h11 + (1.0f - fx) * (h01 - h11) + (1.0f - fz) * (h10 - h11);
+}
+
+bool Heightfield::ray_triangle(glm::vec3 from, glm::vec3 dir, glm::vec3 a, glm::vec3 b, glm::vec3 c, float & t) const
+{
+	// Moller-Trumbore, double sided
+	glm::vec3 e1 = b - a;
+	glm::vec3 e2 = c - a;
+	glm::vec3 p = glm::cross(dir, e2);
+	float det = glm::dot(e1, p);
+	if(std::fabs(det) < 1e-8f)
+		return false;
+	float inv_det = 1.0f / det;
+	glm::vec3 s = from - a;
+	float u = glm::dot(s, p) * inv_det;
+	if(u < 0.0f || u > 1.0f)
+		return false;
+	glm::vec3 q = glm::cross(s, e1);
+	float v = glm::dot(dir, q) * inv_det;
+	if(v < 0.0f || u + v > 1.0f)
+		return false;
+	t = glm::dot(e2, q) * inv_det;
+	return t >= 0.0f && t <= 1.0f;
+}
+
+bool Heightfield::ray_cell(glm::vec3 from, glm::vec3 dir, int x, int z, float & t, glm::vec3 & normal) const
+{
+	glm::vec3 p00(min_x + x * cell_size, sample(x, z), min_z + z * cell_size);
+	glm::vec3 p10(min_x + (x + 1) * cell_size, sample(x + 1, z), min_z + z * cell_size);
+	glm::vec3 p01(min_x + x * cell_size, sample(x, z + 1), min_z + (z + 1) * cell_size);
+	glm::vec3 p11(min_x + (x + 1) * cell_size, sample(x + 1, z + 1), min_z + (z + 1) * cell_size);
+
+	bool hit = false;
+	float t_tri;
+	t = FLT_MAX;
+	if(ray_triangle(from, dir, p00, p01, p10, t_tri) && t_tri < t)
+	{
+		t = t_tri;
+		normal = glm::cross(p01 - p00, p10 - p00);
+		hit = true;
+	}
+	if(ray_triangle(from, dir, p10, p01, p11, t_tri) && t_tri < t)
+	{
+		t = t_tri;
+		normal = glm::cross(p01 - p10, p11 - p10);
+		hit = true;
+	}
+	if(hit)
+	{
+		normal = glm::normalize(normal);
+		if(normal.y < 0.0f)
+			normal = -normal;
+	}
+	return hit;
+}
+
+bool Heightfield::raycast(glm::vec3 from, glm::vec3 to, HeightfieldHit & hit) const
+{
+	if(width < 2 || length < 2)
+		return false;
+
+	glm::vec3 dir = to - from;
+
+	// vertical range rejection
+	if(std::max(from.y, to.y) < min_height || std::min(from.y, to.y) > max_height)
+		return false;
+
+	// clip the ray against the grid rectangle, in grid coordinates
+	float gx = (from.x - min_x) / cell_size;
+	float gz = (from.z - min_z) / cell_size;
+	float dx = dir.x / cell_size;
+	float dz = dir.z / cell_size;
+	float t_enter = 0.0f;
+	float t_exit = 1.0f;
+	float grid_max[2] = {static_cast<float>(width - 1), static_cast<float>(length - 1)};
+	float origin[2] = {gx, gz};
+	float delta[2] = {dx, dz};
+	for(int axis = 0; axis < 2; axis++)
+	{
+		if(delta[axis] == 0.0f)
+		{
+			if(origin[axis] < 0.0f || origin[axis] > grid_max[axis])
+				return false;
+		}
+		else
+		{
+			float t0 = (0.0f - origin[axis]) / delta[axis];
+			float t1 = (grid_max[axis] - origin[axis]) / delta[axis];
+			t_enter = std::max(t_enter, std::min(t0, t1));
+			t_exit = std::min(t_exit, std::max(t0, t1));
+		}
+	}
+	if(t_enter > t_exit)
+		return false;
+
+	// walk the cells crossed by the ray projection (2D DDA), wheel rays only visit one or two
+	float sx = gx + dx * t_enter;
+	float sz = gz + dz * t_enter;
+	int x = std::max(0, std::min(width - 2, static_cast<int>(std::floor(sx))));
+	int z = std::max(0, std::min(length - 2, static_cast<int>(std::floor(sz))));
+	int step_x = (dx > 0.0f) ? 1 : -1;
+	int step_z = (dz > 0.0f) ? 1 : -1;
+	float t_delta_x = (dx != 0.0f) ? std::fabs(1.0f / dx) : FLT_MAX;
+	float t_delta_z = (dz != 0.0f) ? std::fabs(1.0f / dz) : FLT_MAX;
+	float t_max_x = (dx != 0.0f) ? t_enter + ((step_x > 0 ? (x + 1) - sx : sx - x) * t_delta_x) : FLT_MAX;
+	float t_max_z = (dz != 0.0f) ? t_enter + ((step_z > 0 ? (z + 1) - sz : sz - z) * t_delta_z) : FLT_MAX;
+
+	while(x >= 0 && z >= 0 && x < width - 1 && z < length - 1)
+	{
+		float t;
+		glm::vec3 normal;
+		if(ray_cell(from, dir, x, z, t, normal))
+		{
+			hit.fraction = t;
+			hit.position = from + t * dir;
+			hit.normal = normal;
+			return true;
+		}
+
+		if(t_max_x < t_max_z)
+		{
+			if(t_max_x > t_exit)
+				break;
+			x += step_x;
+			t_max_x += t_delta_x;
+		}
+		else
+		{
+			if(t_max_z > t_exit)
+				break;
+			z += step_z;
+			t_max_z += t_delta_z;
+		}
+	}
+	return false;
+}
+
+int Heightfield::get_width() const { return width; }
+
+int Heightfield::get_length() const { return length; }
+
+float Heightfield::get_cell_size() const { return cell_size; }
+
+float Heightfield::get_min_height() const { return min_height; }
+
+float Heightfield::get_max_height() const { return max_height; }
+
+glm::vec3 Heightfield::get_center() const
+{
+	// btHeightfieldTerrainShape is centered on its AABB
+	return glm::vec3(min_x + (width - 1) * cell_size * 0.5f, (min_height + max_height) * 0.5f, min_z + (length - 1) * cell_size * 0.5f);
+}
+
+float* Heightfield::get_data()
+{
+	return heights.data();
+}
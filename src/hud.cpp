@@ -0,0 +1,226 @@
+/**
+ * \file
+ * Keep your eyes on the gauges, Anakin.
+ * \author Mathias Velo
+ */
+
+#include "hud.hpp"
+
+HudBatcher::HudBatcher() :
+	atlas(0),
+	atlas_height(0)
+{
+	vertices.reserve(HUD_MAX_QUADS * 4 * 5);
+
+	// quad indices never change, only the vertices are streamed
+	std::vector<GLushort> indices(HUD_MAX_QUADS * 6);
+	for(int q = 0; q < HUD_MAX_QUADS; q++)
+	{
+		indices[q * 6] = q * 4;
+		indices[q * 6 + 1] = q * 4 + 1;
+		indices[q * 6 + 2] = q * 4 + 2;
+		indices[q * 6 + 3] = q * 4 + 2;
+		indices[q * 6 + 4] = q * 4 + 1;
+		indices[q * 6 + 5] = q * 4 + 3;
+	}
+
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, HUD_MAX_QUADS * 4 * 5 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+}
+
+HudBatcher::~HudBatcher()
+{
+	for(int i = 0; i < images.size(); i++)
+	{
+		stbi_image_free(images[i].data);
+	}
+
+	glDeleteTextures(1, &atlas);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteVertexArrays(1, &VAO);
+}
+
+void HudBatcher::add_image(int id, const std::string & path, bool flip)
+{
+	Image img;
+	int channels;
+	stbi_set_flip_vertically_on_load(flip);
+	img.id = id;
+	img.data = stbi_load(path.c_str(), &img.width, &img.height, &channels, 4);
+	if(img.data == nullptr)
+	{
+		std::cerr << "Error: failed loading HUD image " << path << std::endl;
+		return;
+	}
+
+	images.push_back(img);
+}
+
+void HudBatcher::build()
+{
+	// shelf packing, tallest images first
+	std::vector<int> order(images.size());
+	for(int i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [this](int a, int b)
+	{
+		return images[a].height > images[b].height;
+	});
+
+	// each image sits in an aligned cell with a gutter, a texel of the last mip level never spans two cells
+	const int align = 1 << HUD_ATLAS_MIP_LEVELS;
+	auto cell_size = [align](int size)
+	{
+		return (size + 2 * HUD_ATLAS_GUTTER + align - 1) / align * align;
+	};
+
+	std::vector<int> x(images.size()); // cell corners
+	std::vector<int> y(images.size());
+	int shelf_x = 0;
+	int shelf_y = 0;
+	int shelf_height = 0;
+	for(int i : order)
+	{
+		if(shelf_x + cell_size(images[i].width) > HUD_ATLAS_WIDTH)
+		{
+			shelf_x = 0;
+			shelf_y += shelf_height;
+			shelf_height = 0;
+		}
+
+		x[i] = shelf_x;
+		y[i] = shelf_y;
+		shelf_x += cell_size(images[i].width);
+		shelf_height = std::max(shelf_height, cell_size(images[i].height));
+	}
+
+	atlas_height = 1;
+	while(atlas_height < shelf_y + shelf_height)
+	{
+		atlas_height *= 2;
+	}
+
+	// copy every image, its border texels stretched over the rest of the cell, and record its texel rectangle
+	// inset by half a texel so linear filtering stays inside
+	std::vector<unsigned char> texels(HUD_ATLAS_WIDTH * atlas_height * 4, 0);
+	for(int i = 0; i < images.size(); i++)
+	{
+		const Image & img = images[i];
+		int cell_width = cell_size(img.width);
+		int cell_height = cell_size(img.height);
+		for(int row = 0; row < cell_height; row++)
+		{
+			int src_row = std::clamp(row - HUD_ATLAS_GUTTER, 0, img.height - 1);
+			for(int col = 0; col < cell_width; col++)
+			{
+				int src_col = std::clamp(col - HUD_ATLAS_GUTTER, 0, img.width - 1);
+				const unsigned char * src = img.data + (src_row * img.width + src_col) * 4;
+				std::copy(src, src + 4, texels.begin() + ((y[i] + row) * HUD_ATLAS_WIDTH + x[i] + col) * 4);
+			}
+		}
+		x[i] += HUD_ATLAS_GUTTER;
+		y[i] += HUD_ATLAS_GUTTER;
+
+		if(img.id >= glyphs.size())
+		{
+			glyphs.resize(img.id + 1, HudGlyph{0.0f, 0.0f, 0.0f, 0.0f, false});
+		}
+		glyphs[img.id].u0 = (x[i] + 0.5f) / HUD_ATLAS_WIDTH;
+		glyphs[img.id].v0 = (y[i] + 0.5f) / atlas_height;
+		glyphs[img.id].u1 = (x[i] + img.width - 0.5f) / HUD_ATLAS_WIDTH;
+		glyphs[img.id].v1 = (y[i] + img.height - 0.5f) / atlas_height;
+		glyphs[img.id].loaded = true;
+
+		stbi_image_free(img.data);
+	}
+	images.clear();
+
+	glGenTextures(1, &atlas);
+	glBindTexture(GL_TEXTURE_2D, atlas);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB_ALPHA, HUD_ATLAS_WIDTH, atlas_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, HUD_ATLAS_MIP_LEVELS);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	std::cout << "HUD atlas = " << HUD_ATLAS_WIDTH << "x" << atlas_height << std::endl;
+}
+
+bool HudBatcher::has_image(int id) const
+{
+	for(int i = 0; i < images.size(); i++)
+	{
+		if(images[i].id == id)
+			return true;
+	}
+	return id < glyphs.size() && glyphs[id].loaded;
+}
+
+void HudBatcher::add_quad(int id, const HudQuad & quad, float fill)
+{
+	if(id >= glyphs.size() || !glyphs[id].loaded || vertices.size() >= HUD_MAX_QUADS * 4 * 5)
+		return;
+
+	// fill crops the quad from the bottom up (speed bar)
+	const HudGlyph & g = glyphs[id];
+	fill = std::clamp(fill, 0.0f, 1.0f);
+	float y1 = quad.y0 + (quad.y1 - quad.y0) * fill;
+	float v1 = g.v0 + (g.v1 - g.v0) * fill;
+
+	float quad_vertices[] =
+	{
+		quad.x0, quad.y0, quad.z, g.u0, g.v0,
+		quad.x1, quad.y0, quad.z, g.u1, g.v0,
+		quad.x0, y1, quad.z, g.u0, v1,
+		quad.x1, y1, quad.z, g.u1, v1
+	};
+	vertices.insert(vertices.end(), quad_vertices, quad_vertices + 20);
+}
+
+void HudBatcher::flush(Shader & shader)
+{
+	if(vertices.empty())
+		return;
+
+	int nb_quads = vertices.size() / 20;
+
+	// orphan last frame's storage before streaming
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, HUD_MAX_QUADS * 4 * 5 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+
+	shader.use();
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, atlas);
+	shader.set_int("img", 0);
+	glDrawElements(GL_TRIANGLES, nb_quads * 6, GL_UNSIGNED_SHORT, 0);
+
+	glBindVertexArray(0);
+	vertices.clear();
+}
+
+size_t HudBatcher::get_gpu_bytes() const
+{
+	// mip chain adds about a third
+	return (size_t)HUD_ATLAS_WIDTH * atlas_height * 4 * 4 / 3 + HUD_MAX_QUADS * 4 * 5 * sizeof(float) + HUD_MAX_QUADS * 6 * sizeof(GLushort);
+}
@@ -0,0 +1,113 @@
+/**
+ * \file
+ * Six scoops, one draw. Watto would approve of the savings.
+ * \author Mathias Velo
+ */
+
+#include "instancing.hpp"
+
+InstanceGroup::InstanceGroup(Object* p_prototype) :
+	prototype(p_prototype),
+	SSBO(0),
+	capacity(0)
+{
+	add_instance();
+}
+
+InstanceGroup::~InstanceGroup()
+{
+	glDeleteBuffers(1, &SSBO);
+}
+
+int InstanceGroup::add_instance(glm::mat4 offset)
+{
+	offsets.push_back(offset);
+	transforms.push_back(offset);
+	return offsets.size() - 1;
+}
+
+int InstanceGroup::add_copy(Object* copy)
+{
+	glm::mat4 offset;
+	if(!prototype->match_instance(*copy, offset))
+		return -1;
+	return add_instance(offset);
+}
+
+void InstanceGroup::set_transform(int instance, const glm::mat4 & model)
+{
+	transforms[instance] = model * offsets[instance];
+}
+
+void InstanceGroup::draw(Shader& s, int lod)
+{
+	// grow the buffer when instances were added, orphan it otherwise
+	int nb_instances = transforms.size();
+	if(SSBO == 0)
+		glGenBuffers(1, &SSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, SSBO);
+	capacity = std::max(capacity, nb_instances);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, nb_instances * sizeof(glm::mat4), transforms.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_SSBO_BINDING, SSBO);
+
+	s.use();
+	s.set_int("instanced", 1);
+	prototype->draw_instanced(s, nb_instances, lod);
+	s.set_int("instanced", 0);
+}
+
+int InstanceGroup::get_instance_count() const
+{
+	return transforms.size();
+}
+
+InstanceBatch::~InstanceBatch()
+{
+	for(int i = 0; i < groups.size(); i++)
+	{
+		delete(groups[i]);
+	}
+}
+
+int InstanceBatch::add(Object* object)
+{
+	// fold the object into the first group whose prototype it copies
+	for(int i = 0; i < groups.size(); i++)
+	{
+		int instance = groups[i]->add_copy(object);
+		if(instance != -1)
+		{
+			parts.push_back(Slot{i, instance});
+			return parts.size() - 1;
+		}
+	}
+
+	groups.push_back(new InstanceGroup(object));
+	parts.push_back(Slot{static_cast<int>(groups.size()) - 1, 0});
+	return parts.size() - 1;
+}
+
+void InstanceBatch::set_transform(int part, const glm::mat4 & model)
+{
+	groups[parts[part].group]->set_transform(parts[part].instance, model);
+}
+
+void InstanceBatch::draw(Shader& s, int lod)
+{
+	for(int i = 0; i < groups.size(); i++)
+	{
+		groups[i]->draw(s, lod);
+	}
+}
+
+int InstanceBatch::get_part_count() const
+{
+	return parts.size();
+}
+
+int InstanceBatch::get_group_count() const
+{
+	return groups.size();
+}
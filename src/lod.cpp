@@ -0,0 +1,186 @@
+/**
+ * \file
+ * Fewer triangles the further you are, nobody counts rivets at 600 mph
+ * \author Mathias Velo
+ */
+
+#include "lod.hpp"
+
+struct LodCacheHeader
+{
+	unsigned int magic;
+	unsigned int checksum;
+	float max_error;
+	unsigned int nb_levels;
+};
+
+LodBuilder::LodBuilder(float p_max_error) :
+	max_error(p_max_error)
+{}
+
+unsigned int LodBuilder::checksum(const std::vector<Vertex> & vertices, const std::vector<int> & indices)
+{
+	// whole vertices, uv or normal edits change the seams and so the lods
+	unsigned int hash = fnv1a(vertices.data(), vertices.size() * sizeof(Vertex));
+	return fnv1a(indices.data(), indices.size() * sizeof(int), hash);
+}
+
+void LodBuilder::weld(const std::vector<Vertex> & vertices, const std::vector<int> & indices, std::vector<int> & tris, std::vector<int> & position_id, std::vector<bool> & locked)
+{
+	std::vector<int> remap;
+	MeshOptimizer::weld(vertices, indices, remap, tris);
+
+	// vertices still sharing a position sit on a uv or normal seam, moving one would tear the surface
+	std::unordered_map<glm::vec3, int, PositionHash> positions;
+	std::vector<int> copies;
+	position_id.assign(vertices.size(), -1);
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		if(remap[i] != i)
+			continue;
+		auto it = positions.find(vertices[i].position);
+		if(it == positions.end())
+		{
+			position_id[i] = copies.size();
+			positions[vertices[i].position] = copies.size();
+			copies.push_back(1);
+		}
+		else
+		{
+			position_id[i] = it->second;
+			copies[it->second]++;
+		}
+	}
+
+	locked.assign(vertices.size(), false);
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		if(position_id[i] != -1 && copies[position_id[i]] > 1)
+			locked[i] = true;
+	}
+}
+
+void LodBuilder::build(const std::vector<Vertex> & vertices, const std::vector<int> & indices, LodChain & chain)
+{
+	std::vector<int> tris;
+	std::vector<int> position_id;
+	std::vector<bool> locked;
+	weld(vertices, indices, tris, position_id, locked);
+	int nb_tris = tris.size() / 3;
+
+	chain.indices.clear();
+	chain.errors.clear();
+	if(nb_tris == 0)
+		return;
+
+	glm::vec3 min_corner = vertices[tris[0]].position;
+	glm::vec3 max_corner = min_corner;
+	for(int i = 1; i < tris.size(); i++)
+	{
+		min_corner = glm::min(min_corner, vertices[tris[i]].position);
+		max_corner = glm::max(max_corner, vertices[tris[i]].position);
+	}
+	double radius = glm::length(max_corner - min_corner) * 0.5;
+
+	std::vector<glm::vec3> positions(vertices.size());
+	for(int i = 0; i < vertices.size(); i++)
+		positions[i] = vertices[i].position;
+	QuadricSimplifier simplifier;
+
+	// each level starts from the previous one, errors add up so a level never claims less than it drifted
+	double error = 0.0;
+	for(int level = 1; level < MESH_MAX_LODS; level++)
+	{
+		int target = nb_tris >> level;
+		int before = tris.size() / 3;
+		double limit = max_error * radius * (1 << (level - 1));
+		for(int pass = 0; pass < LOD_MAX_PASSES && tris.size() / 3 > target && error < limit; pass++)
+		{
+			double pass_cost = 0.0;
+			double budget = limit - error;
+			if(simplifier.collapse_pass(positions, position_id, locked, tris, target, budget * budget, pass_cost) == 0)
+				break;
+			error += std::sqrt(pass_cost);
+		}
+
+		if(tris.size() / 3 > before * LOD_MIN_REDUCTION)
+			break;
+
+		chain.indices.push_back(tris);
+		chain.errors.push_back(static_cast<float>(error));
+	}
+
+	std::cout << "	- LOD CHAIN: " << indices.size() / 3;
+	for(int i = 0; i < chain.indices.size(); i++)
+		std::cout << " -> " << chain.indices[i].size() / 3;
+	std::cout << " triangles" << std::endl;
+}
+
+bool LodBuilder::load(const std::string & path, unsigned int checksum, int nb_vertices, int nb_indices, LodChain & chain)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		return false;
+	std::streamoff remaining = file.tellg();
+	file.seekg(0, file.beg);
+
+	LodCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(LodCacheHeader));
+	if(!file || header.magic != LOD_CACHE_MAGIC || header.checksum != checksum || header.max_error != max_error || header.nb_levels >= MESH_MAX_LODS)
+		return false;
+	remaining -= sizeof(LodCacheHeader) + header.nb_levels * sizeof(float);
+	if(remaining < 0)
+		return false;
+
+	// a truncated or foreign file must not size the buffers nor index past the mesh
+	LodChain cached;
+	cached.indices.resize(header.nb_levels);
+	cached.errors.resize(header.nb_levels);
+	file.read(reinterpret_cast<char*>(cached.errors.data()), header.nb_levels * sizeof(float));
+	for(int i = 0; i < cached.indices.size() && file; i++)
+	{
+		unsigned int count = 0;
+		file.read(reinterpret_cast<char*>(&count), sizeof(unsigned int));
+		remaining -= sizeof(unsigned int);
+		if(!file || count > nb_indices || count % 3 != 0 || count * static_cast<std::streamoff>(sizeof(int)) > remaining)
+			return false;
+		cached.indices[i].resize(count);
+		file.read(reinterpret_cast<char*>(cached.indices[i].data()), count * sizeof(int));
+		remaining -= count * sizeof(int);
+		for(int j = 0; j < count; j++)
+		{
+			if(cached.indices[i][j] < 0 || cached.indices[i][j] >= nb_vertices)
+				return false;
+		}
+	}
+	if(!file || remaining != 0)
+		return false;
+
+	chain.indices.swap(cached.indices);
+	chain.errors.swap(cached.errors);
+	return true;
+}
+
+void LodBuilder::save(const std::string & path, unsigned int checksum, const LodChain & chain)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		std::cerr << "Error: failed writing lod chain " << path << std::endl;
+		return;
+	}
+
+	LodCacheHeader header;
+	header.magic = LOD_CACHE_MAGIC;
+	header.checksum = checksum;
+	header.max_error = max_error;
+	header.nb_levels = chain.indices.size();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(LodCacheHeader));
+	file.write(reinterpret_cast<const char*>(chain.errors.data()), chain.errors.size() * sizeof(float));
+	for(int i = 0; i < chain.indices.size(); i++)
+	{
+		unsigned int count = chain.indices[i].size();
+		file.write(reinterpret_cast<const char*>(&count), sizeof(unsigned int));
+		file.write(reinterpret_cast<const char*>(chain.indices[i].data()), count * sizeof(int));
+	}
+}
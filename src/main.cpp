@@ -7,10 +7,34 @@
 #include "game.hpp"
 #include "color.hpp"
 #include "shader.hpp"
+#include <cstring>
 
 int main(int argc, char* argv[])
 {
+	bool memory_report = false;
+	bool occlusion_stats = false;
+	bool hot_reload = false;
+	OCCLUSION_MODE occlusion = OCCLUSION_GPU;
+	for(int i = 1; i < argc; i++)
+	{
+		if(std::strcmp(argv[i], "--memory-report") == 0)
+			memory_report = true;
+		else if(std::strcmp(argv[i], "--cpu-occlusion") == 0)
+			occlusion = OCCLUSION_CPU;
+		else if(std::strcmp(argv[i], "--no-occlusion") == 0)
+			occlusion = OCCLUSION_OFF;
+		else if(std::strcmp(argv[i], "--occlusion-stats") == 0)
+			occlusion_stats = true;
+		else if(std::strcmp(argv[i], "--hot-reload") == 0)
+			hot_reload = true;
+	}
+
     Game podracer("PODRACER - STAR WARS");
+	if(memory_report)
+		podracer.print_memory_report();
+	podracer.set_occlusion(occlusion, occlusion_stats);
+	if(hot_reload)
+		podracer.enable_shader_reload();
 	podracer.start();
 	podracer.quit();
 
@@ -7,14 +7,37 @@
 #include "mesh.hpp"
 #include <glm/gtx/string_cast.hpp>
 
-Mesh::Mesh(std::vector<Vertex> vertices_list, std::vector<int> indices_list, Material m, std::string p_name, bool p_drawable, bool p_dynamic_draw, bool p_lap) :
-	vertices(vertices_list),
-	indices(indices_list),
-	material(m),
+Mesh::Mesh(std::vector<Vertex> vertices_list, std::vector<int> indices_list, Material m, std::string p_name, bool p_drawable, bool p_dynamic_draw, bool p_lap, LodChain p_lods) :
+	VAO(0),
+	VBO(0),
+	EBO(0),
+	format(VERTEX_FULL),
+	short_indices(false),
+	base_vertex(0),
+	first_index(0),
+	vertex_count(vertices_list.size()),
+	index_count(indices_list.size()),
+	arena_index_count(indices_list.size()),
+	nb_lods(1),
+	bounds_center(0.0f),
+	bounds_radius(0.0f),
+	vertices(std::move(vertices_list)),
+	indices(std::move(indices_list)),
+	lods(std::move(p_lods)),
+	material(std::move(m)),
 	name(p_name),
     drawable(p_drawable),
     dynamic_draw(p_dynamic_draw),
     lap(p_lap)
+{
+	compute_bounds();
+	if(dynamic_draw)
+		create_buffers();
+	else
+		upload_to_arena();
+}
+
+void Mesh::create_buffers()
 {
 	// VAO
 	glGenVertexArrays(1, &VAO);
@@ -23,10 +46,7 @@ Mesh::Mesh(std::vector<Vertex> vertices_list, std::vector<int> indices_list, Mat
 	// VBO
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    if(!dynamic_draw)
-	    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-    else
-	    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_DYNAMIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_DYNAMIC_DRAW);
 	
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
 	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, normal)));
@@ -47,57 +67,199 @@ Mesh::Mesh(std::vector<Vertex> vertices_list, std::vector<int> indices_list, Mat
 
 	// Unbind VAO
 	glBindVertexArray(0);
+
+	// rewritten every frame, no lods
+	nb_lods = 1;
+	lod_first_index[0] = 0;
+	lod_index_count[0] = indices.size();
+	lod_error[0] = 0.0f;
 }
 
-void Mesh::recreate(std::vector<Vertex> vertices_list, std::vector<int> indices_list)
+void Mesh::compute_bounds()
 {
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glDeleteVertexArrays(1, &VAO);
+	// bounding sphere around the aabb center, lod selection measures distances from it
+	if(vertices.empty())
+		return;
 
-    // VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+	glm::vec3 min_corner = vertices[0].position;
+	glm::vec3 max_corner = vertices[0].position;
+	for(int i = 1; i < vertices.size(); i++)
+	{
+		min_corner = glm::min(min_corner, vertices[i].position);
+		max_corner = glm::max(max_corner, vertices[i].position);
+	}
 
-    // VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    if(!dynamic_draw)
-        glBufferData(GL_ARRAY_BUFFER, vertices_list.size() * sizeof(Vertex) * 20, vertices_list.data(), GL_STATIC_DRAW);
-    else
-        glBufferData(GL_ARRAY_BUFFER, vertices_list.size() * sizeof(Vertex) * 20, vertices_list.data(), GL_DYNAMIC_DRAW);
+	bounds_center = (min_corner + max_corner) * 0.5f;
+	bounds_radius = 0.0f;
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		bounds_radius = std::max(bounds_radius, glm::length(vertices[i].position - bounds_center));
+	}
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, normal)));
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, texCoords)));
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, bonesID)));
-    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, bonesWeight)));
+static GLuint pack_normal(glm::vec3 n)
+{
+	// snorm 10:10:10:2, w unused
+	n = glm::clamp(n, glm::vec3(-1.0f), glm::vec3(1.0f));
+	GLuint x = static_cast<GLuint>(static_cast<int>(std::round(n.x * 511.0f)) & 0x3FF);
+	GLuint y = static_cast<GLuint>(static_cast<int>(std::round(n.y * 511.0f)) & 0x3FF);
+	GLuint z = static_cast<GLuint>(static_cast<int>(std::round(n.z * 511.0f)) & 0x3FF);
+	return x | (y << 10) | (z << 20);
+}
 
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glEnableVertexAttribArray(3);
-    glEnableVertexAttribArray(4);
+static GLushort pack_unorm16(float v)
+{
+	return static_cast<GLushort>(std::round(glm::clamp(v, 0.0f, 1.0f) * 65535.0f));
+}
 
-    vertices.clear();
-    vertices = vertices_list;
-    indices.clear();
-    indices = indices_list;
+static GLubyte pack_unorm8(float v)
+{
+	return static_cast<GLubyte>(std::round(glm::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
 
-    // EBO
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int), indices.data(), GL_STATIC_DRAW);
-    
-    // Unbind VAO
-    glBindVertexArray(0);
+void Mesh::upload_to_arena()
+{
+	// pick the smallest layout that keeps what this mesh uses
+	bool skinned = false;
+	bool tiled = false;
+	bool wide_bones = false;
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		const Vertex & v = vertices[i];
+		if(v.bonesID.x > 0.0f || v.bonesID.y > 0.0f)
+			skinned = true;
+		if(v.bonesID.x > 255.0f || v.bonesID.y > 255.0f)
+			wide_bones = true;
+		if(v.texCoords.x < 0.0f || v.texCoords.x > 1.0f || v.texCoords.y < 0.0f || v.texCoords.y > 1.0f)
+			tiled = true;
+	}
+
+	if(skinned)
+		format = (tiled || wide_bones) ? VERTEX_FULL : VERTEX_SKINNED;
+	else
+		format = tiled ? VERTEX_STATIC_TILED : VERTEX_STATIC;
+
+	std::vector<unsigned char> vertex_data;
+	if(format == VERTEX_FULL)
+	{
+		vertex_data.resize(vertices.size() * sizeof(Vertex));
+		memcpy(vertex_data.data(), vertices.data(), vertex_data.size());
+	}
+	else if(format == VERTEX_STATIC)
+	{
+		vertex_data.resize(vertices.size() * sizeof(StaticVertex));
+		StaticVertex* out = reinterpret_cast<StaticVertex*>(vertex_data.data());
+		for(int i = 0; i < vertices.size(); i++)
+		{
+			out[i].position = vertices[i].position;
+			out[i].normal = pack_normal(vertices[i].normal);
+			out[i].texCoords[0] = pack_unorm16(vertices[i].texCoords.x);
+			out[i].texCoords[1] = pack_unorm16(vertices[i].texCoords.y);
+		}
+	}
+	else if(format == VERTEX_STATIC_TILED)
+	{
+		vertex_data.resize(vertices.size() * sizeof(StaticTiledVertex));
+		StaticTiledVertex* out = reinterpret_cast<StaticTiledVertex*>(vertex_data.data());
+		for(int i = 0; i < vertices.size(); i++)
+		{
+			out[i].position = vertices[i].position;
+			out[i].normal = pack_normal(vertices[i].normal);
+			out[i].texCoords = vertices[i].texCoords;
+		}
+	}
+	else if(format == VERTEX_SKINNED)
+	{
+		vertex_data.resize(vertices.size() * sizeof(SkinnedVertex));
+		SkinnedVertex* out = reinterpret_cast<SkinnedVertex*>(vertex_data.data());
+		for(int i = 0; i < vertices.size(); i++)
+		{
+			const Vertex & v = vertices[i];
+			out[i].position = v.position;
+			out[i].normal = pack_normal(v.normal);
+			out[i].texCoords[0] = pack_unorm16(v.texCoords.x);
+			out[i].texCoords[1] = pack_unorm16(v.texCoords.y);
+			// bones ids start at 1, -1 (no influence) becomes 0
+			out[i].bonesID[0] = (v.bonesID.x > 0.0f) ? static_cast<GLubyte>(v.bonesID.x) : 0;
+			out[i].bonesID[1] = (v.bonesID.y > 0.0f) ? static_cast<GLubyte>(v.bonesID.y) : 0;
+			out[i].bonesWeight[0] = pack_unorm8(v.bonesWeight.x);
+			out[i].bonesWeight[1] = pack_unorm8(v.bonesWeight.y);
+		}
+	}
+
+	// lods follow the full detail indices in the same range, they all share the vertices
+	nb_lods = 1;
+	lod_first_index[0] = 0;
+	lod_index_count[0] = indices.size();
+	lod_error[0] = 0.0f;
+	const std::vector<int> * index_list = &indices;
+	std::vector<int> chained;
+	if(!lods.indices.empty())
+	{
+		chained = indices;
+		for(int i = 0; i < lods.indices.size() && nb_lods < MESH_MAX_LODS; i++)
+		{
+			lod_first_index[nb_lods] = chained.size();
+			lod_index_count[nb_lods] = lods.indices[i].size();
+			lod_error[nb_lods] = lods.errors[i];
+			chained.insert(chained.end(), lods.indices[i].begin(), lods.indices[i].end());
+			nb_lods++;
+		}
+		index_list = &chained;
+	}
+	arena_index_count = index_list->size();
+
+	// indices are relative to the base vertex, 16 bits are enough for most meshes
+	short_indices = vertices.size() <= 65536;
+	if(short_indices)
+	{
+		std::vector<GLushort> short_list(index_list->begin(), index_list->end());
+		MeshArena::get().allocate(format, true, vertex_data.data(), vertices.size(), short_list.data(), short_list.size(), base_vertex, first_index);
+	}
+	else
+		MeshArena::get().allocate(format, false, vertex_data.data(), vertices.size(), index_list->data(), index_list->size(), base_vertex, first_index);
+
+	for(int i = 0; i < nb_lods; i++)
+	{
+		lod_first_index[i] += first_index;
+	}
+}
+
+void Mesh::recreate(std::vector<Vertex> vertices_list, std::vector<int> indices_list)
+{
+    vertices = std::move(vertices_list);
+    indices = std::move(indices_list);
+    compute_bounds();
+
+    // the lod chain was built for the previous geometry
+    lods = LodChain();
+    if(dynamic_draw)
+    {
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        glDeleteVertexArrays(1, &VAO);
+        create_buffers();
+    }
+    else
+    {
+        MeshArena::get().release(format, short_indices, base_vertex, vertex_count, first_index, arena_index_count);
+        upload_to_arena();
+    }
+
+    vertex_count = vertices.size();
+    index_count = indices.size();
 }
 
 Mesh::~Mesh()
 {
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
-	glDeleteBuffers(1, &EBO);
+	if(dynamic_draw)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+	}
+	else
+		MeshArena::get().release(format, short_indices, base_vertex, vertex_count, first_index, arena_index_count);
 }
 
 std::string Mesh::get_name()
@@ -105,13 +267,8 @@ std::string Mesh::get_name()
 	return name;
 }
 
-void Mesh::draw(Shader& s, DRAWING_MODE mode)
+void Mesh::bind_material(Shader& s)
 {
-	// bind VAO
-	glBindVertexArray(VAO);
-
-	// use shader and sets its texture maps location
-	s.use();
 	int diffuse_tex_number = 0;
 	int specular_tex_number = 0;
 	int texture_count = material.textures.size();
@@ -144,135 +301,135 @@ void Mesh::draw(Shader& s, DRAWING_MODE mode)
 	    }
     }
 	glActiveTexture(GL_TEXTURE0);
+}
+
+void Mesh::bind_VAO()
+{
+	if(dynamic_draw)
+		glBindVertexArray(VAO);
+	else
+		MeshArena::get().bind(format, short_indices);
+}
+
+GLenum Mesh::index_type() const
+{
+	return short_indices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void Mesh::draw(Shader& s, DRAWING_MODE mode, int lod)
+{
+	lod = std::clamp(lod, 0, nb_lods - 1);
+
+	// bind VAO
+	bind_VAO();
+
+	// use shader and sets its texture maps location
+	s.use();
+	bind_material(s);
 
 	// declare that no animation is playing to the vertex shader
 	s.set_int("animation", 0);
 
 	// final step
 	if(mode == SOLID)
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+		glDrawElementsBaseVertex(GL_TRIANGLES, lod_index_count[lod], index_type(), (void*)(lod_first_index[lod] * (short_indices ? sizeof(GLushort) : sizeof(int))), base_vertex);
 	else if(mode == WIREFRAME)
-		glDrawArrays(GL_LINES, 0, vertices.size());
+		glDrawArrays(GL_LINES, base_vertex, vertex_count);
 	glBindVertexArray(0);
 	glActiveTexture(GL_TEXTURE0);
 }
 
-void Mesh::draw(Shader& s, std::map<std::string, Joint*> bones_ptr_list, Animation* anim, int frame, Joint* skeleton)
+void Mesh::draw_instanced(Shader& s, int nb_instances, int lod)
 {
-	// bind VAO
-	glBindVertexArray(VAO);
+	lod = std::clamp(lod, 0, nb_lods - 1);
 
-	// use shader and sets its texture maps location
+	bind_VAO();
 	s.use();
-	int diffuse_tex_number = 0;
-	int specular_tex_number = 0;
-	int texture_count = material.textures.size();
-    
-    if(texture_count == 0)
-    {
-        s.set_int("material.has_textures", 0);
-        s.set_vec3f("material.base_color", material.base_color);
-        s.set_float("material.shininess", material.shininess);
-    }
-    else
-    {
-        s.set_int("material.has_textures", 1);
-        s.set_vec3f("material.base_color", material.base_color);
-        s.set_float("material.shininess", material.shininess);
-	    for(int i = 0; i < texture_count; i++)
-	    {
-		    glActiveTexture(GL_TEXTURE0 + i);
-		    if(material.textures.at(i).type == DIFFUSE_TEXTURE)
-		    {
-			    diffuse_tex_number++;
-			    s.set_int("material.diffuse_" + diffuse_tex_number, i);
-		    }
-		    if(material.textures.at(i).type == SPECULAR_TEXTURE)
-		    {
-			    specular_tex_number++;
-			    s.set_int("material.specular_" + specular_tex_number, i);
-		    }
-		    glBindTexture(GL_TEXTURE_2D, material.textures.at(i).id);
-	    }
-    }
+	bind_material(s);
+	s.set_int("animation", 0);
+
+	// the per instance transforms are already bound (see InstanceGroup::draw)
+	glDrawElementsInstancedBaseVertex(GL_TRIANGLES, lod_index_count[lod], index_type(), (void*)(lod_first_index[lod] * (short_indices ? sizeof(GLushort) : sizeof(int))), nb_instances, base_vertex);
+	glBindVertexArray(0);
 	glActiveTexture(GL_TEXTURE0);
+}
 
-	// if anim not null => means we play an animation
-	// set the joints orientation based on an animation keyframe
-	if(anim != nullptr)
-	{
-		std::vector<Keyframe*>& keys = anim->get_keyframes();
-		int kFrame_count = keys.size();
-		int k = frame;
-		while(k < kFrame_count && keys.at(k)->get_frame() != k)
-		{
-			k++;
-		}
-		Keyframe* kFrame = keys.at(k);
-		std::vector<JointPose*>& jPoseList = kFrame->get_joint_pose_list();
-		int nbJointPose = jPoseList.size();
+void Mesh::draw_skinned(Shader& s)
+{
+	// bind VAO
+	bind_VAO();
 
-		glm::mat4 pose[35];
-		glm::mat4 tr[35];
-		for(int i = 0; i < 35; i++)
-		{
-			pose[i] = glm::mat4(1.0f);
-			tr[i] = glm::mat4(1.0f);
-		}
+	// use shader and sets its texture maps location
+	s.use();
+	bind_material(s);
 
-		for(int b = 0; b < nbJointPose; b++)
-		{
-			std::string jPoseName = jPoseList.at(b)->name;
-			Joint* currentJoint = bones_ptr_list[jPoseName];
+	// the joint palette has already been uploaded by the owning object
+	s.set_int("animation", 1);
 
-			int jointID = currentJoint->get_id();
-			glm::mat4 poseMatrix = jPoseList.at(b)->poseMatrix;
-			glm::mat4 transform = currentJoint->get_transform();
+	// final step
+	glDrawElementsBaseVertex(GL_TRIANGLES, index_count, index_type(), (void*)(first_index * (short_indices ? sizeof(GLushort) : sizeof(int))), base_vertex);
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE0);
+}
 
-			pose[jointID - 1] = poseMatrix;
-			tr[jointID - 1] = transform;
-		}
+std::vector<Vertex> const& Mesh::get_vertex_list() const
+{
+	return vertices;
+}
 
-		// declare that an animation is playing to the vertex shader
-		s.set_int("animation", 1);
+std::vector<int> const& Mesh::get_index_list() const
+{
+	return indices;
+}
 
-		// and send joints pose to an array in the vertex shader
-		for(int m = 0; m < 35; m++)
-		{
-			std::string arg1("transform[");
-			arg1 += std::to_string(m);
-			arg1 += "]";
+std::vector<glm::vec3> const& Mesh::get_position_list() const
+{
+	return positions;
+}
 
-			std::string arg2("bones_pose[");
-			arg2 += std::to_string(m);
-			arg2 += "]";
+void Mesh::compact_geometry()
+{
+	// keep positions + indices for whoever points into them (bullet mesh interfaces)
+	if(dynamic_draw || !positions.empty())
+		return;
 
-			s.set_Matrix(arg1, tr[m]);
-			s.set_Matrix(arg2, pose[m]);
-		}
-		glm::mat4 inv_tr = skeleton->get_inverse_transform();
-		s.set_Matrix("inv_transform", inv_tr);
-	}
-	else
+	positions.resize(vertices.size());
+	for(int i = 0; i < vertices.size(); i++)
 	{
-		// declare that no animation is playing to the vertex shader
-		s.set_int("animation", 0);
+		positions[i] = vertices[i].position;
 	}
+	std::vector<Vertex>().swap(vertices);
+	lods = LodChain();
+}
 
-	// final step
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-	glActiveTexture(GL_TEXTURE0);
+void Mesh::release_geometry()
+{
+	// dynamic meshes are rewritten from the cpu every frame, compacted ones are still referenced
+	if(dynamic_draw || !positions.empty())
+		return;
+
+	std::vector<Vertex>().swap(vertices);
+	std::vector<int>().swap(indices);
+	lods = LodChain();
 }
 
-std::vector<Vertex> const& Mesh::get_vertex_list() const
+size_t Mesh::get_cpu_bytes() const
 {
-	return vertices;
+	size_t bytes = vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(int) + positions.capacity() * sizeof(glm::vec3);
+	for(int i = 0; i < lods.indices.size(); i++)
+	{
+		bytes += lods.indices[i].capacity() * sizeof(int);
+	}
+	return bytes;
 }
 
-std::vector<int> const& Mesh::get_index_list() const
+size_t Mesh::get_gpu_bytes() const
 {
-	return indices;
+	if(dynamic_draw)
+		return vertex_count * sizeof(Vertex) + index_count * sizeof(int);
+
+	int strides[VERTEX_FORMAT_COUNT] = {sizeof(Vertex), sizeof(StaticVertex), sizeof(StaticTiledVertex), sizeof(SkinnedVertex)};
+	return (size_t)vertex_count * strides[format] + (size_t)arena_index_count * (short_indices ? sizeof(GLushort) : sizeof(int));
 }
 
 bool Mesh::is_drawable()
@@ -290,6 +447,244 @@ bool Mesh::is_lap_building() const
     return lap;
 }
 
+int Mesh::get_lod_count() const
+{
+	return nb_lods;
+}
+
+// ####################################################################################################
+// ####################################################################################################
+// ####################################################################################################
+
+MeshArena::MeshArena()
+{
+	int strides[VERTEX_FORMAT_COUNT] = {sizeof(Vertex), sizeof(StaticVertex), sizeof(StaticTiledVertex), sizeof(SkinnedVertex)};
+	for(int i = 0; i < VERTEX_FORMAT_COUNT; i++)
+	{
+		VAO[i] = 0;
+		vertex_buffers[i] = ArenaBuffer{0, strides[i], MESH_ARENA_VERTICES, 0, {}};
+	}
+	index_buffers[0] = ArenaBuffer{0, sizeof(int), MESH_ARENA_INDICES, 0, {}};
+	index_buffers[1] = ArenaBuffer{0, sizeof(GLushort), MESH_ARENA_INDICES, 0, {}};
+}
+
+MeshArena & MeshArena::get()
+{
+	static MeshArena arena;
+	return arena;
+}
+
+void MeshArena::setup_VAO(VertexFormat format)
+{
+	if(VAO[format] == 0)
+		glGenVertexArrays(1, &VAO[format]);
+
+	glBindVertexArray(VAO[format]);
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[format].id);
+
+	// missing bone attributes read as 0, i.e. no influence
+	if(format == VERTEX_FULL)
+	{
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, normal)));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, texCoords)));
+		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, bonesID)));
+		glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, bonesWeight)));
+		glEnableVertexAttribArray(3);
+		glEnableVertexAttribArray(4);
+	}
+	else if(format == VERTEX_STATIC)
+	{
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)0);
+		glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(StaticVertex), (void*)(offsetof(StaticVertex, normal)));
+		glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(StaticVertex), (void*)(offsetof(StaticVertex, texCoords)));
+	}
+	else if(format == VERTEX_STATIC_TILED)
+	{
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StaticTiledVertex), (void*)0);
+		glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(StaticTiledVertex), (void*)(offsetof(StaticTiledVertex, normal)));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(StaticTiledVertex), (void*)(offsetof(StaticTiledVertex, texCoords)));
+	}
+	else if(format == VERTEX_SKINNED)
+	{
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)0);
+		glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(SkinnedVertex), (void*)(offsetof(SkinnedVertex, normal)));
+		glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SkinnedVertex), (void*)(offsetof(SkinnedVertex, texCoords)));
+		glVertexAttribPointer(3, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(SkinnedVertex), (void*)(offsetof(SkinnedVertex, bonesID)));
+		glVertexAttribPointer(4, 2, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SkinnedVertex), (void*)(offsetof(SkinnedVertex, bonesWeight)));
+		glEnableVertexAttribArray(3);
+		glEnableVertexAttribArray(4);
+	}
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+}
+
+void MeshArena::allocate(VertexFormat format, bool short_indices, const void* vertex_data, int vertex_count, const void* index_data, int index_count, int & base_vertex, int & first_index)
+{
+	ArenaBuffer & vertex_buffer = vertex_buffers[format];
+	ArenaBuffer & index_buffer = index_buffers[short_indices ? 1 : 0];
+
+	GLuint prev_VBO = vertex_buffer.id;
+	base_vertex = reserve(vertex_buffer, vertex_count);
+	first_index = reserve(index_buffer, index_count);
+	if(vertex_buffer.id != prev_VBO)
+		setup_VAO(format);
+
+	// upload through the copy target so the bound VAO keeps its element buffer
+	glBindBuffer(GL_COPY_WRITE_BUFFER, vertex_buffer.id);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)base_vertex * vertex_buffer.stride, (GLsizeiptr)vertex_count * vertex_buffer.stride, vertex_data);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, index_buffer.id);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)first_index * index_buffer.stride, (GLsizeiptr)index_count * index_buffer.stride, index_data);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void MeshArena::release(VertexFormat format, bool short_indices, int base_vertex, int vertex_count, int first_index, int index_count)
+{
+	give_back(vertex_buffers[format], base_vertex, vertex_count);
+	give_back(index_buffers[short_indices ? 1 : 0], first_index, index_count);
+}
+
+void MeshArena::bind(VertexFormat format, bool short_indices)
+{
+	// the element buffer is VAO state, switching it is a cheap rebind
+	glBindVertexArray(VAO[format]);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffers[short_indices ? 1 : 0].id);
+}
+
+int MeshArena::reserve(ArenaBuffer & buffer, int count)
+{
+	if(count == 0)
+		return 0;
+
+	// first fit in the holes left by released meshes
+	std::vector<ArenaRange> & free_list = buffer.free_list;
+	for(int i = 0; i < free_list.size(); i++)
+	{
+		if(free_list[i].count >= count)
+		{
+			int offset = free_list[i].offset;
+			free_list[i].offset += count;
+			free_list[i].count -= count;
+			if(free_list[i].count == 0)
+				free_list.erase(free_list.begin() + i);
+			return offset;
+		}
+	}
+
+	// created on first use, then grown by doubling, the old content is copied on the GPU
+	if(buffer.id == 0 || buffer.used + count > buffer.capacity)
+	{
+		int new_capacity = buffer.capacity;
+		while(buffer.used + count > new_capacity)
+			new_capacity *= 2;
+
+		GLuint grown;
+		glGenBuffers(1, &grown);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+		glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)new_capacity * buffer.stride, nullptr, GL_STATIC_DRAW);
+		if(buffer.id != 0)
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer.id);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)buffer.used * buffer.stride);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			glDeleteBuffers(1, &buffer.id);
+		}
+
+		buffer.id = grown;
+		buffer.capacity = new_capacity;
+	}
+
+	int offset = buffer.used;
+	buffer.used += count;
+	return offset;
+}
+
+void MeshArena::give_back(ArenaBuffer & buffer, int offset, int count)
+{
+	// meshes outliving the GL context have nothing left to give back
+	if(buffer.id == 0 || count == 0)
+		return;
+
+	std::vector<ArenaRange> & free_list = buffer.free_list;
+	int i = 0;
+	while(i < free_list.size() && free_list[i].offset < offset)
+		i++;
+	free_list.insert(free_list.begin() + i, ArenaRange{offset, count});
+
+	// merge with the neighbouring holes
+	if(i + 1 < free_list.size() && free_list[i].offset + free_list[i].count == free_list[i + 1].offset)
+	{
+		free_list[i].count += free_list[i + 1].count;
+		free_list.erase(free_list.begin() + i + 1);
+	}
+	if(i > 0 && free_list[i - 1].offset + free_list[i - 1].count == free_list[i].offset)
+	{
+		free_list[i - 1].count += free_list[i].count;
+		free_list.erase(free_list.begin() + i);
+		i--;
+	}
+
+	// a hole at the end only lowers the high water mark
+	if(free_list[i].offset + free_list[i].count == buffer.used)
+	{
+		buffer.used = free_list[i].offset;
+		free_list.erase(free_list.begin() + i);
+	}
+}
+
+size_t MeshArena::get_used_bytes() const
+{
+	size_t bytes = 0;
+	for(int i = 0; i < VERTEX_FORMAT_COUNT; i++)
+	{
+		bytes += (size_t)vertex_buffers[i].used * vertex_buffers[i].stride;
+	}
+	for(int i = 0; i < 2; i++)
+	{
+		bytes += (size_t)index_buffers[i].used * index_buffers[i].stride;
+	}
+	return bytes;
+}
+
+size_t MeshArena::get_gpu_bytes() const
+{
+	size_t bytes = 0;
+	for(int i = 0; i < VERTEX_FORMAT_COUNT; i++)
+	{
+		if(vertex_buffers[i].id != 0)
+			bytes += (size_t)vertex_buffers[i].capacity * vertex_buffers[i].stride;
+	}
+	for(int i = 0; i < 2; i++)
+	{
+		if(index_buffers[i].id != 0)
+			bytes += (size_t)index_buffers[i].capacity * index_buffers[i].stride;
+	}
+	return bytes;
+}
+
+void MeshArena::destroy()
+{
+	for(int i = 0; i < VERTEX_FORMAT_COUNT; i++)
+	{
+		glDeleteVertexArrays(1, &VAO[i]);
+		glDeleteBuffers(1, &vertex_buffers[i].id);
+		VAO[i] = 0;
+		vertex_buffers[i].id = 0;
+		vertex_buffers[i].used = 0;
+		vertex_buffers[i].free_list.clear();
+	}
+	for(int i = 0; i < 2; i++)
+	{
+		glDeleteBuffers(1, &index_buffers[i].id);
+		index_buffers[i].id = 0;
+		index_buffers[i].used = 0;
+		index_buffers[i].free_list.clear();
+	}
+}
+
 // ####################################################################################################
 // ####################################################################################################
 // ####################################################################################################
@@ -297,11 +692,24 @@ bool Mesh::is_lap_building() const
 DrawMaster::DrawMaster()
 {
     root = nullptr;
+    camera_list.indirect_buffer = 0;
+    camera_list.draw_SSBO = 0;
+    shadow_list.indirect_buffer = 0;
+    shadow_list.draw_SSBO = 0;
+    camera_list_dirty = true;
+    material_SSBO = 0;
 }
 
 DrawMaster::~DrawMaster()
 {
     destroy(root);
+    glDeleteBuffers(1, &material_SSBO);
+    DrawList* lists[2] = {&camera_list, &shadow_list};
+    for(int i = 0; i < 2; i++)
+    {
+        glDeleteBuffers(1, &lists[i]->indirect_buffer);
+        glDeleteBuffers(1, &lists[i]->draw_SSBO);
+    }
 }
 
 void DrawMaster::destroy(struct QuadTree* node)
@@ -329,7 +737,7 @@ void DrawMaster::destroy(struct QuadTree* node)
     }
 }
 
-void DrawMaster::build_tree(std::vector<Mesh*> m)
+void DrawMaster::build_tree(const std::vector<Mesh*> & m)
 {
     std::vector<AABB> env_AABB;
     AABB top_level;
@@ -425,6 +833,223 @@ void DrawMaster::build_tree(std::vector<Mesh*> m)
     process_QuadTree_subLevels(root, 5);
     fill_tree(root, env_AABB, m);
     //print_tree(root);
+
+    meshes = m;
+    lod_states.assign(meshes.size(), LodState{0, 0, LOD_FADE_FRAMES});
+    upload_materials();
+
+    // occlusion bounds per mesh, the big ones also occlude for the software rasterizer (coarsest lod)
+    std::vector<glm::vec3> min_corners(env_AABB.size());
+    std::vector<glm::vec3> max_corners(env_AABB.size());
+    for(int i = 0; i < env_AABB.size(); i++)
+    {
+        min_corners[i] = glm::vec3(env_AABB[i].min_x, env_AABB[i].min_y, env_AABB[i].min_z);
+        max_corners[i] = glm::vec3(env_AABB[i].max_x, env_AABB[i].max_y, env_AABB[i].max_z);
+
+        glm::vec3 extent = max_corners[i] - min_corners[i];
+        if(m[i]->dynamic_draw || m[i]->is_lap_building() || std::max(extent.x, std::max(extent.y, extent.z)) < OCCLUSION_MIN_OCCLUDER_SIZE)
+            continue;
+
+        std::vector<glm::vec3> positions(m[i]->vertices.size());
+        for(int j = 0; j < positions.size(); j++)
+        {
+            positions[j] = m[i]->vertices[j].position;
+        }
+        occlusion.add_occluder(positions, m[i]->lods.indices.empty() ? m[i]->indices : m[i]->lods.indices.back());
+    }
+    occlusion.set_bounds(min_corners, max_corners);
+}
+
+void DrawMaster::upload_materials()
+{
+    // one material per mesh, commands reach it through the draw SSBO
+    std::vector<GpuMaterial> materials(meshes.size());
+    diffuse_maps.assign(meshes.size(), 0);
+    for(int i = 0; i < meshes.size(); i++)
+    {
+        const Material & mat = meshes[i]->material;
+        materials[i].base_color = glm::vec4(mat.base_color, mat.textures.empty() ? 0.0f : 1.0f);
+        for(int j = 0; j < mat.textures.size(); j++)
+        {
+            if(mat.textures[j].type == DIFFUSE_TEXTURE)
+            {
+                diffuse_maps[i] = mat.textures[j].id;
+                break;
+            }
+        }
+    }
+
+    glGenBuffers(1, &material_SSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, material_SSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(GpuMaterial), materials.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // up to two commands per mesh while a lod transition fades
+    DrawList* lists[2] = {&camera_list, &shadow_list};
+    for(int i = 0; i < 2; i++)
+    {
+        glGenBuffers(1, &lists[i]->indirect_buffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, lists[i]->indirect_buffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, 2 * meshes.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glGenBuffers(1, &lists[i]->draw_SSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lists[i]->draw_SSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, 2 * meshes.size() * sizeof(GpuDraw), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        lists[i]->commands.reserve(2 * meshes.size());
+        lists[i]->draws.reserve(2 * meshes.size());
+    }
+    items.reserve(2 * meshes.size());
+}
+
+void DrawMaster::draw(Shader& s, bool shadow_pass)
+{
+    s.use();
+
+    // dynamic meshes keep their own buffers
+    for(int i = 0; i < meshes.size(); i++)
+    {
+        Mesh* m = meshes[i];
+        if(m->drawable && m->dynamic_draw)
+        {
+            s.set_int("indirect", 0);
+            m->draw(s);
+        }
+    }
+
+    DrawList & list = shadow_pass ? shadow_list : camera_list;
+    if(shadow_pass || camera_list_dirty)
+        build_draw_list(list, shadow_pass);
+    if(!shadow_pass)
+        camera_list_dirty = false;
+
+    if(list.batches.empty())
+        return;
+
+    // the cull pass may have switched programs
+    s.use();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, list.indirect_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_SSBO_BINDING, material_SSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_SSBO_BINDING, list.draw_SSBO);
+
+    s.set_int("animation", 0);
+    s.set_int("indirect", 1);
+    s.set_int("material.diffuse_1", 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    // no bindless textures, so one multi draw per format and diffuse texture
+    int first = 0;
+    for(int i = 0; i < list.batches.size(); i++)
+    {
+        const DrawBatch & batch = list.batches[i];
+        if(i == 0 || batch.format != list.batches[i - 1].format || batch.short_indices != list.batches[i - 1].short_indices)
+            MeshArena::get().bind(batch.format, batch.short_indices);
+
+        glBindTexture(GL_TEXTURE_2D, batch.texture);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, batch.short_indices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(first * sizeof(DrawElementsIndirectCommand)), batch.count, 0);
+        first += batch.count;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    s.set_int("indirect", 0);
+}
+
+void DrawMaster::build_draw_list(DrawList & list, bool shadow_pass)
+{
+    // visible static meshes at their lod
+    items.clear();
+    for(int i = 0; i < meshes.size(); i++)
+    {
+        Mesh* m = meshes[i];
+        if(!m->drawable || m->dynamic_draw || m->index_count == 0)
+            continue;
+
+        // shadow maps don't need the detail, and a dithered caster would leave holes
+        const LodState & state = lod_states[i];
+        if(shadow_pass)
+            items.push_back(DrawItem{i, std::min(std::max(state.lod, LOD_SHADOW), m->nb_lods - 1), 1.0f});
+        else if(state.fade_frame < LOD_FADE_FRAMES)
+        {
+            float fade = (state.fade_frame + 1.0f) / (LOD_FADE_FRAMES + 1.0f);
+            items.push_back(DrawItem{i, state.lod, fade});
+            items.push_back(DrawItem{i, state.prev_lod, -fade});
+        }
+        else
+            items.push_back(DrawItem{i, state.lod, 1.0f});
+    }
+
+    // sort by vertex format, index type then diffuse texture
+    std::sort(items.begin(), items.end(), [this](const DrawItem & a, const DrawItem & b)
+    {
+        const Mesh* ma = meshes[a.mesh];
+        const Mesh* mb = meshes[b.mesh];
+        if(ma->format != mb->format)
+            return ma->format < mb->format;
+        if(ma->short_indices != mb->short_indices)
+            return ma->short_indices < mb->short_indices;
+        return diffuse_maps[a.mesh] < diffuse_maps[b.mesh];
+    });
+
+    list.commands.clear();
+    list.draws.clear();
+    list.batches.clear();
+    for(int i = 0; i < items.size(); i++)
+    {
+        const DrawItem & item = items[i];
+        Mesh* m = meshes[item.mesh];
+        list.commands.push_back(DrawElementsIndirectCommand{(GLuint)m->lod_index_count[item.lod], 1, (GLuint)m->lod_first_index[item.lod], m->base_vertex, (GLuint)i});
+        list.draws.push_back(GpuDraw{item.mesh, item.fade});
+
+        if(list.batches.empty() || list.batches.back().format != m->format || list.batches.back().short_indices != m->short_indices || list.batches.back().texture != diffuse_maps[item.mesh])
+            list.batches.push_back(DrawBatch{m->format, m->short_indices, diffuse_maps[item.mesh], 0});
+        list.batches.back().count++;
+    }
+
+    if(list.commands.empty())
+        return;
+
+    // software occlusion drops hidden commands before the upload (the batches keep them, with no instance)
+    if(!shadow_pass && occlusion.get_mode() == OCCLUSION_CPU)
+    {
+        cull_meshes.clear();
+        cull_counts.clear();
+        for(int i = 0; i < list.commands.size(); i++)
+        {
+            cull_meshes.push_back(list.draws[i].material);
+            cull_counts.push_back(list.commands[i].count);
+        }
+        occlusion.cull_cpu(cull_meshes, cull_counts, cull_visible);
+        for(int i = 0; i < list.commands.size(); i++)
+        {
+            if(!cull_visible[i])
+                list.commands[i].instance_count = 0;
+        }
+    }
+
+    // orphan last frame's commands before streaming
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, list.indirect_buffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, 2 * meshes.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, list.commands.size() * sizeof(DrawElementsIndirectCommand), list.commands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, list.draw_SSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, 2 * meshes.size() * sizeof(GpuDraw), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, list.draws.size() * sizeof(GpuDraw), list.draws.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // hi-z occlusion rewrites the instance counts on the gpu
+    if(!shadow_pass && occlusion.get_mode() == OCCLUSION_GPU)
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_SSBO_BINDING, list.draw_SSBO);
+        occlusion.cull_gpu(list.indirect_buffer, list.commands.size());
+    }
+}
+
+OcclusionCuller & DrawMaster::get_occlusion()
+{
+    return occlusion;
 }
 
 void DrawMaster::merge_AABB(const AABB & a, const AABB & b, AABB & res)
@@ -540,7 +1165,7 @@ void DrawMaster::process_QuadTree_subLevels(struct QuadTree * node, int lvl)
     }
 }
 
-void DrawMaster::fill_tree(struct QuadTree * node, const std::vector<AABB> & AABB_list, std::vector<Mesh*> m)
+void DrawMaster::fill_tree(struct QuadTree * node, const std::vector<AABB> & AABB_list, const std::vector<Mesh*> & m)
 {
    if(node->bottom_left == nullptr && node->bottom_right == nullptr && node->top_right == nullptr && node->top_left == nullptr)
    {
@@ -675,6 +1300,46 @@ void DrawMaster::process_drawable_meshes_list(glm::vec3 cam_pos, glm::vec3 cam_v
 
     // update drawable status for env meshes
     update_drawable(frustum_AABB, root);
+    select_lods(cam_pos, cam_fov);
+    camera_list_dirty = true;
+}
+
+void DrawMaster::select_lods(glm::vec3 cam_pos, float cam_fov)
+{
+    // pixels covered by one world unit seen from one unit away
+    float pixels_per_unit = LOD_SCREEN_HEIGHT / (2.0f * tan(cam_fov / 2.0f));
+
+    for(int i = 0; i < meshes.size(); i++)
+    {
+        Mesh* m = meshes[i];
+        LodState & state = lod_states[i];
+        if(state.fade_frame < LOD_FADE_FRAMES)
+            state.fade_frame++;
+        if(m->nb_lods == 1)
+            continue;
+
+        // coarsest lod whose error projects under a pixel from the closest point of the bounding sphere
+        float distance = std::max(glm::length(m->bounds_center - cam_pos) - m->bounds_radius, 1.0f);
+        int lod = 0;
+        while(lod + 1 < m->nb_lods && m->lod_error[lod + 1] * pixels_per_unit / distance < LOD_PIXEL_ERROR)
+            lod++;
+
+        if(lod == state.lod)
+            continue;
+
+        // hidden meshes switch right away, visible ones dither over a few frames (one transition at a time)
+        if(!m->drawable)
+        {
+            state.lod = lod;
+            state.fade_frame = LOD_FADE_FRAMES;
+        }
+        else if(state.fade_frame == LOD_FADE_FRAMES)
+        {
+            state.prev_lod = state.lod;
+            state.lod = lod;
+            state.fade_frame = 0;
+        }
+    }
 }
 
 void DrawMaster::update_drawable(const struct AABB & f_AABB, struct QuadTree * node)
@@ -715,6 +1380,13 @@ void Mesh::update_VBO(std::vector<Vertex> const & updated_vertices)
     {
         indices.push_back(i);
     }
+
+    // static meshes are not streamed, move them to a new arena range
+    if(!dynamic_draw)
+    {
+        recreate(updated_vertices, indices);
+        return;
+    }
     
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
@@ -729,4 +1401,7 @@ void Mesh::update_VBO(std::vector<Vertex> const & updated_vertices)
 
     vertices.clear();
     vertices = updated_vertices;
+    vertex_count = vertices.size();
+    index_count = indices.size();
+    lod_index_count[0] = index_count;
 }
@@ -0,0 +1,430 @@
+/**
+ * \file
+ * Same triangles, better order. The vertex shader thanks you.
+ * \author Mathias Velo
+ */
+
+#include "mesh_optimizer.hpp"
+
+#define FORSYTH_LAST_TRIANGLE_SCORE 0.75f
+#define FORSYTH_DECAY_POWER 1.5f
+#define FORSYTH_VALENCE_SCALE 2.0f
+
+struct MeshCacheHeader
+{
+	unsigned int magic;
+	unsigned int checksum;
+	unsigned int cache_size;
+	unsigned int nb_vertices;
+	unsigned int nb_indices;
+	MeshOptStats stats;
+};
+
+// fifo cache simulation, a vertex is resident while fewer than VERTEX_FIFO_SIZE misses happened since its own
+static unsigned int fifo_misses(const int * tri, std::vector<unsigned int> & stamps, unsigned int & timestamp)
+{
+	unsigned int misses = 0;
+	for(int k = 0; k < 3; k++)
+	{
+		if(timestamp - stamps[tri[k]] > VERTEX_FIFO_SIZE)
+		{
+			stamps[tri[k]] = timestamp++;
+			misses++;
+		}
+	}
+	return misses;
+}
+
+unsigned int MeshOptimizer::cache_misses(const std::vector<int> & indices, int nb_vertices)
+{
+	std::vector<unsigned int> stamps(nb_vertices, 0);
+	unsigned int timestamp = VERTEX_FIFO_SIZE + 1;
+	unsigned int misses = 0;
+	for(int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		misses += fifo_misses(&indices[i], stamps, timestamp);
+	}
+	return misses;
+}
+
+void MeshOptimizer::optimize(std::vector<Vertex> & vertices, std::vector<int> & indices, MeshOptStats & stats)
+{
+	stats.triangles_before = indices.size() / 3;
+	stats.vertices_before = vertices.size();
+	stats.misses_before = cache_misses(indices, vertices.size());
+
+	// point sets (emitters) have nothing to reorder and every vertex counts
+	if(indices.empty())
+	{
+		stats.triangles_after = stats.triangles_before;
+		stats.vertices_after = stats.vertices_before;
+		stats.misses_after = stats.misses_before;
+		return;
+	}
+
+	// the fetch remap drops the copies nothing points to anymore
+	std::vector<int> remap;
+	std::vector<int> tris;
+	weld(vertices, indices, remap, tris);
+	indices.swap(tris);
+	optimize_vertex_cache(indices, vertices.size());
+	optimize_overdraw(vertices, indices);
+	remap_fetch(vertices, indices);
+
+	stats.triangles_after = indices.size() / 3;
+	stats.vertices_after = vertices.size();
+	stats.misses_after = cache_misses(indices, vertices.size());
+}
+
+void MeshOptimizer::weld(const std::vector<Vertex> & vertices, const std::vector<int> & indices, std::vector<int> & remap, std::vector<int> & tris)
+{
+	// OBJ imports duplicate every face corner, point identical corners to their first copy
+	std::unordered_map<Vertex, int, VertexHash, VertexEqual> unique;
+	remap.resize(vertices.size());
+	for(int i = 0; i < vertices.size(); i++)
+	{
+		auto it = unique.find(vertices[i]);
+		if(it == unique.end())
+		{
+			unique.emplace(vertices[i], i);
+			remap[i] = i;
+		}
+		else
+			remap[i] = it->second;
+	}
+
+	tris.clear();
+	tris.reserve(indices.size());
+	for(int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		int a = remap[indices[i]];
+		int b = remap[indices[i + 1]];
+		int c = remap[indices[i + 2]];
+		if(a == b || b == c || a == c)
+			continue;
+		tris.push_back(a);
+		tris.push_back(b);
+		tris.push_back(c);
+	}
+}
+
+float MeshOptimizer::vertex_score(int cache_position, int remaining) const
+{
+	// Tom Forsyth, linear-speed vertex cache optimisation
+	if(remaining == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if(cache_position >= 0)
+	{
+		// the triangle just emitted, don't reward using it again straight away
+		if(cache_position < 3)
+			score = FORSYTH_LAST_TRIANGLE_SCORE;
+		else
+			score = std::pow(1.0f - (cache_position - 3) / static_cast<float>(VERTEX_CACHE_SIZE - 3), FORSYTH_DECAY_POWER);
+	}
+
+	// vertices with few triangles left go first so they aren't stranded
+	return score + FORSYTH_VALENCE_SCALE / std::sqrt(static_cast<float>(remaining));
+}
+
+void MeshOptimizer::optimize_vertex_cache(std::vector<int> & indices, int nb_vertices)
+{
+	int nb_tris = indices.size() / 3;
+	if(nb_tris == 0)
+		return;
+
+	// triangles around each vertex, emitted ones are swapped past the remaining count
+	std::vector<int> remaining(nb_vertices, 0);
+	for(int i = 0; i < nb_tris * 3; i++)
+	{
+		remaining[indices[i]]++;
+	}
+	std::vector<int> adj_offset(nb_vertices + 1, 0);
+	for(int v = 0; v < nb_vertices; v++)
+	{
+		adj_offset[v + 1] = adj_offset[v] + remaining[v];
+	}
+	std::vector<int> adj(adj_offset.back());
+	std::vector<int> fill(adj_offset.begin(), adj_offset.end() - 1);
+	for(int t = 0; t < nb_tris; t++)
+	{
+		for(int k = 0; k < 3; k++)
+			adj[fill[indices[t * 3 + k]]++] = t;
+	}
+
+	std::vector<int> cache_position(nb_vertices, -1);
+	std::vector<float> score(nb_vertices);
+	for(int v = 0; v < nb_vertices; v++)
+	{
+		score[v] = vertex_score(-1, remaining[v]);
+	}
+	std::vector<float> tri_score(nb_tris);
+	for(int t = 0; t < nb_tris; t++)
+	{
+		tri_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+	}
+
+	std::vector<bool> emitted(nb_tris, false);
+	std::vector<int> cache;
+	std::vector<int> new_cache;
+	cache.reserve(VERTEX_CACHE_SIZE + 3);
+	new_cache.reserve(VERTEX_CACHE_SIZE + 3);
+	std::vector<int> result;
+	result.reserve(nb_tris * 3);
+	int best = -1;
+	int next_unused = 0;
+	for(int n = 0; n < nb_tris; n++)
+	{
+		// dead end, carry on with the next triangle in the original order
+		if(best == -1)
+		{
+			while(emitted[next_unused])
+				next_unused++;
+			best = next_unused;
+		}
+
+		const int * tri = &indices[best * 3];
+		emitted[best] = true;
+		result.insert(result.end(), tri, tri + 3);
+
+		for(int k = 0; k < 3; k++)
+		{
+			int v = tri[k];
+			int begin = adj_offset[v];
+			int end = begin + remaining[v];
+			for(int a = begin; a < end; a++)
+			{
+				if(adj[a] == best)
+				{
+					std::swap(adj[a], adj[end - 1]);
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// most recent first, the triangle's vertices move to the front
+		new_cache.assign(tri, tri + 3);
+		for(int i = 0; i < cache.size(); i++)
+		{
+			if(cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+				new_cache.push_back(cache[i]);
+		}
+
+		for(int i = 0; i < new_cache.size(); i++)
+		{
+			int v = new_cache[i];
+			cache_position[v] = (i < VERTEX_CACHE_SIZE) ? i : -1;
+			score[v] = vertex_score(cache_position[v], remaining[v]);
+		}
+
+		// only triangles touching the cache changed score, the best of them goes next
+		best = -1;
+		float best_score = -1.0f;
+		for(int i = 0; i < new_cache.size(); i++)
+		{
+			int v = new_cache[i];
+			for(int a = adj_offset[v]; a < adj_offset[v] + remaining[v]; a++)
+			{
+				int t = adj[a];
+				tri_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+				if(tri_score[t] > best_score)
+				{
+					best_score = tri_score[t];
+					best = t;
+				}
+			}
+		}
+
+		if(new_cache.size() > VERTEX_CACHE_SIZE)
+			new_cache.resize(VERTEX_CACHE_SIZE);
+		cache.swap(new_cache);
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::optimize_overdraw(const std::vector<Vertex> & vertices, std::vector<int> & indices)
+{
+	// Sander et al. fast triangle reordering: cut the cache order into clusters and draw the outward facing ones first
+	int nb_tris = indices.size() / 3;
+	if(nb_tris == 0)
+		return;
+
+	std::vector<unsigned int> stamps(vertices.size(), 0);
+	unsigned int timestamp = VERTEX_FIFO_SIZE + 1;
+
+	// hard boundaries where the cache order restarted (all three vertices missed)
+	std::vector<int> hard;
+	for(int t = 0; t < nb_tris; t++)
+	{
+		if(fifo_misses(&indices[t * 3], stamps, timestamp) == 3)
+			hard.push_back(t);
+	}
+	hard.push_back(nb_tris);
+
+	// soft boundaries wherever a cluster is already as cache efficient as the whole run
+	std::vector<int> clusters;
+	for(int h = 0; h + 1 < hard.size(); h++)
+	{
+		int start = hard[h];
+		int end = hard[h + 1];
+
+		timestamp += VERTEX_FIFO_SIZE + 1;
+		unsigned int misses = 0;
+		for(int t = start; t < end; t++)
+		{
+			misses += fifo_misses(&indices[t * 3], stamps, timestamp);
+		}
+		float threshold = OVERDRAW_THRESHOLD * misses / (end - start);
+
+		timestamp += VERTEX_FIFO_SIZE + 1;
+		int cluster_start = start;
+		unsigned int cluster_misses = 0;
+		for(int t = start; t < end; t++)
+		{
+			cluster_misses += fifo_misses(&indices[t * 3], stamps, timestamp);
+			if(cluster_misses <= threshold * (t - cluster_start + 1))
+			{
+				clusters.push_back(cluster_start);
+				timestamp += VERTEX_FIFO_SIZE + 1;
+				cluster_start = t + 1;
+				cluster_misses = 0;
+			}
+		}
+		if(cluster_start != end)
+			clusters.push_back(cluster_start);
+	}
+	clusters.push_back(nb_tris);
+
+	// area weighted centroid and normal of the mesh and of each cluster
+	int nb_clusters = clusters.size() - 1;
+	std::vector<glm::vec3> centroids(nb_clusters, glm::vec3(0.0f));
+	std::vector<glm::vec3> normals(nb_clusters, glm::vec3(0.0f));
+	std::vector<float> areas(nb_clusters, 0.0f);
+	glm::vec3 mesh_centroid(0.0f);
+	float mesh_area = 0.0f;
+	for(int c = 0; c < nb_clusters; c++)
+	{
+		for(int t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			glm::vec3 a = vertices[indices[t * 3]].position;
+			glm::vec3 b = vertices[indices[t * 3 + 1]].position;
+			glm::vec3 p = vertices[indices[t * 3 + 2]].position;
+			glm::vec3 n = glm::cross(b - a, p - a);
+			float area = glm::length(n);
+			centroids[c] += (a + b + p) * (area / 3.0f);
+			normals[c] += n;
+			areas[c] += area;
+		}
+		mesh_centroid += centroids[c];
+		mesh_area += areas[c];
+	}
+	if(mesh_area > 0.0f)
+		mesh_centroid /= mesh_area;
+
+	std::vector<float> keys(nb_clusters, 0.0f);
+	for(int c = 0; c < nb_clusters; c++)
+	{
+		float length = glm::length(normals[c]);
+		if(areas[c] > 0.0f && length > 0.0f)
+			keys[c] = glm::dot(centroids[c] / areas[c] - mesh_centroid, normals[c] / length);
+	}
+
+	std::vector<int> order(nb_clusters);
+	for(int c = 0; c < nb_clusters; c++)
+	{
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](int a, int b)
+	{
+		return keys[a] > keys[b];
+	});
+
+	std::vector<int> result;
+	result.reserve(indices.size());
+	for(int c : order)
+	{
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+	indices.swap(result);
+}
+
+void MeshOptimizer::remap_fetch(std::vector<Vertex> & vertices, std::vector<int> & indices)
+{
+	// vertices in the order the triangles first use them, unreferenced ones are dropped
+	std::vector<int> remap(vertices.size(), -1);
+	std::vector<Vertex> fetched;
+	fetched.reserve(vertices.size());
+	for(int i = 0; i < indices.size(); i++)
+	{
+		int & v = indices[i];
+		if(remap[v] == -1)
+		{
+			remap[v] = fetched.size();
+			fetched.push_back(vertices[v]);
+		}
+		v = remap[v];
+	}
+	fetched.shrink_to_fit();
+	vertices.swap(fetched);
+}
+
+bool MeshOptimizer::load(const std::string & path, unsigned int checksum, std::vector<Vertex> & vertices, std::vector<int> & indices, MeshOptStats & stats)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		return false;
+	unsigned long long file_size = file.tellg();
+	file.seekg(0, file.beg);
+
+	MeshCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(MeshCacheHeader));
+	if(!file || header.magic != MESH_CACHE_MAGIC || header.checksum != checksum || header.cache_size != VERTEX_CACHE_SIZE)
+		return false;
+
+	// a truncated or foreign file must not size the buffers, the caller rebuilds instead
+	unsigned long long payload = static_cast<unsigned long long>(header.nb_vertices) * sizeof(Vertex) + static_cast<unsigned long long>(header.nb_indices) * sizeof(int);
+	if(payload != file_size - sizeof(MeshCacheHeader))
+		return false;
+
+	Vertex zero(glm::vec3(0.0f), glm::vec3(0.0f), glm::vec2(0.0f), glm::vec2(0.0f), glm::vec2(0.0f));
+	std::vector<Vertex> cached_vertices(header.nb_vertices, zero);
+	std::vector<int> cached_indices(header.nb_indices);
+	file.read(reinterpret_cast<char*>(cached_vertices.data()), header.nb_vertices * sizeof(Vertex));
+	file.read(reinterpret_cast<char*>(cached_indices.data()), header.nb_indices * sizeof(int));
+	if(!file)
+		return false;
+	for(int i = 0; i < cached_indices.size(); i++)
+	{
+		if(cached_indices[i] < 0 || cached_indices[i] >= header.nb_vertices)
+			return false;
+	}
+
+	vertices.swap(cached_vertices);
+	indices.swap(cached_indices);
+	stats = header.stats;
+	return true;
+}
+
+void MeshOptimizer::save(const std::string & path, unsigned int checksum, const std::vector<Vertex> & vertices, const std::vector<int> & indices, const MeshOptStats & stats)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		std::cerr << "Error: failed writing mesh cache " << path << std::endl;
+		return;
+	}
+
+	MeshCacheHeader header;
+	header.magic = MESH_CACHE_MAGIC;
+	header.checksum = checksum;
+	header.cache_size = VERTEX_CACHE_SIZE;
+	header.nb_vertices = vertices.size();
+	header.nb_indices = indices.size();
+	header.stats = stats;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+	file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(Vertex));
+	file.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(int));
+}
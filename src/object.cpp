@@ -10,6 +10,7 @@
 #include "stb_image.hpp"
 
 #include <glm/gtx/string_cast.hpp>
+#include <filesystem>
 
 glm::mat4 assimpMat4_to_glmMat4(aiMatrix4x4& m)
 {
@@ -21,15 +22,6 @@ glm::mat4 assimpMat4_to_glmMat4(aiMatrix4x4& m)
 	return matrix;
 }
 
-glm::mat3 assimpMat3_to_glmMat3(aiMatrix3x3& m)
-{
-	glm::mat3 matrix;
-	matrix[0][0] = m.a1; matrix[1][0] = m.a2; matrix[2][0] = m.a3; 
-	matrix[0][1] = m.b1; matrix[1][1] = m.b2; matrix[2][1] = m.b3; 
-	matrix[0][2] = m.c1; matrix[1][2] = m.c2; matrix[2][2] = m.c3; 
-	return matrix;
-}
-
 Object::Object(const std::string& obj_path, bool drawable, bool p_lap, bool p_dynamic)
 {
 	skeleton = nullptr;
@@ -38,6 +30,10 @@ Object::Object(const std::string& obj_path, bool drawable, bool p_lap, bool p_dy
 
 Object::~Object()
 {
+	for(int i = 0; i < mesh_collection.size(); i++)
+	{
+		delete mesh_collection.at(i);
+	}
 	delete skeleton;
 	int nb_animations = animations.size();
 	for(int i = 0; i < nb_animations; i++)
@@ -51,7 +47,7 @@ Joint* Object::get_skeleton()
 	return skeleton;
 }
 
-void Object::draw(Shader& shader, DRAWING_MODE mode)
+void Object::draw(Shader& shader, DRAWING_MODE mode, int lod)
 {
 	int mesh_count = mesh_collection.size();
 
@@ -59,21 +55,38 @@ void Object::draw(Shader& shader, DRAWING_MODE mode)
 	{
         if(mesh_collection.at(i)->is_drawable())
         {
-		    mesh_collection.at(i)->draw(shader, mode);
+		    mesh_collection.at(i)->draw(shader, mode, lod);
         }
 	}
 }
 
-void Object::draw(Shader& shader, Animation* anim, int frame)
+void Object::draw_instanced(Shader& shader, int nb_instances, int lod)
 {
-	int mesh_count = mesh_collection.size();
+	for(int i = 0; i < mesh_collection.size(); i++)
+	{
+		if(mesh_collection.at(i)->is_drawable())
+			mesh_collection.at(i)->draw_instanced(shader, nb_instances, lod);
+	}
+}
+
+void Object::draw_pose(Shader& shader)
+{
+	// the pose was evaluated with every other animated object (Game::update_poses), send the whole palette in one upload
+	pose.upload();
+	shader.bind_uniform_block("JointPalette", JOINT_PALETTE_BINDING);
 
+	int mesh_count = mesh_collection.size();
 	for(int i = 0; i < mesh_count; i++)
 	{
-		mesh_collection.at(i)->draw(shader, joints_ptr_list, anim, frame, skeleton);
+		mesh_collection.at(i)->draw_skinned(shader);
 	}
 }
 
+Pose& Object::get_pose()
+{
+	return pose;
+}
+
 std::vector<Animation*> Object::get_animations()
 {
 	return animations;
@@ -84,11 +97,127 @@ std::map<std::string, Joint*> Object::get_joints_ptr_list()
 	return joints_ptr_list;
 }
 
-std::vector<Mesh*> Object::get_mesh_collection()
+std::vector<Mesh*> const & Object::get_mesh_collection() const
 {
     return mesh_collection;
 }
 
+void Object::release_geometry()
+{
+	for(int i = 0; i < mesh_collection.size(); i++)
+	{
+		mesh_collection.at(i)->release_geometry();
+	}
+}
+
+void Object::memory_usage(size_t & cpu, size_t & gpu) const
+{
+	for(int i = 0; i < mesh_collection.size(); i++)
+	{
+		cpu += mesh_collection.at(i)->get_cpu_bytes();
+		gpu += mesh_collection.at(i)->get_gpu_bytes();
+	}
+
+	// level 0 size from the driver, plus a third for the mip chain
+	std::vector<GLuint> counted;
+	for(int i = 0; i < mesh_collection.size(); i++)
+	{
+		const std::vector<Texture> & textures = mesh_collection.at(i)->material.textures;
+		for(int j = 0; j < textures.size(); j++)
+		{
+			if(std::find(counted.begin(), counted.end(), textures[j].id) != counted.end())
+				continue;
+			counted.push_back(textures[j].id);
+
+			GLint width = 0;
+			GLint height = 0;
+			glBindTexture(GL_TEXTURE_2D, textures[j].id);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+			gpu += (size_t)width * height * 4 * 4 / 3;
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool Object::match_instance(const Object & copy, glm::mat4 & offset) const
+{
+	// a copy has the same meshes, topology, uvs and materials, all moved by one transform (needs the cpu geometry)
+	if(copy.mesh_collection.size() != mesh_collection.size() || mesh_collection.empty())
+		return false;
+
+	const std::vector<Vertex> & a = mesh_collection.at(0)->vertices;
+	const std::vector<Vertex> & b = copy.mesh_collection.at(0)->vertices;
+	if(a.size() < 3 || a.size() != b.size())
+		return false;
+
+	// the transform from three spread out vertices of the first mesh, plus their normal
+	float tolerance = INSTANCE_MATCH_EPSILON * std::max(mesh_collection.at(0)->bounds_radius, 1.0f);
+	int ref[3] = {0, 0, 0};
+	float best = 0.0f;
+	for(int i = 0; i < a.size(); i++)
+	{
+		float d = glm::distance(a[i].position, a[0].position);
+		if(d > best)
+		{
+			best = d;
+			ref[1] = i;
+		}
+	}
+	if(best <= tolerance)
+		return false;
+
+	glm::vec3 axis = glm::normalize(a[ref[1]].position - a[0].position);
+	best = 0.0f;
+	for(int i = 0; i < a.size(); i++)
+	{
+		float d = glm::length(glm::cross(a[i].position - a[0].position, axis));
+		if(d > best)
+		{
+			best = d;
+			ref[2] = i;
+		}
+	}
+	if(best <= tolerance)
+		return false;
+
+	glm::vec3 pa[3] = {a[ref[0]].position, a[ref[1]].position, a[ref[2]].position};
+	glm::vec3 pb[3] = {b[ref[0]].position, b[ref[1]].position, b[ref[2]].position};
+	float scale = glm::distance(pb[1], pb[0]) / glm::distance(pa[1], pa[0]);
+	glm::vec3 na = glm::normalize(glm::cross(pa[1] - pa[0], pa[2] - pa[0]));
+	glm::vec3 nb = glm::normalize(glm::cross(pb[1] - pb[0], pb[2] - pb[0])) * scale;
+	glm::mat4 from(glm::vec4(pa[0], 1.0f), glm::vec4(pa[1], 1.0f), glm::vec4(pa[2], 1.0f), glm::vec4(pa[0] + na, 1.0f));
+	glm::mat4 to(glm::vec4(pb[0], 1.0f), glm::vec4(pb[1], 1.0f), glm::vec4(pb[2], 1.0f), glm::vec4(pb[0] + nb, 1.0f));
+	offset = to * glm::inverse(from);
+
+	// a mirrored copy would be drawn with the wrong winding
+	if(glm::determinant(glm::mat3(offset)) <= 0.0f)
+		return false;
+
+	for(int m = 0; m < mesh_collection.size(); m++)
+	{
+		const Mesh & ma = *mesh_collection.at(m);
+		const Mesh & mb = *copy.mesh_collection.at(m);
+		if(ma.dynamic_draw || mb.dynamic_draw || ma.vertices.size() != mb.vertices.size() || ma.indices != mb.indices)
+			return false;
+		if(ma.material.base_color != mb.material.base_color || ma.material.shininess != mb.material.shininess || ma.material.textures.size() != mb.material.textures.size())
+			return false;
+		for(int t = 0; t < ma.material.textures.size(); t++)
+		{
+			if(get_texture_path(ma.material.textures[t].id) != copy.get_texture_path(mb.material.textures[t].id))
+				return false;
+		}
+		for(int v = 0; v < ma.vertices.size(); v++)
+		{
+			glm::vec3 moved = glm::vec3(offset * glm::vec4(ma.vertices[v].position, 1.0f));
+			if(glm::distance(moved, mb.vertices[v].position) > tolerance || glm::distance(ma.vertices[v].texCoords, mb.vertices[v].texCoords) > INSTANCE_MATCH_EPSILON)
+				return false;
+		}
+	}
+
+	return true;
+}
+
 std::vector<glm::vec3> Object::get_left_sources() const {return sources_left;}
 
 std::vector<glm::vec3> Object::get_right_sources() const {return sources_right;}
@@ -127,10 +256,13 @@ void Object::load(const std::string& file, bool drawable, bool p_lap, bool p_dyn
 	// calculate loading time
 	double load_start = omp_get_wtime();
 	double load_end;
+	cache_name = std::filesystem::path(file).stem().string();
+	opt_stats = MeshOptStats{0, 0, 0, 0, 0, 0};
 
 	if(scene->HasAnimations())
 	{
 		create_joint_hierarchy(scene);
+		flatten_joint_hierarchy();
 		std::cout << "##### JOINT HIERARCHY CREATED ! #####" << std::endl;
 		std::cout << skeleton->get_name() << std::endl;
 		skeleton->print_hierarchy(skeleton, 4);
@@ -140,52 +272,21 @@ void Object::load(const std::string& file, bool drawable, bool p_lap, bool p_dyn
 		// for each animation
 		for(int j = 0; j < nb_animations; j++)
 		{
-			std::string anim_name(anims[j]->mName.C_Str());
-			std::cout << "	- LOADING ANIMATION: " << anim_name << std::endl;
-			//double anim_duration = anims[j]->mDuration;
-			double anim_duration = anims[j]->mChannels[0]->mNumPositionKeys;
-			std::cout << "	anim_duration = " << anim_duration << std::endl;
-			Animation* currentAnimation = new Animation(anim_name, anim_duration);
-			
-			// create keyframes for the current animation for each joint
-			for(int k = 0; k < anim_duration; k++)
-			{
-				Keyframe* kFrame = new Keyframe(k);
-				int joints_involved_count = anims[j]->mNumChannels;
-
-				for(int i = 0; i < joints_involved_count; i++)
-				{
-					aiNodeAnim* animJoint = anims[j]->mChannels[i];
-					if(std::strcmp(animJoint->mNodeName.C_Str(), "Armature") == 0)
-						continue;
-					int posKeysCount = animJoint->mNumPositionKeys;
-					std::vector<double> keyFrameTime;
-					for(int i = 0; i < posKeysCount; i++)
-					{
-						keyFrameTime.push_back(animJoint->mPositionKeys[i].mTime);
-					}
-					std::string joint_name(animJoint->mNodeName.C_Str());
-					Joint* animJointSame = joints_ptr_list[joint_name];
-					std::vector<aiNodeAnim*> parentAnimJoint_list = get_parent_joints_list(animJointSame, anims[j]);
-					
-					// now chain compute pose Matrix
-					glm::mat4 poseMatrix = glm::mat4(1.0f);
-					poseMatrix = chainComputePoseMatrix(poseMatrix, parentAnimJoint_list, k, animJoint, keyFrameTime);
-
-					// create JointPose and add it to the current keyframe
-					JointPose* jPose = new JointPose(joint_name, poseMatrix);
-					kFrame->add_joint_pose(jPose);
-				}
-				currentAnimation->add_keyframe(kFrame);
-			}
-			
-			// add current animation to the animations collection
-			animations.push_back(currentAnimation);
+			std::cout << "	- LOADING ANIMATION: " << anims[j]->mName.C_Str() << std::endl;
+			animations.push_back(create_animation(anims[j]));
 		}
 	}
 	
 	std::cout << std::endl;
 	explore_node(scene->mRootNode, scene, drawable, p_lap, p_dynamic);
+
+	// vertex cache efficiency of the whole file, before and after the import reordering
+	if(opt_stats.triangles_after > 0)
+	{
+		std::cout << "MESH OPTIMIZATION: ACMR " << static_cast<float>(opt_stats.misses_before) / opt_stats.triangles_before << " -> " << static_cast<float>(opt_stats.misses_after) / opt_stats.triangles_after
+			<< ", ATVR " << static_cast<float>(opt_stats.misses_before) / opt_stats.vertices_before << " -> " << static_cast<float>(opt_stats.misses_after) / opt_stats.vertices_after
+			<< ", " << opt_stats.vertices_before << " -> " << opt_stats.vertices_after << " vertices" << std::endl;
+	}
 	
 	// loading time
 	load_end = omp_get_wtime();
@@ -219,6 +320,7 @@ Mesh* Object::get_mesh(aiMesh* mesh, const aiScene* scene, bool drawable, bool p
 	
 	int nb_vertices = mesh->mNumVertices;
 	std::vector<Vertex> vertices;
+	vertices.reserve(nb_vertices);
 	glm::vec3 v_pos;
 	glm::vec3 v_norm;
 	glm::vec2 v_tex_coords;
@@ -314,10 +416,11 @@ Mesh* Object::get_mesh(aiMesh* mesh, const aiScene* scene, bool drawable, bool p
 	int nb_faces = mesh->mNumFaces;
 	int nb_indices_face = 0;
 	std::vector<int> indices;
+	indices.reserve(nb_faces * 3);
 
 	for(int i = 0; i < nb_faces; i++)
 	{
-		aiFace face = mesh->mFaces[i];
+		const aiFace & face = mesh->mFaces[i];
 		nb_indices_face = face.mNumIndices;
 
 		for(int j = 0; j < nb_indices_face; j++)
@@ -350,9 +453,10 @@ Mesh* Object::get_mesh(aiMesh* mesh, const aiScene* scene, bool drawable, bool p
 		{
 			GLuint tex_id = create_texture(tex_path);
 
-			Texture tex(tex_id, TextureType::DIFFUSE_TEXTURE, tex_path);
+			Texture tex(tex_id, TextureType::DIFFUSE_TEXTURE);
 			mesh_tex_set.push_back(tex);
 			texture_collection.push_back(tex);
+			texture_paths.push_back(tex_path);
 		}
 		else
 		{
@@ -375,7 +479,7 @@ Mesh* Object::get_mesh(aiMesh* mesh, const aiScene* scene, bool drawable, bool p
 		{
 			GLuint tex_id = create_texture(tex_path);
 		
-			Texture tex(tex_id, TextureType::SPECULAR_TEXTURE, tex_path);
+			Texture tex(tex_id, TextureType::SPECULAR_TEXTURE);
 			mesh_tex_set.push_back(tex);
 		}
 		else
@@ -388,21 +492,71 @@ Mesh* Object::get_mesh(aiMesh* mesh, const aiScene* scene, bool drawable, bool p
 	mesh_material->Get(AI_MATKEY_SHININESS, mesh_shininess);
 
 	Material m;
-	m.textures = mesh_tex_set;
+	m.textures = std::move(mesh_tex_set);
     m.base_color = glm::vec3(base_color.r, base_color.g, base_color.b);
 	m.shininess = mesh_shininess / 8.0f;
 
+	// cache friendly order and lods, dynamic meshes are rewritten every frame
+	LodChain lods;
+	if(!p_dynamic)
+		optimize_mesh(vertices, indices);
+	if(!p_dynamic && indices.size() / 3 >= LOD_MIN_TRIANGLES)
+		load_lods(vertices, indices, lods);
+
 	// pack everything
-    Mesh * retrieved_mesh;
-    if(p_lap)
-	    retrieved_mesh = new Mesh(vertices, indices, m, mesh_name, drawable, p_dynamic, p_lap);
-    else
-	    retrieved_mesh = new Mesh(vertices, indices, m, mesh_name, drawable, p_dynamic);
+    Mesh * retrieved_mesh = new Mesh(std::move(vertices), std::move(indices), std::move(m), mesh_name, drawable, p_dynamic, p_lap, std::move(lods));
 
 	// final step
 	return retrieved_mesh;
 }
 
+void Object::optimize_mesh(std::vector<Vertex> & vertices, std::vector<int> & indices)
+{
+	// optimize once, later launches read the reordered geometry back (meshes are named by their rank in the file)
+	MeshOptimizer optimizer;
+	MeshOptStats stats;
+	unsigned int checksum = LodBuilder::checksum(vertices, indices);
+	std::string cache_path = std::string(MESH_CACHE_DIR) + cache_name + "_" + std::to_string(mesh_collection.size()) + ".mesh";
+	if(!optimizer.load(cache_path, checksum, vertices, indices, stats))
+	{
+		optimizer.optimize(vertices, indices, stats);
+
+		std::error_code ec;
+		std::filesystem::create_directories(MESH_CACHE_DIR, ec);
+		optimizer.save(cache_path, checksum, vertices, indices, stats);
+	}
+
+	opt_stats.triangles_before += stats.triangles_before;
+	opt_stats.triangles_after += stats.triangles_after;
+	opt_stats.vertices_before += stats.vertices_before;
+	opt_stats.vertices_after += stats.vertices_after;
+	opt_stats.misses_before += stats.misses_before;
+	opt_stats.misses_after += stats.misses_after;
+}
+
+void Object::load_lods(const std::vector<Vertex> & vertices, const std::vector<int> & indices, LodChain & lods)
+{
+	// simplify once, later launches read the chain back (meshes are named by their rank in the file)
+	LodBuilder builder;
+	unsigned int checksum = LodBuilder::checksum(vertices, indices);
+	std::string cache_path = std::string(LOD_CACHE_DIR) + cache_name + "_" + std::to_string(mesh_collection.size()) + ".lod";
+	if(!builder.load(cache_path, checksum, vertices.size(), indices.size(), lods))
+	{
+		builder.build(vertices, indices, lods);
+
+		// the collapses leave holes in the cache order
+		MeshOptimizer optimizer;
+		for(int i = 0; i < lods.indices.size(); i++)
+		{
+			optimizer.optimize_vertex_cache(lods.indices[i], vertices.size());
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(LOD_CACHE_DIR, ec);
+		builder.save(cache_path, checksum, lods);
+	}
+}
+
 GLuint Object::create_texture(std::string tex_path, bool flip)
 {
 	int width, height, channels;
@@ -450,16 +604,27 @@ GLuint Object::create_texture(std::string tex_path, bool flip)
 
 int Object::texture_already_loaded(std::string texture_path)
 {
-	int tex_count = texture_collection.size();
+	int tex_count = texture_paths.size();
 
 	for(int i = 0; i < tex_count; i++)
 	{
-		if(texture_collection.at(i).texture_file_path == texture_path)
+		if(texture_paths.at(i) == texture_path)
 			return i;
 	}
 	return -1;
 }
 
+std::string Object::get_texture_path(GLuint tex_id) const
+{
+	// only diffuse textures are recorded
+	for(int i = 0; i < texture_collection.size(); i++)
+	{
+		if(texture_collection.at(i).id == tex_id)
+			return texture_paths.at(i);
+	}
+	return std::string();
+}
+
 void Object::create_joint_hierarchy(const aiScene* scene)
 {
 	// find the Armature node
@@ -516,119 +681,78 @@ void Object::create_joint_hierarchy_aux(aiNode* bone, Joint* j, int& id)
 	}
 }
 
-std::vector<aiNodeAnim*> Object::get_parent_joints_list(Joint* j, aiAnimation* currAnim)
+void Object::flatten_joint_hierarchy()
 {
-	std::vector<aiNodeAnim*> parent_joints_list;
-	while(j->get_parent() != nullptr)
+	// ids are given depth first from 1, so a parent always comes before its children
+	int nb_joints = joints_ptr_list.size();
+	std::vector<int> parents(nb_joints, -1);
+	std::vector<glm::mat4> offsets(nb_joints, glm::mat4(1.0f));
+
+	for(auto it = joints_ptr_list.begin(); it != joints_ptr_list.end(); it++)
 	{
-		int nodeAnimCount = currAnim->mNumChannels;
-		aiNodeAnim* nodeAnim;
-		for(int i = 0; i < nodeAnimCount; i++)
-		{
-			if(std::strcmp(currAnim->mChannels[i]->mNodeName.C_Str(), j->get_parent()->get_name().c_str()) == 0)
-			{
-				nodeAnim = currAnim->mChannels[i];
-				parent_joints_list.push_back(nodeAnim);
-				j = j->get_parent();
-				break;
-			}
-		}
+		Joint* j = it->second;
+		int index = j->get_id() - 1;
+		if(j->get_parent() != nullptr)
+			parents[index] = j->get_parent()->get_id() - 1;
+		offsets[index] = j->get_transform();
 	}
-	return parent_joints_list;
+
+	pose.set_skeleton(parents, offsets);
 }
 
-glm::mat4 Object::chainComputePoseMatrix(glm::mat4 matrix, std::vector<aiNodeAnim*> parentAnimJointList, int frame, aiNodeAnim* animJoint, std::vector<double> kFrameTime)
+Animation* Object::create_animation(aiAnimation* anim)
 {
-	int parent_count = parentAnimJointList.size();
-	aiNodeAnim* currentParent;
-	
-	if(parent_count == 0)
-	{
-		// if current animJoint contains the frame
-		//if(std::find(kFrameTime.begin(), kFrameTime.end(), frame) != kFrameTime.end())
-		//{
-			matrix = get_joint_poseMatrix_atFrame(animJoint, frame, matrix);
-		//}
-		/*else // else take last frame pos, rot, scale data into poseMatrix
-		{
-			int lastFrame = frame;
-			while(lastFrame >= 0 && std::find(kFrameTime.begin(), kFrameTime.end(), lastFrame) == kFrameTime.end())
-			{
-				lastFrame--;
-			}
-			matrix = get_joint_poseMatrix_atFrame(animJoint, lastFrame, matrix);
-		}*/
-	}
-	else
+	// assimp leaves the tick rate at 0 when the file doesn't say, 25 is its usual default
+	double ticks_per_second = (anim->mTicksPerSecond != 0.0) ? anim->mTicksPerSecond : 25.0;
+	Animation* animation = new Animation(anim->mName.C_Str(), anim->mDuration, ticks_per_second);
+	int channel_count = anim->mNumChannels;
+
+	for(int i = 0; i < channel_count; i++)
 	{
-		// if current animJoint contains the frame
-		//if(std::find(kFrameTime.begin(), kFrameTime.end(), frame) != kFrameTime.end())
-		//{
-			matrix = get_joint_poseMatrix_atFrame(animJoint, frame, matrix);
-		//}
-		/*else // else take last frame pos, rot, scale data into poseMatrix
+		aiNodeAnim* channel = anim->mChannels[i];
+		auto joint = joints_ptr_list.find(channel->mNodeName.C_Str());
+		if(joint == joints_ptr_list.end())
+			continue;
+
+		// position keys drive the track, rotation and scale are taken at the same time
+		int key_count = channel->mNumPositionKeys;
+		std::vector<float> key_times(key_count);
+		std::vector<glm::vec3> key_translations(key_count);
+		std::vector<glm::quat> key_rotations(key_count);
+		std::vector<glm::vec3> key_scales(key_count);
+
+		int r = 0;
+		int s = 0;
+		for(int k = 0; k < key_count; k++)
 		{
-			int lastFrame = frame;
-			while(lastFrame >= 0 && std::find(kFrameTime.begin(), kFrameTime.end(), lastFrame) == kFrameTime.end())
+			double time = channel->mPositionKeys[k].mTime;
+			while(r + 1 < static_cast<int>(channel->mNumRotationKeys) && channel->mRotationKeys[r + 1].mTime <= time)
+				r++;
+			while(s + 1 < static_cast<int>(channel->mNumScalingKeys) && channel->mScalingKeys[s + 1].mTime <= time)
+				s++;
+
+			aiVector3D position = channel->mPositionKeys[k].mValue;
+			key_times[k] = static_cast<float>(time);
+			key_translations[k] = glm::vec3(position.x, position.y, position.z);
+
+			if(channel->mNumRotationKeys > 0)
 			{
-				lastFrame--;
+				aiQuaternion rotation = channel->mRotationKeys[r].mValue;
+				key_rotations[k] = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
 			}
-			matrix = get_joint_poseMatrix_atFrame(animJoint, lastFrame, matrix);
-		}*/
-		for(int p = 0; p < parent_count; p++)
-		{
-			currentParent = parentAnimJointList.at(p);
-			int posKeysParentCount = currentParent->mNumPositionKeys;
-			std::vector<double> keyFrameTimeParent;
-			for(int i = 0; i < posKeysParentCount; i++)
+			if(channel->mNumScalingKeys > 0)
 			{
-				keyFrameTimeParent.push_back(currentParent->mPositionKeys[i].mTime);
+				aiVector3D scale = channel->mScalingKeys[s].mValue;
+				key_scales[k] = glm::vec3(scale.x, scale.y, scale.z);
 			}
-
-			// if current parent animJoint contains the frame
-			//if(std::find(keyFrameTimeParent.begin(), keyFrameTimeParent.end(), frame) != keyFrameTimeParent.end())
-			//{
-				matrix = get_joint_poseMatrix_atFrame(currentParent, frame, matrix);
-			//}
-			/*else // else take last frame pos, rot, scale data into poseMatrix
-			{
-				int lastFrame = frame;
-				while(lastFrame >= 0 && std::find(keyFrameTimeParent.begin(), keyFrameTimeParent.end(), lastFrame) == keyFrameTimeParent.end())
-				{
-					lastFrame--;
-				}
-				matrix = get_joint_poseMatrix_atFrame(currentParent, lastFrame, matrix);
-			}*/
+			else
+				key_scales[k] = glm::vec3(1.0f);
 		}
-		
-	}
-
-	return matrix;
-}
 
-glm::mat4 Object::get_joint_poseMatrix_atFrame(aiNodeAnim* joint, int frame, glm::mat4 matrix)
-{
-	// translation matrix
-	aiVector3D posData = joint->mPositionKeys[frame].mValue;
-	glm::vec3 posKey(posData.x, posData.y, posData.z);
-	glm::mat4 translate(1.0f);
-	translate = glm::translate(translate, posKey);
-
-	// rotation matrix
-	aiQuaternion rotData = joint->mRotationKeys[frame].mValue;
-	aiMatrix3x3 assimpRotMatrix = rotData.GetMatrix();
-	glm::mat3 tmpRot = assimpMat3_to_glmMat3(assimpRotMatrix);
-	glm::mat4 rotation(tmpRot);
-	
-	// scale matrix
-	aiVector3D scaleData = joint->mScalingKeys[frame].mValue;
-	glm::vec3 scaleKey(scaleData.x, scaleData.y, scaleData.z);
-	glm::mat4 scale(1.0f);
-	scale = glm::scale(scale, scaleKey);
+		animation->add_track(joint->second->get_id() - 1, key_times, key_translations, key_rotations, key_scales);
+	}
 
-	// final step
-	matrix = translate * rotation * scale * matrix;
-	return matrix;
+	return animation;
 }
 
 void Object::reset_drawable()
@@ -0,0 +1,379 @@
+/**
+ * \file
+ * What the eye doesn't see, the GPU doesn't draw
+ * \author Mathias Velo
+ */
+
+#include "occlusion.hpp"
+
+struct GpuBounds
+{
+	glm::vec4 min_corner;
+	glm::vec4 max_corner;
+};
+
+OcclusionCuller::OcclusionCuller() :
+	mode(OCCLUSION_GPU),
+	print_stats(false),
+	ready(false),
+	view_proj(1.0f),
+	hiz_texture(0),
+	hiz_width(0),
+	hiz_height(0),
+	hiz_levels(0),
+	depth_width(0),
+	depth_height(0),
+	bounds_SSBO(0),
+	stats_pending(false),
+	totals{0, 0, 0, 0},
+	nb_frames(0)
+{
+	hiz_shader = new Shader("../shaders/occlusion/hiz.glsl");
+	cull_shader = new Shader("../shaders/occlusion/cull.glsl");
+
+	OcclusionStats zero{0, 0, 0, 0};
+	glGenBuffers(1, &stats_SSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, stats_SSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(OcclusionStats), &zero, GL_DYNAMIC_READ);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	int nb_levels = 1;
+	while((OCCLUSION_CPU_WIDTH >> nb_levels) > 0 || (OCCLUSION_CPU_HEIGHT >> nb_levels) > 0)
+		nb_levels++;
+	cpu_levels.resize(nb_levels);
+	for(int i = 0; i < nb_levels; i++)
+	{
+		int w = std::max(OCCLUSION_CPU_WIDTH >> i, 1);
+		int h = std::max(OCCLUSION_CPU_HEIGHT >> i, 1);
+		cpu_levels[i].assign(w * h, 1.0f);
+	}
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+	delete(hiz_shader);
+	delete(cull_shader);
+	glDeleteTextures(1, &hiz_texture);
+	glDeleteBuffers(1, &bounds_SSBO);
+	glDeleteBuffers(1, &stats_SSBO);
+}
+
+void OcclusionCuller::set_mode(OCCLUSION_MODE p_mode, bool p_print_stats)
+{
+	mode = p_mode;
+	print_stats = p_print_stats;
+	ready = false;
+}
+
+OCCLUSION_MODE OcclusionCuller::get_mode() const
+{
+	return mode;
+}
+
+void OcclusionCuller::set_bounds(const std::vector<glm::vec3> & min_corners, const std::vector<glm::vec3> & max_corners)
+{
+	bounds_min = min_corners;
+	bounds_max = max_corners;
+
+	std::vector<GpuBounds> bounds(min_corners.size());
+	for(int i = 0; i < bounds.size(); i++)
+	{
+		bounds[i].min_corner = glm::vec4(min_corners[i], 1.0f);
+		bounds[i].max_corner = glm::vec4(max_corners[i], 1.0f);
+	}
+
+	if(bounds_SSBO == 0)
+		glGenBuffers(1, &bounds_SSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bounds_SSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, bounds.size() * sizeof(GpuBounds), bounds.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void OcclusionCuller::add_occluder(const std::vector<glm::vec3> & positions, const std::vector<int> & indices)
+{
+	for(int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		occluders.push_back(positions[indices[i]]);
+		occluders.push_back(positions[indices[i + 1]]);
+		occluders.push_back(positions[indices[i + 2]]);
+	}
+}
+
+void OcclusionCuller::invalidate()
+{
+	ready = false;
+}
+
+void OcclusionCuller::create_hiz(int width, int height)
+{
+	// level 0 is half the depth resolution, down to 1x1
+	glDeleteTextures(1, &hiz_texture);
+	depth_width = width;
+	depth_height = height;
+	hiz_width = std::max(width / 2, 1);
+	hiz_height = std::max(height / 2, 1);
+	hiz_levels = 1;
+	while((hiz_width >> hiz_levels) > 0 || (hiz_height >> hiz_levels) > 0)
+		hiz_levels++;
+
+	glGenTextures(1, &hiz_texture);
+	glBindTexture(GL_TEXTURE_2D, hiz_texture);
+	glTexStorage2D(GL_TEXTURE_2D, hiz_levels, GL_R32F, hiz_width, hiz_height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OcclusionCuller::build_hiz(GLuint depth_texture, int width, int height, glm::mat4 p_view_proj)
+{
+	if(mode != OCCLUSION_GPU)
+		return;
+
+	read_gpu_stats();
+
+	if(width != depth_width || height != depth_height)
+		create_hiz(width, height);
+
+	// each level keeps the farthest depth of the 2x2 (or 3x3 on odd edges) texels below it
+	hiz_shader->use();
+	hiz_shader->set_int("src", 0);
+	glActiveTexture(GL_TEXTURE0);
+	for(int level = 0; level < hiz_levels; level++)
+	{
+		int src_width = (level == 0) ? width : std::max(hiz_width >> (level - 1), 1);
+		int src_height = (level == 0) ? height : std::max(hiz_height >> (level - 1), 1);
+		int dst_width = std::max(hiz_width >> level, 1);
+		int dst_height = std::max(hiz_height >> level, 1);
+
+		glBindTexture(GL_TEXTURE_2D, (level == 0) ? depth_texture : hiz_texture);
+		hiz_shader->set_int("src_level", (level == 0) ? 0 : level - 1);
+		hiz_shader->set_int("src_width", src_width);
+		hiz_shader->set_int("src_height", src_height);
+		glBindImageTexture(0, hiz_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		glDispatchCompute((dst_width + OCCLUSION_HIZ_GROUP_SIZE - 1) / OCCLUSION_HIZ_GROUP_SIZE, (dst_height + OCCLUSION_HIZ_GROUP_SIZE - 1) / OCCLUSION_HIZ_GROUP_SIZE, 1);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	view_proj = p_view_proj;
+	ready = true;
+}
+
+void OcclusionCuller::cull_gpu(GLuint indirect_buffer, int nb_commands)
+{
+	if(mode != OCCLUSION_GPU || !ready || nb_commands == 0)
+		return;
+
+	// the commands are rewritten in place as a storage buffer, the caller has bound their draw SSBO
+	cull_shader->use();
+	cull_shader->set_Matrix("view_proj", view_proj);
+	cull_shader->set_int("nb_commands", nb_commands);
+	cull_shader->set_int("hiz_levels", hiz_levels);
+	cull_shader->set_int("hiz", 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, hiz_texture);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OCCLUSION_COMMAND_BINDING, indirect_buffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OCCLUSION_BOUNDS_BINDING, bounds_SSBO);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OCCLUSION_STATS_BINDING, stats_SSBO);
+	glDispatchCompute((nb_commands + OCCLUSION_GROUP_SIZE - 1) / OCCLUSION_GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	stats_pending = true;
+}
+
+void OcclusionCuller::read_gpu_stats()
+{
+	// one frame late, so the cull pass is long done and the read does not stall
+	if(!stats_pending)
+		return;
+
+	OcclusionStats stats{0, 0, 0, 0};
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, stats_SSBO);
+	if(print_stats)
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(OcclusionStats), &stats);
+	OcclusionStats zero{0, 0, 0, 0};
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(OcclusionStats), &zero);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	totals.drawn_triangles += stats.drawn_triangles;
+	totals.occluded_triangles += stats.occluded_triangles;
+	totals.drawn_meshes += stats.drawn_meshes;
+	totals.occluded_meshes += stats.occluded_meshes;
+	stats_pending = false;
+}
+
+// ####################################################################################################
+// ####################################################################################################
+// ####################################################################################################
+
+void OcclusionCuller::rasterize(glm::mat4 p_view_proj)
+{
+	if(mode != OCCLUSION_CPU)
+		return;
+
+	std::vector<float> & depth = cpu_levels[0];
+	std::fill(depth.begin(), depth.end(), 1.0f);
+
+	for(int t = 0; t + 2 < occluders.size(); t += 3)
+	{
+		// no near plane clipping, an occluder crossing it is dropped (only costs culling efficiency)
+		glm::vec3 s[3];
+		bool clipped = false;
+		for(int j = 0; j < 3; j++)
+		{
+			glm::vec4 clip = p_view_proj * glm::vec4(occluders[t + j], 1.0f);
+			if(clip.w < OCCLUSION_NEAR_W)
+			{
+				clipped = true;
+				break;
+			}
+			glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			s[j] = glm::vec3((ndc.x * 0.5f + 0.5f) * OCCLUSION_CPU_WIDTH, (ndc.y * 0.5f + 0.5f) * OCCLUSION_CPU_HEIGHT, ndc.z * 0.5f + 0.5f);
+		}
+		if(clipped)
+			continue;
+
+		float area = (s[1].x - s[0].x) * (s[2].y - s[0].y) - (s[1].y - s[0].y) * (s[2].x - s[0].x);
+		if(std::fabs(area) < 1e-6f)
+			continue;
+
+		int min_x = std::max(static_cast<int>(std::floor(std::min(s[0].x, std::min(s[1].x, s[2].x)))), 0);
+		int max_x = std::min(static_cast<int>(std::ceil(std::max(s[0].x, std::max(s[1].x, s[2].x)))), OCCLUSION_CPU_WIDTH - 1);
+		int min_y = std::max(static_cast<int>(std::floor(std::min(s[0].y, std::min(s[1].y, s[2].y)))), 0);
+		int max_y = std::min(static_cast<int>(std::ceil(std::max(s[0].y, std::max(s[1].y, s[2].y)))), OCCLUSION_CPU_HEIGHT - 1);
+
+		// pixel centers inside the triangle (either winding), nearest depth wins
+		for(int y = min_y; y <= max_y; y++)
+		{
+			for(int x = min_x; x <= max_x; x++)
+			{
+				float px = x + 0.5f;
+				float py = y + 0.5f;
+				float w0 = ((s[2].x - s[1].x) * (py - s[1].y) - (s[2].y - s[1].y) * (px - s[1].x)) / area;
+				float w1 = ((s[0].x - s[2].x) * (py - s[2].y) - (s[0].y - s[2].y) * (px - s[2].x)) / area;
+				float w2 = 1.0f - w0 - w1;
+				if(w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+					continue;
+
+				float z = w0 * s[0].z + w1 * s[1].z + w2 * s[2].z;
+				float & d = depth[y * OCCLUSION_CPU_WIDTH + x];
+				d = std::min(d, z);
+			}
+		}
+	}
+
+	// max pyramid, odd edges fold the leftover row/column into the last texel
+	for(int level = 1; level < cpu_levels.size(); level++)
+	{
+		int src_width = std::max(OCCLUSION_CPU_WIDTH >> (level - 1), 1);
+		int src_height = std::max(OCCLUSION_CPU_HEIGHT >> (level - 1), 1);
+		int dst_width = std::max(OCCLUSION_CPU_WIDTH >> level, 1);
+		int dst_height = std::max(OCCLUSION_CPU_HEIGHT >> level, 1);
+		for(int y = 0; y < dst_height; y++)
+		{
+			for(int x = 0; x < dst_width; x++)
+			{
+				int x_end = (x == dst_width - 1) ? src_width : x * 2 + 2;
+				int y_end = (y == dst_height - 1) ? src_height : y * 2 + 2;
+				float d = 0.0f;
+				for(int sy = y * 2; sy < y_end; sy++)
+				{
+					for(int sx = x * 2; sx < x_end; sx++)
+					{
+						d = std::max(d, sample_cpu(level - 1, sx, sy));
+					}
+				}
+				cpu_levels[level][y * dst_width + x] = d;
+			}
+		}
+	}
+
+	view_proj = p_view_proj;
+	ready = true;
+}
+
+float OcclusionCuller::sample_cpu(int level, int x, int y) const
+{
+	int width = std::max(OCCLUSION_CPU_WIDTH >> level, 1);
+	int height = std::max(OCCLUSION_CPU_HEIGHT >> level, 1);
+	x = std::clamp(x, 0, width - 1);
+	y = std::clamp(y, 0, height - 1);
+	return cpu_levels[level][y * width + x];
+}
+
+bool OcclusionCuller::test_cpu(glm::vec3 min_corner, glm::vec3 max_corner) const
+{
+	// same test as the cull shader: nearest box depth against the farthest occluder depth under its footprint
+	glm::vec3 ndc_min(1.0f);
+	glm::vec3 ndc_max(-1.0f);
+	for(int c = 0; c < 8; c++)
+	{
+		glm::vec3 corner((c & 1) ? max_corner.x : min_corner.x, (c & 2) ? max_corner.y : min_corner.y, (c & 4) ? max_corner.z : min_corner.z);
+		glm::vec4 clip = view_proj * glm::vec4(corner, 1.0f);
+		if(clip.w < OCCLUSION_NEAR_W)
+			return true;
+		glm::vec3 ndc = glm::vec3(clip) / clip.w;
+		ndc_min = glm::min(ndc_min, ndc);
+		ndc_max = glm::max(ndc_max, ndc);
+	}
+
+	glm::vec2 uv_min = glm::clamp(glm::vec2(ndc_min) * 0.5f + 0.5f, 0.0f, 1.0f);
+	glm::vec2 uv_max = glm::clamp(glm::vec2(ndc_max) * 0.5f + 0.5f, 0.0f, 1.0f);
+	float box_depth = ndc_min.z * 0.5f + 0.5f;
+
+	glm::vec2 size = (uv_max - uv_min) * glm::vec2(OCCLUSION_CPU_WIDTH, OCCLUSION_CPU_HEIGHT);
+	int level = static_cast<int>(std::ceil(std::log2(std::max(std::max(size.x, size.y), 1.0f))));
+	level = std::clamp(level, 0, static_cast<int>(cpu_levels.size()) - 1);
+
+	int width = std::max(OCCLUSION_CPU_WIDTH >> level, 1);
+	int height = std::max(OCCLUSION_CPU_HEIGHT >> level, 1);
+	int x0 = static_cast<int>(uv_min.x * width);
+	int x1 = static_cast<int>(uv_max.x * width);
+	int y0 = static_cast<int>(uv_min.y * height);
+	int y1 = static_cast<int>(uv_max.y * height);
+	float occluder_depth = std::max(std::max(sample_cpu(level, x0, y0), sample_cpu(level, x1, y0)), std::max(sample_cpu(level, x0, y1), sample_cpu(level, x1, y1)));
+
+	return box_depth <= occluder_depth;
+}
+
+void OcclusionCuller::cull_cpu(const std::vector<int> & mesh_ids, const std::vector<GLuint> & index_counts, std::vector<bool> & visible)
+{
+	visible.assign(mesh_ids.size(), true);
+	if(mode != OCCLUSION_CPU || !ready)
+		return;
+
+	for(int i = 0; i < mesh_ids.size(); i++)
+	{
+		visible[i] = test_cpu(bounds_min[mesh_ids[i]], bounds_max[mesh_ids[i]]);
+		if(visible[i])
+		{
+			totals.drawn_triangles += index_counts[i] / 3;
+			totals.drawn_meshes++;
+		}
+		else
+		{
+			totals.occluded_triangles += index_counts[i] / 3;
+			totals.occluded_meshes++;
+		}
+	}
+}
+
+void OcclusionCuller::report()
+{
+	nb_frames++;
+	if(!print_stats || nb_frames < OCCLUSION_STATS_FRAMES)
+		return;
+
+	// averages per frame over the last OCCLUSION_STATS_FRAMES frames
+	double total = static_cast<double>(totals.drawn_triangles) + totals.occluded_triangles;
+	std::cout << "OCCLUSION (" << (mode == OCCLUSION_GPU ? "gpu" : (mode == OCCLUSION_CPU ? "cpu" : "off")) << "): "
+		<< totals.drawn_meshes / nb_frames << " meshes / " << totals.drawn_triangles / nb_frames << " triangles drawn, "
+		<< totals.occluded_meshes / nb_frames << " meshes / " << totals.occluded_triangles / nb_frames << " triangles occluded ("
+		<< (total > 0.0 ? 100.0 * totals.occluded_triangles / total : 0.0) << " %)" << std::endl;
+
+	totals = OcclusionStats{0, 0, 0, 0};
+	nb_frames = 0;
+}
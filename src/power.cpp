@@ -10,10 +10,7 @@ Power::Power(std::vector<glm::vec3> co_left, std::vector<glm::vec3> co_right) :
 	jitter1(0.0625f),
 	jitter2(0.125f),
 	thickness(0.05f),
-	rng(std::chrono::steady_clock::now().time_since_epoch().count()),
-	dis1(0.01f, 0.99f),
-	dis2(-jitter1, jitter1),
-	dis3(-jitter2, jitter2)
+	seed(0)
 {
     // connector_left bounding box
     float left_x_min = 0.0f;
@@ -90,152 +87,43 @@ Power::Power(std::vector<glm::vec3> co_left, std::vector<glm::vec3> co_right) :
     // center right connector
     glm::vec3 center_right_co = glm::vec3(right_x_max, (right_y_max + right_y_min) / 2.0f, (right_z_max + right_z_min) / 2.0f);
 	
-    start = new BoltNode(center_left_co, glm::vec2(0.0f, 0.0f));
-	end = new BoltNode(center_right_co, glm::vec2(1.0f, 0.0f));
+	start = center_left_co;
+	end = center_right_co;
 
-	// VAO
+	// VAO, the two connector endpoints, bolts are expanded by the geometry shader
+	glm::vec3 endpoints[2] = {start, end};
 	glGenVertexArrays(1, &VAO);
 	glBindVertexArray(VAO);
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, MAX_BOLT_NODES * sizeof(BoltNode), nullptr, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(BoltNode), (void*)0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BoltNode), (void*)(offsetof(BoltNode, texCoords)));
+	glBufferData(GL_ARRAY_BUFFER, 2 * sizeof(glm::vec3), endpoints, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
 	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
 
 	// Unbind VAO
 	glBindVertexArray(0);
 }
 
-int cmp(const void* a, const void* b)
+Power::~Power()
 {
-	float arg1 = *static_cast<const float*>(a);
-	float arg2 = *static_cast<const float*>(b);
-	if(arg1 < arg2)
-		return -1;
-	else if(arg1 > arg2)
-		return 1;
-	else
-		return 0;
+	glDeleteBuffers(1, &VBO);
+	glDeleteVertexArrays(1, &VAO);
 }
 
-float Power::get_random(int choice)
+void Power::update(double delta)
 {
-	if(choice == 1)
-		return dis1(rng);
-	else if(choice == 2)
-		return dis2(rng);
-	else if(choice == 3)
-		return dis3(rng);
+	// new bolts every frame
+	seed++;
 }
 
-void Power::create_bolt(int jitter)
+void Power::render(Shader* power_shader)
 {
-	#pragma omp for
-	offset_x.clear();
-	for(int i = 0; i < 12 - 2; i++)
-	{
-		offset_x.push_back(get_random(1));
-	}
-	std::qsort(offset_x.data(), offset_x.size(), sizeof(float), cmp);
-	float diff_x = end->position.x - start->position.x;
+	power_shader->set_int("seed", seed);
+	power_shader->set_float("thickness", thickness);
+	power_shader->set_float("jitter1", jitter1);
+	power_shader->set_float("jitter2", jitter2);
 
-	// create set of triangles	
-	float randY, randZ;
-	randY = get_random(jitter);
-	randZ = get_random(jitter);
-	
-	BoltNode zero(start->position, start->texCoords);
-	
-	BoltNode first(
-			zero.position + glm::vec3(offset_x.at(0) * diff_x, randY, randZ),
-			glm::vec2(0.0f, 0.0f)
-			);
-	
-	BoltNode second(
-			zero.position + glm::vec3(0.0f, thickness, 0.0f),
-			glm::vec2(0.0f, 1.0f)
-			);
-	
-	BoltNode third(
-			first.position + glm::vec3(0.0f, thickness, 0.0f),
-			glm::vec2(0.0f, 1.0f)
-			);
-
-	bolt.clear();
-	bolt.push_back(zero);
-	bolt.push_back(first);
-	bolt.push_back(second);
-	bolt.push_back(second);
-	bolt.push_back(first);
-	bolt.push_back(third);
-
-	for(int i = 1; i < 10; i++)
-	{
-		randY = get_random(jitter);
-		randZ = get_random(jitter);
-
-		zero.position = first.position;
-		zero.texCoords = first.texCoords;
-	
-		first.position = start->position + glm::vec3(offset_x.at(i) * diff_x, randY, randZ);
-		first.texCoords = glm::vec2(0.0f, 0.0f);
-	
-		second.position = third.position;
-		second.texCoords = glm::vec2(0.0f, 1.0f);
-	
-		third.position = first.position + glm::vec3(0.0f, thickness, 0.0f);
-		third.texCoords = glm::vec2(0.0f, 1.0f);
-
-		bolt.push_back(zero);
-		bolt.push_back(first);
-		bolt.push_back(second);
-		bolt.push_back(second);
-		bolt.push_back(first);
-		bolt.push_back(third);
-	}
-	randY = get_random(jitter);
-	randZ = get_random(jitter);
-	
-	zero.position = first.position;
-	zero.texCoords = first.texCoords;
-	
-	first.position = end->position;
-	first.texCoords = glm::vec2(0.0f, 0.0f);
-	
-	second.position = third.position;
-	second.texCoords = glm::vec2(0.0f, 1.0f);
-	
-	third.position = first.position + glm::vec3(0.0f, thickness, 0.0f);
-	third.texCoords = glm::vec2(0.0f, 1.0f);
-
-	bolt.push_back(zero);
-	bolt.push_back(first);
-	bolt.push_back(second);
-	bolt.push_back(second);
-	bolt.push_back(first);
-	bolt.push_back(third);
-}
-
-void Power::draw(Shader* power_shader)
-{
-	// create 3 bolts
 	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-	for(int i = 0; i < 3; i++)
-	{
-		// create a bolt
-		if(i == 0)
-			create_bolt(i + 2);
-		else
-			create_bolt(i + 1);
-
-		// draw
-		glBufferSubData(GL_ARRAY_BUFFER, 0, bolt.size() * sizeof(BoltNode), bolt.data());
-		glDrawArrays(GL_TRIANGLES, 0, bolt.size());
-	}
-
+	glDrawArrays(GL_LINES, 0, 2);
 	glBindVertexArray(0);
 }
@@ -7,8 +7,22 @@
 #include "shader.hpp"
 #include "stb_image.hpp"
 
-Shader::Shader(const std::string & vertex_shader_file, const std::string & fragment_shader_file, const std::string & geometry_shader_file)
+struct ShaderCacheHeader
 {
+	unsigned int magic;
+	GLenum format;
+	unsigned long long source_hash;
+	unsigned long long driver_hash;
+	unsigned long long length;
+};
+
+Shader::Shader(const std::string & vertex_shader_file, const std::string & fragment_shader_file, const std::string & geometry_shader_file) :
+	files({vertex_shader_file, fragment_shader_file, geometry_shader_file}),
+	pending(0),
+	pending_hash(0)
+{
+	live().push_back(this);
+
 	int vShader_codeLength;
 	int fShader_codeLength;
 	int gShader_codeLength;
@@ -55,8 +69,13 @@ Shader::Shader(const std::string & vertex_shader_file, const std::string & fragm
 	if(!f_shader_stream)
 		std::cerr << "Error while trying to read the fragment shader file !" << std::endl;
 
-	// Now compile the shaders, create the shader program and link
-	compile(vShaderCode, fShaderCode, gShaderCode);
+	// Now compile the shaders, create the shader program and link, unless this driver already built it
+	unsigned long long source_hash = hash(fShaderCode, hash(gShaderCode, hash(vShaderCode)));
+	if(!load_binary(source_hash))
+	{
+		compile(vShaderCode, fShaderCode, gShaderCode);
+		save_binary(source_hash);
+	}
 
 	delete[](vShaderCode);
 	delete[](gShaderCode);
@@ -67,6 +86,52 @@ Shader::Shader(const std::string & vertex_shader_file, const std::string & fragm
 	f_shader_stream.close();
 }
 
+Shader::Shader(const std::string & compute_shader_file) :
+	files({compute_shader_file}),
+	pending(0),
+	pending_hash(0)
+{
+	live().push_back(this);
+
+	std::fstream c_shader_stream;
+	c_shader_stream.open(compute_shader_file, std::fstream::in);
+
+	c_shader_stream.seekg(0, c_shader_stream.end);
+	int cShader_codeLength = c_shader_stream.tellg();
+	c_shader_stream.seekg(0, c_shader_stream.beg);
+
+	char* cShaderCode = new char[cShader_codeLength+1];
+	cShaderCode[cShader_codeLength] = '\0';
+	c_shader_stream.read(cShaderCode, cShader_codeLength);
+
+	if(!c_shader_stream)
+		std::cerr << "Error while trying to read the compute shader file !" << std::endl;
+
+	unsigned long long source_hash = hash(cShaderCode);
+	if(!load_binary(source_hash))
+	{
+		compile_compute(cShaderCode);
+		save_binary(source_hash);
+	}
+
+	delete[](cShaderCode);
+	c_shader_stream.close();
+}
+
+Shader::~Shader()
+{
+	std::vector<Shader*> & shaders = live();
+	shaders.erase(std::remove(shaders.begin(), shaders.end(), this), shaders.end());
+
+	// a reload still compiling (the program itself is left to the context, as before)
+	if(pending != 0)
+	{
+		for(int i = 0; i < pending_stages.size(); i++)
+			glDeleteShader(pending_stages[i]);
+		glDeleteProgram(pending);
+	}
+}
+
 void Shader::compile(const char * vertex_shader_code, const char * fragment_shader_code, const char * geometry_shader_code)
 {
 	GLuint vertex_shader, fragment_shader, geometry_shader, shader_program;
@@ -126,6 +191,7 @@ void Shader::compile(const char * vertex_shader_code, const char * fragment_shad
 	glAttachShader(shader_program, vertex_shader);
 	glAttachShader(shader_program, geometry_shader);
 	glAttachShader(shader_program, fragment_shader);
+	glProgramParameteri(shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(shader_program);
 
 	glGetProgramiv(shader_program, GL_LINK_STATUS, &success);
@@ -147,6 +213,344 @@ void Shader::compile(const char * vertex_shader_code, const char * fragment_shad
 	id = shader_program;
 }
 
+void Shader::compile_compute(const char * compute_shader_code)
+{
+	GLuint compute_shader, shader_program;
+	compute_shader = glCreateShader(GL_COMPUTE_SHADER);
+	shader_program = glCreateProgram();
+
+	glShaderSource(compute_shader, 1, &compute_shader_code, nullptr);
+	glCompileShader(compute_shader);
+
+	// Check for errors
+	int success;
+	int logLength;
+	char* log;
+
+	glGetShaderiv(compute_shader, GL_COMPILE_STATUS, &success);
+	if(success == GL_FALSE)
+	{
+		glGetShaderiv(compute_shader, GL_INFO_LOG_LENGTH, &logLength);
+		log = new char[logLength];
+		glGetShaderInfoLog(compute_shader, logLength, nullptr, log);
+		std::cerr << "Error while compiling the compute shader : " << log << std::endl;
+		delete[](log);
+	}
+
+	glAttachShader(shader_program, compute_shader);
+	glProgramParameteri(shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(shader_program);
+
+	glGetProgramiv(shader_program, GL_LINK_STATUS, &success);
+	if(success == GL_FALSE)
+	{
+		glGetProgramiv(shader_program, GL_INFO_LOG_LENGTH, &logLength);
+		log = new char[logLength];
+		glGetProgramInfoLog(shader_program, logLength, nullptr, log);
+		std::cerr << "Error while linking the compute shader into a program : " << log << std::endl;
+		delete[](log);
+	}
+
+	glDetachShader(shader_program, compute_shader);
+	glDeleteShader(compute_shader);
+
+	id = shader_program;
+}
+
+unsigned long long Shader::hash(const char * text, unsigned long long seed)
+{
+	// FNV-1a, the terminating zero keeps the stage boundaries apart
+	unsigned long long h = seed;
+	do
+	{
+		h = (h ^ static_cast<unsigned char>(*text)) * 1099511628211ull;
+	} while(*text++ != '\0');
+	return h;
+}
+
+unsigned long long Shader::driver_hash()
+{
+	// binaries are only valid for the driver that produced them
+	static unsigned long long h = 0;
+	if(h == 0)
+	{
+		const GLubyte * strings[3] = {glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION)};
+		h = 14695981039346656037ull;
+		for(int i = 0; i < 3; i++)
+		{
+			if(strings[i] != nullptr)
+				h = hash(reinterpret_cast<const char*>(strings[i]), h);
+		}
+	}
+	return h;
+}
+
+std::string Shader::cache_path(unsigned long long source_hash)
+{
+	std::ostringstream path;
+	path << SHADER_CACHE_DIR << std::hex << std::setw(16) << std::setfill('0') << source_hash << ".bin";
+	return path.str();
+}
+
+bool Shader::load_binary(unsigned long long source_hash)
+{
+	std::ifstream file(cache_path(source_hash), std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		return false;
+	unsigned long long file_size = file.tellg();
+	file.seekg(0, file.beg);
+
+	ShaderCacheHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(ShaderCacheHeader));
+	if(!file || header.magic != SHADER_CACHE_MAGIC || header.source_hash != source_hash || header.driver_hash != driver_hash())
+		return false;
+
+	// a file cut short by a crash while saving is rebuilt from source, not trusted for its length
+	if(header.length == 0 || header.length != file_size - sizeof(ShaderCacheHeader) || header.length > std::numeric_limits<GLsizei>::max())
+		return false;
+
+	std::vector<char> binary(header.length);
+	file.read(binary.data(), header.length);
+	if(!file)
+		return false;
+
+	// the driver may still refuse it (different hardware behind the same strings), compile from source then
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, header.format, binary.data(), header.length);
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if(success == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		return false;
+	}
+
+	id = program;
+	return true;
+}
+
+void Shader::save_binary(unsigned long long source_hash) const
+{
+	int success;
+	int formats = 0;
+	glGetProgramiv(id, GL_LINK_STATUS, &success);
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if(success == GL_FALSE || formats == 0)
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+	std::vector<char> binary(length);
+	ShaderCacheHeader header;
+	glGetProgramBinary(id, length, nullptr, &header.format, binary.data());
+	header.magic = SHADER_CACHE_MAGIC;
+	header.source_hash = source_hash;
+	header.driver_hash = driver_hash();
+	header.length = length;
+
+	std::error_code ec;
+	std::filesystem::create_directories(SHADER_CACHE_DIR, ec);
+	std::ofstream file(cache_path(source_hash), std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		std::cerr << "Error: failed writing shader cache " << cache_path(source_hash) << std::endl;
+		return;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(ShaderCacheHeader));
+	file.write(binary.data(), length);
+}
+
+std::vector<Shader*> & Shader::live()
+{
+	static std::vector<Shader*> shaders;
+	return shaders;
+}
+
+const std::vector<Shader*> & Shader::get_live()
+{
+	return live();
+}
+
+bool Shader::uses_file(const std::string & path) const
+{
+	std::filesystem::path changed = std::filesystem::path(path).lexically_normal();
+	for(int i = 0; i < files.size(); i++)
+	{
+		if(std::filesystem::path(files[i]).lexically_normal() == changed)
+			return true;
+	}
+	return false;
+}
+
+bool Shader::read_source(const std::string & path, std::string & code)
+{
+	std::ifstream file(path, std::ios::in);
+	if(!file.is_open())
+		return false;
+	std::ostringstream content;
+	content << file.rdbuf();
+	code = content.str();
+	return !code.empty();
+}
+
+void Shader::begin_reload()
+{
+	// editors may truncate before writing, an empty or unreadable file is not ready yet and waits for the next event
+	std::vector<std::string> codes(files.size());
+	for(int i = 0; i < files.size(); i++)
+	{
+		if(!read_source(files[i], codes[i]))
+			return;
+	}
+
+	// a newer save replaces a build still in flight
+	if(pending != 0)
+	{
+		for(int i = 0; i < pending_stages.size(); i++)
+			glDeleteShader(pending_stages[i]);
+		glDeleteProgram(pending);
+		pending = 0;
+	}
+	pending_stages.clear();
+
+	const GLenum stages_3[] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER};
+	pending = glCreateProgram();
+	for(int i = 0; i < files.size(); i++)
+	{
+		const char * code = codes[i].c_str();
+		GLuint stage = glCreateShader(files.size() == 1 ? GL_COMPUTE_SHADER : stages_3[i]);
+		glShaderSource(stage, 1, &code, nullptr);
+		glCompileShader(stage);
+		glAttachShader(pending, stage);
+		pending_stages.push_back(stage);
+	}
+	// same hash chain as the constructors, so the next launch finds the saved binary
+	pending_hash = (files.size() == 1) ? hash(codes[0].c_str()) : hash(codes[1].c_str(), hash(codes[2].c_str(), hash(codes[0].c_str())));
+
+	// with parallel compilation these return at once, poll_reload waits for the driver
+	glProgramParameteri(pending, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(pending);
+}
+
+bool Shader::poll_reload(bool parallel)
+{
+	if(pending == 0)
+		return false;
+
+	if(parallel)
+	{
+		int done = GL_FALSE;
+		glGetProgramiv(pending, GL_COMPLETION_STATUS_KHR, &done);
+		if(done == GL_FALSE)
+			return false;
+	}
+
+	int success;
+	glGetProgramiv(pending, GL_LINK_STATUS, &success);
+	if(success == GL_TRUE)
+	{
+		copy_uniforms(id, pending);
+		glDeleteProgram(id);
+		id = pending;
+		reload_error.clear();
+		save_binary(pending_hash);
+	}
+	else
+	{
+		// keep drawing with the old program, the logs go to the overlay
+		reload_error.clear();
+		for(int i = 0; i < pending_stages.size(); i++)
+		{
+			glGetShaderiv(pending_stages[i], GL_COMPILE_STATUS, &success);
+			if(success == GL_TRUE)
+				continue;
+			int logLength = 0;
+			glGetShaderiv(pending_stages[i], GL_INFO_LOG_LENGTH, &logLength);
+			std::string log(std::max(logLength, 1), '\0');
+			glGetShaderInfoLog(pending_stages[i], logLength, nullptr, &log[0]);
+			reload_error += files[i] + ":\n" + log.c_str();
+		}
+		if(reload_error.empty())
+		{
+			int logLength = 0;
+			glGetProgramiv(pending, GL_INFO_LOG_LENGTH, &logLength);
+			std::string log(std::max(logLength, 1), '\0');
+			glGetProgramInfoLog(pending, logLength, nullptr, &log[0]);
+			reload_error = files[0] + " (link):\n" + log.c_str();
+		}
+		std::cerr << "Error while reloading a shader : " << reload_error << std::endl;
+		glDeleteProgram(pending);
+	}
+
+	for(int i = 0; i < pending_stages.size(); i++)
+	{
+		glDeleteShader(pending_stages[i]);
+	}
+	pending_stages.clear();
+	pending = 0;
+	return true;
+}
+
+const std::string & Shader::get_reload_error() const
+{
+	return reload_error;
+}
+
+void Shader::copy_uniforms(GLuint from, GLuint to) const
+{
+	// values set once at load (sampler units, constants) would reset with the new program
+	GLint count = 0;
+	glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count);
+	for(int i = 0; i < count; i++)
+	{
+		char name[256];
+		GLint size = 0;
+		GLenum type;
+		glGetActiveUniform(from, i, sizeof(name), nullptr, &size, &type, name);
+
+		// arrays are reported as name[0], copy every element
+		std::string base(name);
+		if(base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+			base.resize(base.size() - 3);
+		for(int e = 0; e < size; e++)
+		{
+			std::string element = (size > 1) ? base + "[" + std::to_string(e) + "]" : std::string(name);
+			GLint src = glGetUniformLocation(from, element.c_str());
+			GLint dst = glGetUniformLocation(to, element.c_str());
+			if(src == -1 || dst == -1)
+				continue;
+
+			GLfloat f[16];
+			GLint n[4];
+			switch(type)
+			{
+				case GL_FLOAT: glGetUniformfv(from, src, f); glProgramUniform1fv(to, dst, 1, f); break;
+				case GL_FLOAT_VEC2: glGetUniformfv(from, src, f); glProgramUniform2fv(to, dst, 1, f); break;
+				case GL_FLOAT_VEC3: glGetUniformfv(from, src, f); glProgramUniform3fv(to, dst, 1, f); break;
+				case GL_FLOAT_VEC4: glGetUniformfv(from, src, f); glProgramUniform4fv(to, dst, 1, f); break;
+				case GL_FLOAT_MAT3: glGetUniformfv(from, src, f); glProgramUniformMatrix3fv(to, dst, 1, GL_FALSE, f); break;
+				case GL_FLOAT_MAT4: glGetUniformfv(from, src, f); glProgramUniformMatrix4fv(to, dst, 1, GL_FALSE, f); break;
+				case GL_INT_VEC2: glGetUniformiv(from, src, n); glProgramUniform2iv(to, dst, 1, n); break;
+				case GL_INT_VEC3: glGetUniformiv(from, src, n); glProgramUniform3iv(to, dst, 1, n); break;
+				case GL_INT_VEC4: glGetUniformiv(from, src, n); glProgramUniform4iv(to, dst, 1, n); break;
+				case GL_INT:
+				case GL_BOOL:
+				case GL_SAMPLER_2D:
+				case GL_SAMPLER_2D_SHADOW:
+				case GL_SAMPLER_2D_ARRAY:
+				case GL_SAMPLER_3D:
+				case GL_SAMPLER_CUBE:
+				case GL_IMAGE_2D:
+					glGetUniformiv(from, src, n);
+					glProgramUniform1iv(to, dst, 1, n);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
 GLuint Shader::get_id() const { return id; }
 
 void Shader::set_int(const std::string & name, int v) const
@@ -169,6 +573,13 @@ void Shader::set_Matrix(const std::string & name, glm::mat4 m) const
 	glUniformMatrix4fv(glGetUniformLocation(id, name.c_str()), 1, GL_FALSE, glm::value_ptr(m));
 }
 
+void Shader::bind_uniform_block(const std::string & name, GLuint binding) const
+{
+	GLuint index = glGetUniformBlockIndex(id, name.c_str());
+	if(index != GL_INVALID_INDEX)
+		glUniformBlockBinding(id, index, binding);
+}
+
 void Shader::use() const { glUseProgram(id);}
 
 void Shader::set_texture(const std::string & texture_path, int tex_unit, const std::string & uniform_name, bool flip)
@@ -0,0 +1,298 @@
+/**
+ * \file
+ * Tweak the engine glow without leaving the cockpit.
+ * \author Mathias Velo
+ */
+
+#include "shader_reload.hpp"
+
+// 3x5 glyphs from ' ' to '`' then '{' to '~', row r in bits 3r to 3r+2, left column in the low bit
+static const unsigned short overlay_font[] =
+{
+	0x0000, 0x2092, 0x002D, 0x5F7D, 0x3C9E, 0x52A5, 0x6AAA, 0x0012, //   ! " # $ % & '
+	0x4494, 0x1491, 0x0AA8, 0x05D0, 0x1400, 0x01C0, 0x2000, 0x12A4, // ( ) * + , - . /
+	0x7B6F, 0x749A, 0x73E7, 0x79A7, 0x49ED, 0x79CF, 0x7BCF, 0x2527, // 0 1 2 3 4 5 6 7
+	0x7BEF, 0x79EF, 0x0410, 0x1410, 0x4454, 0x0E38, 0x1511, 0x21A7, // 8 9 : ; < = > ?
+	0x73EF, 0x5BEA, 0x3AEB, 0x624E, 0x3B6B, 0x72CF, 0x12CF, 0x6B4E, // @ A B C D E F G
+	0x5BED, 0x7497, 0x2B24, 0x5AED, 0x7249, 0x5BFD, 0x5B6B, 0x2B6A, // H I J K L M N O
+	0x12EB, 0x676A, 0x5AEB, 0x388E, 0x2497, 0x7B6D, 0x2B6D, 0x5FED, // P Q R S T U V W
+	0x5AAD, 0x24AD, 0x72A7, 0x6496, 0x4889, 0x3493, 0x002A, 0x7000, // X Y Z [ \ ] ^ _
+	0x0011, 0x6456, 0x2492, 0x3513, 0x03E0 // ` { | } ~
+};
+
+static unsigned short overlay_glyph(char c)
+{
+	if(c >= 'a' && c <= 'z')
+		c = c - 'a' + 'A';
+	if(c >= ' ' && c <= '`')
+		return overlay_font[c - ' '];
+	if(c >= '{' && c <= '~')
+		return overlay_font[c - '{' + ('`' - ' ' + 1)];
+	return overlay_font['?' - ' '];
+}
+
+ShaderReloader::ShaderReloader() :
+	fd(-1),
+	parallel(false),
+	VAO(0),
+	VBO(0),
+	texture(0),
+	columns(0),
+	dirty(false),
+	last_width(0),
+	last_height(0)
+{
+	// watch every shader folder, editors either rewrite the file or move a temporary over it
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(fd == -1)
+	{
+		std::cerr << "Error: cannot watch the shader folders, hot reload is disabled." << std::endl;
+	}
+	else
+	{
+		std::vector<std::string> folders;
+		folders.push_back(SHADER_RELOAD_DIR);
+		std::error_code error;
+		for(const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator(SHADER_RELOAD_DIR, error))
+		{
+			if(entry.is_directory())
+				folders.push_back(entry.path().string() + "/");
+		}
+		for(int i = 0; i < folders.size(); i++)
+		{
+			int wd = inotify_add_watch(fd, folders[i].c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if(wd == -1)
+				std::cerr << "Error: cannot watch " << folders[i] << std::endl;
+			else
+				watched[wd] = folders[i];
+		}
+	}
+
+	// let the driver build on its own threads, otherwise the swap waits for the build
+	if(GLEW_KHR_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		parallel = true;
+	}
+	else if(GLEW_ARB_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+		parallel = true;
+	}
+	std::cout << "SHADER HOT RELOAD: watching " << watched.size() << " folders, " << (parallel ? "parallel" : "blocking") << " compilation" << std::endl;
+
+	overlay_shader = new Shader("../shaders/overlay/vertex.glsl", "../shaders/overlay/fragment.glsl", "../shaders/overlay/geometry.glsl");
+	overlay_shader->use();
+	overlay_shader->set_int("img", 0);
+
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, 30 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+
+	glBindVertexArray(0);
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+ShaderReloader::~ShaderReloader()
+{
+	if(fd != -1)
+		close(fd);
+	delete(overlay_shader);
+	glDeleteTextures(1, &texture);
+	glDeleteBuffers(1, &VBO);
+	glDeleteVertexArrays(1, &VAO);
+}
+
+void ShaderReloader::read_events(std::set<std::string> & changed)
+{
+	alignas(struct inotify_event) char buffer[4096];
+	while(true)
+	{
+		ssize_t length = read(fd, buffer, sizeof(buffer));
+		if(length <= 0)
+			break;
+
+		for(char* p = buffer; p < buffer + length; p += sizeof(struct inotify_event) + reinterpret_cast<struct inotify_event*>(p)->len)
+		{
+			struct inotify_event* event = reinterpret_cast<struct inotify_event*>(p);
+			std::map<int, std::string>::iterator folder = watched.find(event->wd);
+			if(event->len > 0 && folder != watched.end())
+				changed.insert(folder->second + event->name);
+		}
+	}
+}
+
+void ShaderReloader::poll()
+{
+	// start a build for every program using a saved file
+	if(fd != -1)
+	{
+		std::set<std::string> changed;
+		read_events(changed);
+
+		const std::vector<Shader*> & shaders = Shader::get_live();
+		for(int i = 0; i < shaders.size(); i++)
+		{
+			for(std::set<std::string>::iterator file = changed.begin(); file != changed.end(); file++)
+			{
+				if(shaders[i]->uses_file(*file))
+				{
+					shaders[i]->begin_reload();
+					break;
+				}
+			}
+		}
+	}
+
+	// swap in the finished ones, this runs right after the buffer swap so a frame never mixes programs
+	const std::vector<Shader*> & shaders = Shader::get_live();
+	for(int i = 0; i < shaders.size(); i++)
+	{
+		if(shaders[i]->poll_reload(parallel))
+		{
+			if(shaders[i]->get_reload_error().empty())
+				std::cout << "SHADER HOT RELOAD: program " << shaders[i]->get_id() << " rebuilt" << std::endl;
+			dirty = true;
+		}
+	}
+
+	if(dirty)
+		build_text();
+}
+
+void ShaderReloader::build_text()
+{
+	lines.clear();
+	columns = 0;
+
+	const std::vector<Shader*> & shaders = Shader::get_live();
+	for(int i = 0; i < shaders.size(); i++)
+	{
+		std::istringstream error(shaders[i]->get_reload_error());
+		std::string line;
+		while(std::getline(error, line) && lines.size() < OVERLAY_MAX_LINES)
+		{
+			std::replace(line.begin(), line.end(), '\t', ' ');
+			if(line.size() > OVERLAY_MAX_COLUMNS)
+				line.resize(OVERLAY_MAX_COLUMNS);
+			lines.push_back(line);
+			columns = std::max(columns, static_cast<int>(line.size()));
+		}
+	}
+}
+
+void ShaderReloader::upload_text()
+{
+	// one texel row of glyphs per text line, red = ink
+	int tex_width = std::max(columns, 1) * OVERLAY_GLYPH_WIDTH + 1;
+	int tex_height = lines.size() * OVERLAY_GLYPH_HEIGHT + 1;
+	std::vector<unsigned char> texels(tex_width * tex_height, 0);
+	for(int l = 0; l < lines.size(); l++)
+	{
+		for(int c = 0; c < lines[l].size(); c++)
+		{
+			unsigned short glyph = overlay_glyph(lines[l][c]);
+			for(int r = 0; r < 5; r++)
+			{
+				for(int k = 0; k < 3; k++)
+				{
+					if(glyph & (1 << (r * 3 + k)))
+						texels[(l * OVERLAY_GLYPH_HEIGHT + r + 1) * tex_width + c * OVERLAY_GLYPH_WIDTH + k + 1] = 255;
+				}
+			}
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, tex_width, tex_height, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	last_width = 0; // quad size follows the texture
+	dirty = false;
+}
+
+void ShaderReloader::draw_overlay(int width, int height)
+{
+	if(dirty)
+		upload_text();
+	if(lines.empty())
+		return;
+
+	// top left quad, pixel sized from the text texture
+	if(width != last_width || height != last_height)
+	{
+		float tex_width = std::max(columns, 1) * OVERLAY_GLYPH_WIDTH + 1;
+		float tex_height = lines.size() * OVERLAY_GLYPH_HEIGHT + 1;
+		float x0 = -1.0f + 2.0f * OVERLAY_MARGIN / width;
+		float y0 = 1.0f - 2.0f * OVERLAY_MARGIN / height;
+		float x1 = x0 + 2.0f * tex_width * OVERLAY_SCALE / width;
+		float y1 = y0 - 2.0f * tex_height * OVERLAY_SCALE / height;
+		float quad[] = {
+			x0, y0, 0.0f, 0.0f, 0.0f,
+			x0, y1, 0.0f, 0.0f, 1.0f,
+			x1, y0, 0.0f, 1.0f, 0.0f,
+			x1, y0, 0.0f, 1.0f, 0.0f,
+			x0, y1, 0.0f, 0.0f, 1.0f,
+			x1, y1, 0.0f, 1.0f, 1.0f
+		};
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(quad), quad);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		last_width = width;
+		last_height = height;
+	}
+
+	// drawn over whatever the page left bound, restore what it relies on
+	GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+	GLboolean blend = glIsEnabled(GL_BLEND);
+	GLint blend_func[4];
+	glGetIntegerv(GL_BLEND_SRC_RGB, &blend_func[0]);
+	glGetIntegerv(GL_BLEND_DST_RGB, &blend_func[1]);
+	glGetIntegerv(GL_BLEND_SRC_ALPHA, &blend_func[2]);
+	glGetIntegerv(GL_BLEND_DST_ALPHA, &blend_func[3]);
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, width, height);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	overlay_shader->use();
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glBindVertexArray(VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+	glBindVertexArray(0);
+
+	glBlendFuncSeparate(blend_func[0], blend_func[1], blend_func[2], blend_func[3]);
+	if(!blend)
+		glDisable(GL_BLEND);
+	if(depth_test)
+		glEnable(GL_DEPTH_TEST);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+bool ShaderReloader::is_parallel() const
+{
+	return parallel;
+}
@@ -0,0 +1,197 @@
+/**
+ * \file
+ * Two vertices walk into an edge, one walks out
+ * \author Mathias Velo
+ */
+
+#include "simplifier.hpp"
+
+struct Collapse
+{
+	int from;
+	int to;
+	double cost;
+};
+
+void QuadricSimplifier::add_plane(Quadric & q, glm::dvec3 n, double d, double w)
+{
+	q.a[0] += w * n.x * n.x; q.a[1] += w * n.x * n.y; q.a[2] += w * n.x * n.z; q.a[3] += w * n.x * d;
+	q.a[4] += w * n.y * n.y; q.a[5] += w * n.y * n.z; q.a[6] += w * n.y * d;
+	q.a[7] += w * n.z * n.z; q.a[8] += w * n.z * d;
+	q.a[9] += w * d * d;
+}
+
+double QuadricSimplifier::evaluate(const Quadric & q, glm::vec3 p)
+{
+	double x = p.x, y = p.y, z = p.z;
+	return q.a[0] * x * x + 2.0 * q.a[1] * x * y + 2.0 * q.a[2] * x * z + 2.0 * q.a[3] * x
+		+ q.a[4] * y * y + 2.0 * q.a[5] * y * z + 2.0 * q.a[6] * y
+		+ q.a[7] * z * z + 2.0 * q.a[8] * z
+		+ q.a[9];
+}
+
+bool QuadricSimplifier::flips(int v, glm::vec3 target, int other, const std::vector<glm::vec3> & positions, const std::vector<int> & tris, const std::vector<int> & adj_offset, const std::vector<int> & adj)
+{
+	for(int k = adj_offset[v]; k < adj_offset[v + 1]; k++)
+	{
+		int t = adj[k] * 3;
+		int a = tris[t], b = tris[t + 1], c = tris[t + 2];
+
+		// triangles sharing the collapsed edge disappear
+		if(a == other || b == other || c == other)
+			continue;
+
+		glm::vec3 pa = positions[a], pb = positions[b], pc = positions[c];
+		glm::vec3 n_before = glm::cross(pb - pa, pc - pa);
+		if(a == v) pa = target;
+		if(b == v) pb = target;
+		if(c == v) pc = target;
+		glm::vec3 n_after = glm::cross(pb - pa, pc - pa);
+
+		if(glm::dot(n_before, n_after) <= 0.0f)
+			return true;
+	}
+	return false;
+}
+
+int QuadricSimplifier::collapse_pass(const std::vector<glm::vec3> & positions, const std::vector<int> & position_id, const std::vector<bool> & locked, std::vector<int> & tris, int target, double max_cost, double & pass_cost)
+{
+	int nb_vertices = positions.size();
+	int nb_tris = tris.size() / 3;
+
+	// per-vertex quadrics, edges in vertex space, edge use count in position space (seams are not borders)
+	std::vector<Quadric> quadrics(nb_vertices);
+	for(int i = 0; i < nb_vertices; i++)
+		std::fill(quadrics[i].a, quadrics[i].a + 10, 0.0);
+
+	std::unordered_map<unsigned long long, int> edges;
+	std::unordered_map<unsigned long long, int> position_edges;
+	std::vector<glm::dvec3> tri_normals(nb_tris);
+	for(int t = 0; t < nb_tris; t++)
+	{
+		int v[3] = {tris[t * 3], tris[t * 3 + 1], tris[t * 3 + 2]};
+		glm::dvec3 p0(positions[v[0]]), p1(positions[v[1]]), p2(positions[v[2]]);
+		glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+		double len = glm::length(n);
+		tri_normals[t] = (len > 0.0) ? n / len : glm::dvec3(0.0);
+		if(len > 0.0)
+		{
+			double d = -glm::dot(tri_normals[t], p0);
+			for(int j = 0; j < 3; j++)
+				add_plane(quadrics[v[j]], tri_normals[t], d, 1.0);
+		}
+		for(int j = 0; j < 3; j++)
+		{
+			unsigned long long a = std::min(v[j], v[(j + 1) % 3]);
+			unsigned long long b = std::max(v[j], v[(j + 1) % 3]);
+			edges[(a << 32) | b]++;
+			unsigned long long pa = std::min(position_id[v[j]], position_id[v[(j + 1) % 3]]);
+			unsigned long long pb = std::max(position_id[v[j]], position_id[v[(j + 1) % 3]]);
+			position_edges[(pa << 32) | pb]++;
+		}
+	}
+
+	// keep open borders in place with perpendicular planes
+	for(int t = 0; t < nb_tris; t++)
+	{
+		for(int j = 0; j < 3; j++)
+		{
+			int a = tris[t * 3 + j];
+			int b = tris[t * 3 + (j + 1) % 3];
+			unsigned long long key = (static_cast<unsigned long long>(std::min(position_id[a], position_id[b])) << 32) | std::max(position_id[a], position_id[b]);
+			if(position_edges[key] != 1)
+				continue;
+			glm::dvec3 pa(positions[a]), pb(positions[b]);
+			glm::dvec3 n = glm::cross(pb - pa, tri_normals[t]);
+			double len = glm::length(n);
+			if(len == 0.0)
+				continue;
+			n /= len;
+			double d = -glm::dot(n, pa);
+			add_plane(quadrics[a], n, d, SIMPLIFIER_BORDER_WEIGHT);
+			add_plane(quadrics[b], n, d, SIMPLIFIER_BORDER_WEIGHT);
+		}
+	}
+
+	// collapse candidates, only onto an existing vertex so callers keep indexing their own buffer (no 4x4 solve needed)
+	std::vector<Collapse> collapses;
+	for(auto it = edges.begin(); it != edges.end(); ++it)
+	{
+		int a = static_cast<int>(it->first >> 32);
+		int b = static_cast<int>(it->first & 0xffffffffull);
+		if(locked[a] && locked[b])
+			continue;
+		Quadric q;
+		for(int k = 0; k < 10; k++)
+			q.a[k] = quadrics[a].a[k] + quadrics[b].a[k];
+		double cost_ab = locked[a] ? DBL_MAX : evaluate(q, positions[b]);
+		double cost_ba = locked[b] ? DBL_MAX : evaluate(q, positions[a]);
+		Collapse c;
+		if(cost_ab <= cost_ba) { c.from = a; c.to = b; c.cost = cost_ab; }
+		else { c.from = b; c.to = a; c.cost = cost_ba; }
+		if(c.cost <= max_cost)
+			collapses.push_back(c);
+	}
+	std::sort(collapses.begin(), collapses.end(), [](const Collapse & x, const Collapse & y) { return x.cost < y.cost; });
+
+	// vertex -> triangles adjacency
+	std::vector<int> adj_offset(nb_vertices + 1, 0);
+	std::vector<int> adj(tris.size());
+	for(int i = 0; i < tris.size(); i++)
+		adj_offset[tris[i] + 1]++;
+	for(int i = 0; i < nb_vertices; i++)
+		adj_offset[i + 1] += adj_offset[i];
+	std::vector<int> fill(adj_offset.begin(), adj_offset.end() - 1);
+	for(int i = 0; i < tris.size(); i++)
+		adj[fill[tris[i]]++] = i / 3;
+
+	// greedy collapses until the target, a vertex ring is locked once touched during this pass
+	std::vector<int> remap(nb_vertices);
+	std::vector<bool> touched(nb_vertices, false);
+	for(int i = 0; i < nb_vertices; i++)
+		remap[i] = i;
+
+	int collapsed = 0;
+	int removed = 0;
+	pass_cost = 0.0;
+	for(int i = 0; i < collapses.size() && nb_tris - removed > target; i++)
+	{
+		const Collapse & c = collapses[i];
+		if(touched[c.from] || touched[c.to])
+			continue;
+		if(flips(c.from, positions[c.to], c.to, positions, tris, adj_offset, adj))
+			continue;
+
+		remap[c.from] = c.to;
+		for(int k = adj_offset[c.from]; k < adj_offset[c.from + 1]; k++)
+		{
+			int t = adj[k] * 3;
+			if(tris[t] == c.to || tris[t + 1] == c.to || tris[t + 2] == c.to)
+				removed++;
+			touched[tris[t]] = true;
+			touched[tris[t + 1]] = true;
+			touched[tris[t + 2]] = true;
+		}
+		touched[c.to] = true;
+		pass_cost = std::max(pass_cost, c.cost);
+		collapsed++;
+	}
+
+	// apply collapses and drop degenerate triangles
+	std::vector<int> result;
+	result.reserve(tris.size());
+	for(int i = 0; i < tris.size(); i += 3)
+	{
+		int a = remap[tris[i]];
+		int b = remap[tris[i + 1]];
+		int c = remap[tris[i + 2]];
+		if(a == b || b == c || a == c)
+			continue;
+		result.push_back(a);
+		result.push_back(b);
+		result.push_back(c);
+	}
+	tris.swap(result);
+
+	return collapsed;
+}
@@ -12,12 +12,13 @@
 #include "smoke.hpp"
 
 Smoke::Smoke(std::vector<glm::vec3> sources, glm::vec3 sources_dir) :
+	first(0),
+	count(0),
+	emission(0.0f),
+	seed(0),
 	velocity(0.00125f),
-	dissolve(0.5f),
-	jitter(0.05f),
-	dis(0.0f, 0.25f)
+	dissolve(0.5f)
 {
-	gen.seed(rd());
 	// smoke sources
 	if(sources.size() == 3)
 	{
@@ -29,25 +30,27 @@ Smoke::Smoke(std::vector<glm::vec3> sources, glm::vec3 sources_dir) :
 	{
 		std::cerr << "Error, invalid smoke sources count !" << std::endl;
 	}
+	direction = sources_dir;
 
-	particles.push_back(Particle(s1, sources_dir));
-	particles.push_back(Particle(s2, sources_dir));
-	particles.push_back(Particle(s3, sources_dir));
-
-	// smoke attributes
-	jitter = 0.05f;
+	// every particle starts dead
+	std::vector<GpuParticle> particles(MAX_PARTICLES);
+	for(int i = 0; i < MAX_PARTICLES; i++)
+	{
+		particles[i].position = glm::vec4(s1, dissolve + 1.0f);
+		particles[i].direction = glm::vec4(sources_dir, 0.0f);
+	}
 
-	// smoke particles in VAO
+	// smoke particles in VAO, the same buffer is the compute pass storage buffer
 	glGenVertexArrays(1, &VAO);
 	glBindVertexArray(VAO);
 
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
-	glBufferData(GL_ARRAY_BUFFER, MAX_PARTICLES * sizeof(Particle), particles.data(), GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)0);
-	glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)(offsetof(Particle, lifeTime)));
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)(offsetof(Particle, direction)));
+	glBufferData(GL_ARRAY_BUFFER, MAX_PARTICLES * sizeof(GpuParticle), particles.data(), GL_DYNAMIC_COPY);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)0);
+	glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)(offsetof(GpuParticle, direction)));
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
@@ -57,57 +60,60 @@ Smoke::Smoke(std::vector<glm::vec3> sources, glm::vec3 sources_dir) :
 	glBindVertexArray(0);
 }
 
+Smoke::~Smoke()
+{
+	glDeleteBuffers(1, &VBO);
+	glDeleteVertexArrays(1, &VAO);
+}
+
 void Smoke::set_init_dir(glm::vec3 dir)
 {
 	direction = dir;
 }
 
-void Smoke::draw(double delta, Shader* smoke_shader)
+void Smoke::update(double delta, Shader* compute_shader)
 {
-	// draw particles
-	glBindVertexArray(VAO);
-	int count = particles.size();
-	for(int p = count; p > 3; p -= 3)
-	{
-		glDrawArrays(GL_POINTS, p - 3, 3);
-	}
-
-	// update particles array
-	int particles_count = particles.size();
-	auto it = particles.begin();
-
-	float fps = static_cast<float>(1.0/delta);
-	float ratio = 60.0f / fps;
-	float scale_lifeTime = fps / 60.0f;
-
-	for(int i = 0; i < particles.size(); i++)
-	{
-		Particle& p = particles.at(i);
-		float updated_lifeTime = p.lifeTime + (static_cast<float>(delta) * scale_lifeTime);
-		if(updated_lifeTime >= dissolve)
-		{
-			particles.erase(it + i);
-		}
-		else
-		{
-			p.lifeTime = updated_lifeTime;
-			p.position += velocity * ratio * p.direction;
-			float jitter_x = dis(gen);
-			float jitter_y = dis(gen);
-			float jitter_z = dis(gen);
-			p.position += glm::vec3(jitter_x * p.direction.x, jitter_y * p.direction.y, jitter_z * p.direction.z);
-		}
-	}
+	// emission is time based, three particles (one per source) per tick
+	float dt = static_cast<float>(delta);
+	emission += dt * SMOKE_EMISSION_RATE;
+	int emit_count = 3 * static_cast<int>(emission);
+	emission -= static_cast<int>(emission);
+	emit_count = std::min(emit_count, MAX_PARTICLES);
+
+	// nothing older than dissolve seconds is alive, the window stops growing there
+	int live = static_cast<int>(std::ceil(dissolve * SMOKE_EMISSION_RATE)) * 3 + emit_count;
+	first = (first + MAX_PARTICLES - emit_count) % MAX_PARTICLES;
+	count = std::min(count + emit_count, std::min(live, MAX_PARTICLES));
+	seed++;
+
+	compute_shader->use();
+	compute_shader->set_int("capacity", MAX_PARTICLES);
+	compute_shader->set_int("emitStart", first);
+	compute_shader->set_int("emitCount", emit_count);
+	compute_shader->set_int("liveCount", count);
+	compute_shader->set_int("seed", seed);
+	compute_shader->set_float("delta", dt);
+	compute_shader->set_float("velocity", velocity);
+	compute_shader->set_float("dissolve", dissolve);
+	compute_shader->set_vec3f("s1", s1);
+	compute_shader->set_vec3f("s2", s2);
+	compute_shader->set_vec3f("s3", s3);
+	compute_shader->set_vec3f("direction", direction);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, VBO);
+	glDispatchCompute((count + SMOKE_WORK_GROUP_SIZE - 1) / SMOKE_WORK_GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
 
-	particles.push_back(Particle(s1, direction));
-	particles.push_back(Particle(s2, direction));
-	particles.push_back(Particle(s3, direction));
-	
-	// update smoke's VBO
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, particles.size() * sizeof(Particle), particles.data());
+void Smoke::render(Shader* smoke_shader)
+{
+	// the live window is one or two contiguous ranges of the ring, newest first
+	// the few dead ones at its end are dropped by the geometry shader
+	GLint starts[2] = {first, 0};
+	GLsizei counts[2] = {std::min(count, MAX_PARTICLES - first), 0};
+	counts[1] = count - counts[0];
 
-	// unbind VAO
+	glBindVertexArray(VAO);
+	glMultiDrawArrays(GL_POINTS, starts, counts, (counts[1] > 0) ? 2 : 1);
 	glBindVertexArray(0);
 }
-